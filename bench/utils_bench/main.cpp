@@ -0,0 +1,268 @@
+#include <SFML/Graphics.hpp>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "collisions.h"
+#include "fast_random.h"
+#include "filter_bank.h"
+#include "microbench.h"
+#include "pvector.h"
+#include "utils.h"
+#include "vec2.h"
+#include "../../src/011-raycast-sensors/raycaster.h"
+#include "../../src/015-geometric-sensor-testing/sensor.h"
+
+/***
+ * Timings for the functions in libs/utils that sit in the inner loops of the
+ * examples, at a few sizes each, so that a change that slows one down is noticed.
+ *
+ *   utils_bench                                  time everything and print a table
+ *   utils_bench --json results.json              ... and save the results
+ *   utils_bench --baseline baseline.json         ... and compare with saved results, exit 1 if anything got slower
+ *   utils_bench --filter castRay                 only the benchmarks with this in the name
+ *   utils_bench --quick                          fewer, shorter samples for a rough idea
+ *   utils_bench --tolerance 0.05                 how much slower counts as slower. The default is 10%
+ *
+ * The size is the number of items in each batch: rectangle pairs, vectors, rays and
+ * so on. For getColorAtPixel and castRay it is the width of the square image, which
+ * changes how well it fits in the cache. For Sensor::update it is the number of walls
+ * and for the filter banks the number of channels.
+ *
+ * A baseline only means something on the machine and build that made it. Save one
+ * from a Release build before starting work:
+ *
+ *   utils_bench --json bench/utils_bench/baseline.json
+ *
+ * then rerun with --baseline after each change. See microbench.h for how the timing is done.
+ */
+
+const int BATCH_SIZES[] = {16, 256, 4096};
+const int IMAGE_SIZES[] = {64, 512, 2048};
+const int WALL_COUNTS[] = {8, 32, 128, 512};
+const int CHANNEL_COUNTS[] = {16, 256, 4096};
+const float ARENA = 1000.0f;  // inputs are scattered over a square this big
+
+Xoshiro128 rng(12345);
+
+sf::RectangleShape random_rect(float width, float height) {
+  sf::RectangleShape rect(sf::Vector2f(width, height));
+  rect.setOrigin(width / 2, height / 2);
+  rect.setPosition(rng.uniform(0, ARENA), rng.uniform(0, ARENA));
+  rect.setRotation(rng.uniform(0, 360));
+  return rect;
+}
+
+/// the two kinds of rectangle test, with about as many near misses as hits
+void bench_collisions(bench::Runner& runner) {
+  for (int n : BATCH_SIZES) {
+    std::vector<sf::RectangleShape> rects;
+    for (int i = 0; i < n; i++) {
+      rects.push_back(random_rect(rng.uniform(20, 120), rng.uniform(20, 120)));
+    }
+    /// move every other one on top of its neighbour so that the tests do not all stop at the first axis
+    for (int i = 1; i < n; i += 2) {
+      rects[i].setPosition(rects[i - 1].getPosition() + sf::Vector2f(rng.uniform(-80, 80), rng.uniform(-80, 80)));
+    }
+    runner.run("rectangles_overlap", n, [&] {
+      int hits = 0;
+      for (int i = 0; i < n; i++) {
+        hits += Collisions::rectangles_overlap(rects[i], rects[(i + 1) % n]);
+      }
+      bench::do_not_optimize(hits);
+    });
+
+    std::vector<sf::CircleShape> circles;
+    for (int i = 0; i < n; i++) {
+      sf::CircleShape circle(rng.uniform(5, 40));
+      circle.setPosition(rects[i].getPosition() + sf::Vector2f(rng.uniform(-90, 90), rng.uniform(-90, 90)));
+      circles.push_back(circle);
+    }
+    runner.run("circle_hits_rotated_rect", n, [&] {
+      int hits = 0;
+      for (int i = 0; i < n; i++) {
+        hits += Collisions::circle_hits_rotated_rect(circles[i], rects[i]);
+      }
+      bench::do_not_optimize(hits);
+    });
+  }
+}
+
+void bench_vectors(bench::Runner& runner) {
+  for (int n : BATCH_SIZES) {
+    std::vector<Vec2> points(3 * n);
+    for (Vec2& p : points) {
+      p = {rng.uniform(0, ARENA), rng.uniform(0, ARENA)};
+    }
+    runner.run("minimum_distance", n, [&] {
+      float sum = 0;
+      for (int i = 0; i < n; i++) {
+        sum += minimum_distance(points[3 * i], points[3 * i + 1], points[3 * i + 2]);
+      }
+      bench::do_not_optimize(sum);
+    });
+
+    /// half of them longer than the limit
+    std::vector<PVector> vectors;
+    for (int i = 0; i < n; i++) {
+      Angle direction = Angle::from_turns(rng.uniform());
+      float length = rng.uniform(0, 10);
+      vectors.emplace_back(direction.cos() * length, direction.sin() * length);
+    }
+    runner.run("PVector::limit", n, [&] {
+      float sum = 0;
+      for (const PVector& v : vectors) {
+        PVector w = v;
+        sum += w.limit(5).x;
+      }
+      bench::do_not_optimize(sum);
+    });
+    runner.run("PVector::normalize", n, [&] {
+      float sum = 0;
+      for (const PVector& v : vectors) {
+        PVector w = v;
+        sum += w.normalize().x;
+      }
+      bench::do_not_optimize(sum);
+    });
+  }
+}
+
+/// an empty image with red walls on a 32 pixel grid, like the maps in 011 and 012
+sf::Image grid_image(int size) {
+  sf::Image image;
+  image.create(size, size, sf::Color::Black);
+  for (int y = 0; y < size; y++) {
+    for (int x = 0; x < size; x++) {
+      if (x % 32 < 2 || y % 32 < 2) {
+        image.setPixel(x, y, sf::Color::Red);
+      }
+    }
+  }
+  return image;
+}
+
+void bench_images(bench::Runner& runner) {
+  const int lookups = 4096;
+  const int rays = 256;
+  for (int size : IMAGE_SIZES) {
+    sf::Image image = grid_image(size);
+    std::vector<sf::Vector2f> points(std::max(lookups, rays));
+    std::vector<float> angles(rays);
+    for (auto& p : points) {
+      /// a few just outside the image to take the other branch
+      p = {rng.uniform(-8, float(size) + 8), rng.uniform(-8, float(size) + 8)};
+    }
+    for (float& a : angles) {
+      a = rng.uniform(0, 360);
+    }
+    runner.run("getColorAtPixel", size, [&] {
+      uint32_t sum = 0;
+      for (int i = 0; i < lookups; i++) {
+        sum += getColorAtPixel(image, points[i]).r;
+      }
+      bench::do_not_optimize(sum);
+    });
+    runner.run("castRay", size, [&] {
+      float sum = 0;
+      for (int i = 0; i < rays; i++) {
+        sum += castRay(image, sf::Color::Red, points[i], angles[i]).x;
+      }
+      bench::do_not_optimize(sum);
+    });
+  }
+}
+
+/// one sensor in the middle of a field of walls and posts
+void bench_sensor(bench::Runner& runner) {
+  for (int n : WALL_COUNTS) {
+    std::vector<sf::RectangleShape> walls;
+    for (int i = 0; i < n; i++) {
+      sf::RectangleShape wall(i % 2 ? sf::Vector2f(166, 12) : sf::Vector2f(12, 12));
+      wall.setPosition(rng.uniform(0, ARENA), rng.uniform(0, ARENA));
+      walls.push_back(wall);
+    }
+    Sensor sensor(sf::Vector2f(ARENA / 2, ARENA / 2), 0, 5.0f, 16);
+    float angle = 0;
+    runner.run("Sensor::update", n, [&] {
+      angle += 7;  // a different fan each time so that the same walls are not always the nearest
+      sensor.set_angle(angle);
+      sensor.update(walls);
+      bench::do_not_optimize(sensor.distance());
+    });
+  }
+}
+
+/// one sample for every channel, and a block of 64 samples each to show what keeping the state in registers saves
+void bench_filters(bench::Runner& runner) {
+  const size_t block = 64;
+  for (int n : CHANNEL_COUNTS) {
+    std::vector<float> samples(block * n);
+    for (float& x : samples) {
+      x = rng.uniform();
+    }
+    std::vector<float> out(samples.size());
+    std::span<const float> first(samples.data(), size_t(n));
+    FilterBank banks[] = {FilterBank::exponential(n, 0.9f), FilterBank::low_pass(n, 1000.0f, 30.0f), FilterBank::moving_average(n, 16)};
+    const char* names[] = {"FilterBank::exponential", "FilterBank::low_pass", "FilterBank::moving_average"};
+    for (int i = 0; i < 3; i++) {
+      runner.run(names[i], n, [&] { bench::do_not_optimize(banks[i].update(first)[0]); });
+    }
+    runner.run("FilterBank::low_pass x64", n, [&] {
+      banks[1].process(samples, out);
+      bench::do_not_optimize(out[0]);
+    });
+  }
+}
+
+int main(int argc, char** argv) {
+  bench::Options options;
+  std::string json_path;
+  std::string baseline_path;
+  double tolerance = 0.10;
+  for (int i = 1; i < argc; i++) {
+    if (std::strcmp(argv[i], "--json") == 0 && i + 1 < argc) {
+      json_path = argv[++i];
+    } else if (std::strcmp(argv[i], "--baseline") == 0 && i + 1 < argc) {
+      baseline_path = argv[++i];
+    } else if (std::strcmp(argv[i], "--filter") == 0 && i + 1 < argc) {
+      options.filter = argv[++i];
+    } else if (std::strcmp(argv[i], "--tolerance") == 0 && i + 1 < argc) {
+      tolerance = std::atof(argv[++i]);
+    } else if (std::strcmp(argv[i], "--quick") == 0) {
+      options.samples = 9;
+      options.warmup_ms = 10;
+      options.sample_ms = 0.5;
+    } else {
+      std::fprintf(stderr, "usage: %s [--json file] [--baseline file] [--filter text] [--tolerance fraction] [--quick]\n", argv[0]);
+      return 2;
+    }
+  }
+
+  bench::Runner runner(options);
+  std::printf("%-28s %7s %17s %13s %17s\n", "benchmark", "size", "median", "MAD", "");
+  bench_collisions(runner);
+  bench_vectors(runner);
+  bench_images(runner);
+  bench_sensor(runner);
+  bench_filters(runner);
+
+  if (!json_path.empty() && !bench::write_json(json_path, runner.results())) {
+    std::fprintf(stderr, "unable to write %s\n", json_path.c_str());
+    return 2;
+  }
+  if (!baseline_path.empty()) {
+    std::vector<bench::Result> baseline = bench::read_json(baseline_path);
+    if (baseline.empty()) {
+      std::fprintf(stderr, "no results in %s\n", baseline_path.c_str());
+      return 2;
+    }
+    int slower = bench::compare(baseline, runner.results(), tolerance);
+    std::printf("%d slower than the baseline\n", slower);
+    return slower > 0 ? 1 : 0;
+  }
+  return 0;
+}
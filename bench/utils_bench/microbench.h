@@ -0,0 +1,221 @@
+#ifndef IMGUI_SFML_STARTER_MICROBENCH_H
+#define IMGUI_SFML_STARTER_MICROBENCH_H
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+/***
+ * Just enough of a benchmark harness to time small functions and tell a real
+ * change from noise.
+ *
+ * A benchmark is a name, a size and a function that does one batch of work.
+ *
+ * 1. The batch is repeated until one sample takes long enough to time well.
+ * 2. The code is warmed up for a while so that the caches, branch predictors
+ *    and clock speed settle.
+ * 3. Many samples are taken.
+ *
+ * The result is the median time per batch and the median absolute deviation
+ * (MAD). Unlike the mean and standard deviation, neither of those is moved
+ * much by the odd sample that got interrupted.
+ *
+ * Results are written as JSON with one benchmark per line. A results file can
+ * be compared with a saved one: a benchmark has regressed if its median is more
+ * than the tolerance slower AND the difference is bigger than three times the
+ * larger MAD, so that a noisy benchmark does not fail on its noise.
+ *
+ * Anything the batch computes must be passed to do_not_optimize() or the
+ * compiler may throw the work away.
+ */
+namespace bench {
+
+template <typename T>
+inline void do_not_optimize(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+  asm volatile("" : : "r,m"(value) : "memory");
+#else
+  static volatile const void* sink;
+  sink = &value;
+#endif
+}
+
+struct Options {
+  double sample_ms = 2.0;  // each sample is at least this long
+  double warmup_ms = 50.0;
+  int samples = 31;
+  std::string filter;  // only run benchmarks whose name contains this
+};
+
+struct Result {
+  std::string name;
+  int size = 0;
+  uint64_t iterations = 0;  // batches in each sample
+  int samples = 0;
+  double median_ns = 0;  // per batch
+  double mad_ns = 0;
+  double min_ns = 0;
+};
+
+inline double median(std::vector<double> values) {
+  if (values.empty()) {
+    return 0;
+  }
+  std::sort(values.begin(), values.end());
+  size_t n = values.size();
+  return n % 2 ? values[n / 2] : 0.5 * (values[n / 2 - 1] + values[n / 2]);
+}
+
+class Runner {
+ public:
+  explicit Runner(Options options = {}) : m_options(std::move(options)) {}
+
+  /// time body(), which does one batch of work on size items, and keep the result
+  template <typename F>
+  void run(const char* name, int size, F&& body) {
+    if (!m_options.filter.empty() && std::strstr(name, m_options.filter.c_str()) == nullptr) {
+      return;
+    }
+    using clock = std::chrono::steady_clock;
+    auto time_batches = [&](uint64_t n) {
+      auto start = clock::now();
+      for (uint64_t i = 0; i < n; i++) {
+        body();
+      }
+      return std::chrono::duration<double, std::nano>(clock::now() - start).count();
+    };
+
+    /// find how many batches make a sample long enough
+    const double sample_ns = m_options.sample_ms * 1e6;
+    uint64_t iterations = 1;
+    double t = time_batches(iterations);
+    while (t < sample_ns && iterations < (uint64_t(1) << 40)) {
+      iterations = t > 0 ? std::max(iterations * 2, uint64_t(double(iterations) * sample_ns / t * 1.2)) : iterations * 10;
+      t = time_batches(iterations);
+    }
+
+    auto warmup_end = clock::now() + std::chrono::duration<double, std::milli>(m_options.warmup_ms);
+    while (clock::now() < warmup_end) {
+      time_batches(iterations);
+    }
+
+    std::vector<double> per_batch(m_options.samples);
+    for (double& s : per_batch) {
+      s = time_batches(iterations) / double(iterations);
+    }
+    Result r;
+    r.name = name;
+    r.size = size;
+    r.iterations = iterations;
+    r.samples = m_options.samples;
+    r.median_ns = median(per_batch);
+    std::vector<double> deviations(per_batch.size());
+    for (size_t i = 0; i < per_batch.size(); i++) {
+      deviations[i] = std::fabs(per_batch[i] - r.median_ns);
+    }
+    r.mad_ns = median(deviations);
+    r.min_ns = *std::min_element(per_batch.begin(), per_batch.end());
+    std::printf("%-28s %7d %14.1f ns %10.1f ns %10.2f ns/item\n", name, size, r.median_ns, r.mad_ns, r.median_ns / std::max(1, size));
+    std::fflush(stdout);
+    m_results.push_back(r);
+  }
+
+  [[nodiscard]] const std::vector<Result>& results() const { return m_results; }
+
+ private:
+  Options m_options;
+  std::vector<Result> m_results;
+};
+
+inline bool write_json(const std::string& path, const std::vector<Result>& results) {
+  FILE* file = std::fopen(path.c_str(), "w");
+  if (!file) {
+    return false;
+  }
+  std::fprintf(file, "{\"benchmarks\":[\n");
+  for (size_t i = 0; i < results.size(); i++) {
+    const Result& r = results[i];
+    std::fprintf(file, "{\"name\":\"%s\",\"size\":%d,\"median_ns\":%.3f,\"mad_ns\":%.3f,\"min_ns\":%.3f,\"samples\":%d,\"iterations\":%llu}%s\n",
+                 r.name.c_str(), r.size, r.median_ns, r.mad_ns, r.min_ns, r.samples, (unsigned long long)r.iterations, i + 1 < results.size() ? "," : "");
+  }
+  std::fprintf(file, "]}\n");
+  return std::fclose(file) == 0;
+}
+
+/// a number after "key": on a line, as write_json() lays them out
+inline bool json_number(const char* line, const char* key, double& out) {
+  std::string pattern = std::string("\"") + key + "\":";
+  const char* at = std::strstr(line, pattern.c_str());
+  return at != nullptr && std::sscanf(at + pattern.size(), "%lf", &out) == 1;
+}
+
+/// reads a file written by write_json(). Anything else is not understood
+inline std::vector<Result> read_json(const std::string& path) {
+  std::vector<Result> results;
+  FILE* file = std::fopen(path.c_str(), "r");
+  if (!file) {
+    return results;
+  }
+  char line[1024];
+  while (std::fgets(line, sizeof(line), file)) {
+    const char* name = std::strstr(line, "\"name\":\"");
+    if (name == nullptr) {
+      continue;
+    }
+    name += 8;
+    const char* end = std::strchr(name, '"');
+    if (end == nullptr) {
+      continue;
+    }
+    Result r;
+    r.name.assign(name, end);
+    double size = 0;
+    json_number(line, "size", size);
+    r.size = int(size);
+    json_number(line, "median_ns", r.median_ns);
+    json_number(line, "mad_ns", r.mad_ns);
+    json_number(line, "min_ns", r.min_ns);
+    results.push_back(r);
+  }
+  std::fclose(file);
+  return results;
+}
+
+/***
+ * Print each benchmark against the baseline and return how many got slower.
+ * Benchmarks that are only in one of the two are listed but do not count.
+ */
+inline int compare(const std::vector<Result>& baseline, const std::vector<Result>& results, double tolerance) {
+  int regressions = 0;
+  std::printf("\n%-28s %7s %12s %12s %8s\n", "compared with baseline", "size", "baseline", "now", "change");
+  for (const Result& r : results) {
+    auto found = std::find_if(baseline.begin(), baseline.end(), [&](const Result& b) { return b.name == r.name && b.size == r.size; });
+    if (found == baseline.end()) {
+      std::printf("%-28s %7d %12s %9.1f ns      new\n", r.name.c_str(), r.size, "-", r.median_ns);
+      continue;
+    }
+    const double change = found->median_ns > 0 ? r.median_ns / found->median_ns - 1.0 : 0.0;
+    const double noise = 3.0 * std::max(found->mad_ns, r.mad_ns);
+    const bool slower = change > tolerance && r.median_ns - found->median_ns > noise;
+    const bool faster = change < -tolerance && found->median_ns - r.median_ns > noise;
+    regressions += slower ? 1 : 0;
+    std::printf("%-28s %7d %9.1f ns %9.1f ns %+7.1f%% %s\n", r.name.c_str(), r.size, found->median_ns, r.median_ns, 100.0 * change,
+                slower ? "SLOWER" : (faster ? "faster" : ""));
+  }
+  for (const Result& b : baseline) {
+    auto found = std::find_if(results.begin(), results.end(), [&](const Result& r) { return b.name == r.name && b.size == r.size; });
+    if (found == results.end()) {
+      std::printf("%-28s %7d %9.1f ns %12s      not run\n", b.name.c_str(), b.size, b.median_ns, "-");
+    }
+  }
+  return regressions;
+}
+
+}  // namespace bench
+
+#endif  // IMGUI_SFML_STARTER_MICROBENCH_H
@@ -0,0 +1,264 @@
+#ifndef IMGUI_SFML_STARTER_ALLOC_TRACKER_H
+#define IMGUI_SFML_STARTER_ALLOC_TRACKER_H
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+/***
+ * Counts every allocation made through the global operator new, by thread and by
+ * block of code, so that a frame which should not touch the heap can be shown not
+ * to, and one that starts to can be caught.
+ *
+ * The counting replaces the global operator new and delete, which can only be
+ * done once in a program. Define ALLOC_TRACKER_IMPLEMENTATION in main.cpp, and
+ * nowhere else, before including this file. The examples only do it in debug builds:
+ *
+ *     #ifndef NDEBUG
+ *     #define ALLOC_TRACKER_IMPLEMENTATION
+ *     #endif
+ *     #include "alloc_tracker.h"
+ *
+ * Without the define everything still compiles but the counts stay at zero and
+ * installed() is false. Memory from malloc() directly, which ImGui uses, is not counted.
+ *
+ * Each thread has its own counters, so counting needs no locks: the number of
+ * allocations and frees, the bytes asked for, the bytes currently allocated by that
+ * thread and the most there have ever been. A thread that frees memory another one
+ * made will see its live bytes go down, even below zero. The first MAX_THREADS
+ * threads get counters of their own and any more share one set.
+ *
+ * To see what a block of code allocates, put a Scope around it:
+ *
+ *     alloc_tracker::Scope scope;
+ *     update_sensors();
+ *     alloc_tracker::Counts used = scope.counts();  // allocations, bytes and peak inside the block
+ *
+ * Scopes can be nested. The profiler (profiler.h) does this for every PROFILE_SCOPE,
+ * so the counts appear in the ProfilerView and in the saved trace.
+ *
+ * Every allocation carries a small header holding its size, so the frees can be
+ * counted in bytes too. That costs 16 bytes an allocation and a few atomic adds,
+ * which is why it is left out of release builds. Check installed() before showing
+ * the counts, so that a release build does not claim to make no allocations.
+ */
+namespace alloc_tracker {
+
+constexpr int MAX_THREADS = 63;
+
+struct Counts {
+  uint64_t allocations = 0;
+  uint64_t frees = 0;
+  uint64_t bytes = 0;  // asked for in total
+  int64_t live = 0;    // bytes allocated and not yet freed
+  int64_t peak = 0;    // the most live bytes at any one time
+};
+
+/// one thread's counters. Only the owner writes them, apart from the shared set at the end
+class alignas(64) ThreadCounters {
+ public:
+  void allocated(size_t size) {
+    m_allocations.fetch_add(1, std::memory_order_relaxed);
+    m_bytes.fetch_add(size, std::memory_order_relaxed);
+    const int64_t live = m_live.fetch_add(int64_t(size), std::memory_order_relaxed) + int64_t(size);
+    if (live > m_peak.load(std::memory_order_relaxed)) {
+      m_peak.store(live, std::memory_order_relaxed);
+    }
+    if (live > m_scope_peak.load(std::memory_order_relaxed)) {
+      m_scope_peak.store(live, std::memory_order_relaxed);
+    }
+  }
+
+  void freed(size_t size) {
+    m_frees.fetch_add(1, std::memory_order_relaxed);
+    m_live.fetch_sub(int64_t(size), std::memory_order_relaxed);
+  }
+
+  /// safe to call from any thread
+  [[nodiscard]] Counts counts() const {
+    return {m_allocations.load(std::memory_order_relaxed), m_frees.load(std::memory_order_relaxed), m_bytes.load(std::memory_order_relaxed),
+            m_live.load(std::memory_order_relaxed), m_peak.load(std::memory_order_relaxed)};
+  }
+
+  /// start measuring the peak for a scope. Returns what the enclosing scope had, for end_scope()
+  int64_t begin_scope() {
+    const int64_t outer = m_scope_peak.load(std::memory_order_relaxed);
+    m_scope_peak.store(m_live.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    return outer;
+  }
+
+  /// the most live bytes since the innermost scope began
+  [[nodiscard]] int64_t scope_peak() const { return m_scope_peak.load(std::memory_order_relaxed); }
+
+  /// the most live bytes since begin_scope(). The enclosing scope keeps the larger of its peak and this one
+  int64_t end_scope(int64_t outer) {
+    const int64_t peak = m_scope_peak.load(std::memory_order_relaxed);
+    m_scope_peak.store(std::max(outer, peak), std::memory_order_relaxed);
+    return peak;
+  }
+
+ private:
+  std::atomic<uint64_t> m_allocations{0};
+  std::atomic<uint64_t> m_frees{0};
+  std::atomic<uint64_t> m_bytes{0};
+  std::atomic<int64_t> m_live{0};
+  std::atomic<int64_t> m_peak{0};
+  std::atomic<int64_t> m_scope_peak{0};
+};
+
+/// the last set is shared by any threads beyond MAX_THREADS
+inline std::array<ThreadCounters, MAX_THREADS + 1> g_threads;
+inline std::atomic<int> g_thread_count{0};
+inline std::atomic<bool> g_installed{false};
+
+/// the counters for the calling thread
+inline ThreadCounters& this_thread() {
+  thread_local ThreadCounters* mine = nullptr;
+  if (!mine) {
+    const int index = g_thread_count.fetch_add(1, std::memory_order_relaxed);
+    mine = &g_threads[std::min(index, MAX_THREADS)];
+  }
+  return *mine;
+}
+
+/// how many sets of counters are in use, the shared one included
+inline int thread_count() { return std::min(g_thread_count.load(std::memory_order_relaxed), MAX_THREADS + 1); }
+
+inline const ThreadCounters& thread(int index) { return g_threads[index]; }
+
+/// true once the replacement operator new has counted anything
+inline bool installed() { return g_installed.load(std::memory_order_relaxed); }
+
+/// every thread added together. The peak is the sum of the threads' peaks, so it can be more than the true peak
+inline Counts total() {
+  Counts sum;
+  for (int i = 0; i < thread_count(); i++) {
+    Counts c = g_threads[i].counts();
+    sum.allocations += c.allocations;
+    sum.frees += c.frees;
+    sum.bytes += c.bytes;
+    sum.live += c.live;
+    sum.peak += c.peak;
+  }
+  return sum;
+}
+
+/// calls to operator new since the program started
+inline uint64_t allocations() { return total().allocations; }
+/// bytes asked for since the program started
+inline uint64_t bytes() { return total().bytes; }
+
+/// what the calling thread allocates between construction and counts(). Read it before any scope inside it starts or after they end
+class Scope {
+ public:
+  Scope() : m_counters(this_thread()), m_start(m_counters.counts()), m_outer_peak(m_counters.begin_scope()) {}
+  ~Scope() { m_counters.end_scope(m_outer_peak); }
+
+  Scope(const Scope&) = delete;
+  Scope& operator=(const Scope&) = delete;
+
+  /// live is the change since the start and peak is the most it rose above the start
+  [[nodiscard]] Counts counts() const {
+    Counts now = m_counters.counts();
+    return {now.allocations - m_start.allocations, now.frees - m_start.frees, now.bytes - m_start.bytes, now.live - m_start.live,
+            std::max<int64_t>(0, m_counters.scope_peak() - m_start.live)};
+  }
+
+ private:
+  ThreadCounters& m_counters;
+  Counts m_start;
+  int64_t m_outer_peak;
+};
+
+namespace detail {
+
+/// the size is kept just in front of the memory handed out
+constexpr size_t HEADER = alignof(std::max_align_t);
+
+inline void* allocate(std::size_t size, std::size_t alignment) {
+  const size_t header = std::max(alignment, HEADER);
+  const size_t with_header = header + size;
+  std::byte* block;
+  if (alignment <= HEADER) {
+    block = static_cast<std::byte*>(std::malloc(with_header));
+  } else {
+#if defined(_WIN32)
+    block = static_cast<std::byte*>(_aligned_malloc(with_header, alignment));
+#else
+    block = static_cast<std::byte*>(std::aligned_alloc(alignment, (with_header + alignment - 1) / alignment * alignment));
+#endif
+  }
+  if (block == nullptr) {
+    return nullptr;
+  }
+  std::memcpy(block + header - sizeof(size_t), &size, sizeof(size_t));
+  if (!g_installed.load(std::memory_order_relaxed)) {
+    g_installed.store(true, std::memory_order_relaxed);
+  }
+  this_thread().allocated(size);
+  return block + header;
+}
+
+inline void* allocate_or_throw(std::size_t size, std::size_t alignment) {
+  void* p = allocate(size, alignment);
+  if (p == nullptr) {
+    throw std::bad_alloc();
+  }
+  return p;
+}
+
+inline void release(void* p, std::size_t alignment) {
+  if (p == nullptr) {
+    return;
+  }
+  const size_t header = std::max(alignment, HEADER);
+  std::byte* block = static_cast<std::byte*>(p) - header;
+  size_t size;
+  std::memcpy(&size, block + header - sizeof(size_t), sizeof(size_t));
+  this_thread().freed(size);
+#if defined(_WIN32)
+  if (alignment > HEADER) {
+    _aligned_free(block);
+    return;
+  }
+#endif
+  std::free(block);
+}
+
+}  // namespace detail
+}  // namespace alloc_tracker
+
+#if defined(ALLOC_TRACKER_IMPLEMENTATION)
+void* operator new(std::size_t size) { return alloc_tracker::detail::allocate_or_throw(size, alignof(std::max_align_t)); }
+void* operator new[](std::size_t size) { return alloc_tracker::detail::allocate_or_throw(size, alignof(std::max_align_t)); }
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept { return alloc_tracker::detail::allocate(size, alignof(std::max_align_t)); }
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept { return alloc_tracker::detail::allocate(size, alignof(std::max_align_t)); }
+void* operator new(std::size_t size, std::align_val_t alignment) { return alloc_tracker::detail::allocate_or_throw(size, std::size_t(alignment)); }
+void* operator new[](std::size_t size, std::align_val_t alignment) { return alloc_tracker::detail::allocate_or_throw(size, std::size_t(alignment)); }
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+  return alloc_tracker::detail::allocate(size, std::size_t(alignment));
+}
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+  return alloc_tracker::detail::allocate(size, std::size_t(alignment));
+}
+
+void operator delete(void* p) noexcept { alloc_tracker::detail::release(p, alignof(std::max_align_t)); }
+void operator delete[](void* p) noexcept { alloc_tracker::detail::release(p, alignof(std::max_align_t)); }
+void operator delete(void* p, std::size_t) noexcept { alloc_tracker::detail::release(p, alignof(std::max_align_t)); }
+void operator delete[](void* p, std::size_t) noexcept { alloc_tracker::detail::release(p, alignof(std::max_align_t)); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { alloc_tracker::detail::release(p, alignof(std::max_align_t)); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { alloc_tracker::detail::release(p, alignof(std::max_align_t)); }
+void operator delete(void* p, std::align_val_t alignment) noexcept { alloc_tracker::detail::release(p, std::size_t(alignment)); }
+void operator delete[](void* p, std::align_val_t alignment) noexcept { alloc_tracker::detail::release(p, std::size_t(alignment)); }
+void operator delete(void* p, std::size_t, std::align_val_t alignment) noexcept { alloc_tracker::detail::release(p, std::size_t(alignment)); }
+void operator delete[](void* p, std::size_t, std::align_val_t alignment) noexcept { alloc_tracker::detail::release(p, std::size_t(alignment)); }
+void operator delete(void* p, std::align_val_t alignment, const std::nothrow_t&) noexcept { alloc_tracker::detail::release(p, std::size_t(alignment)); }
+void operator delete[](void* p, std::align_val_t alignment, const std::nothrow_t&) noexcept { alloc_tracker::detail::release(p, std::size_t(alignment)); }
+#endif
+
+#endif  // IMGUI_SFML_STARTER_ALLOC_TRACKER_H
@@ -0,0 +1,382 @@
+#ifndef IMGUI_SFML_STARTER_ANGLE_H
+#define IMGUI_SFML_STARTER_ANGLE_H
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include "simd.h"
+#include "vec2.h"
+
+/***
+ * Angles, and sines and cosines fast enough for the inner loops.
+ *
+ * One set of constants so that nobody has to write 3.14 or 57.29 again. A
+ * robot turned through a full circle with pi taken as 3.14 ends up a twentieth
+ * of a degree short, and the error builds up every time it turns.
+ *
+ * The trig functions come in three accuracies:
+ *
+ *   Accuracy::Exact - std::sin and friends
+ *   Accuracy::High  - minimax polynomials. sin and cos within 1e-7 of the exact
+ *                     answer, which is as close as a float gets, atan2 within 3e-7
+ *   Accuracy::Low   - shorter polynomials. sin and cos within 1.5e-5, atan2 within
+ *                     6e-4 radians (0.035 degrees). Plenty for drawing and for rays
+ *                     a few hundred pixels long
+ *
+ * The polynomials need the angle brought into the range -pi/4 to pi/4 first, which
+ * is done in three steps so that it stays accurate for angles up to a few thousand
+ * radians. The batch versions work on arrays of angles and use the SIMD registers
+ * (see simd.h). As with the other batch kernels, n is rounded up to a whole number
+ * of lanes so the arrays must be padded.
+ *
+ * Angle is a binary angle: a whole turn is 2^32 so it wraps around for free when it
+ * is added to, and 359 degrees plus 2 degrees is 1 degree without any fmod(). Its
+ * sine and cosine come from a table of 1024 values with a straight line between
+ * them, good to 5e-6. That is the best choice for headings that are stored, turned
+ * a little at a time and looked at often.
+ *
+ * Measured with AVX2 (015-geometric-sensor-testing --bench), ns per angle for
+ * sin and cos together, and the largest difference from the exact answer:
+ *
+ *   std::sin + std::cos    9.8     3e-8
+ *   High                   8.4     7e-8
+ *   Low                    8.4     1.2e-5
+ *   Angle table            2.5     4.7e-6
+ *   High, batch            1.8     7e-8
+ *   Low, batch             1.3     1.2e-5
+ *   std::atan2            23.6
+ *   atan2 High, batch      1.4     2.9e-7
+ *   atan2 Low, batch       1.0     6.1e-4
+ *
+ * One angle at a time the polynomials are no quicker than a modern std::sin. The
+ * gain is in the batches, five to fifteen times faster, and in the table, which
+ * needs no range reduction at all. With SSE2 only the batches are about half as fast.
+ *
+ * Degrees are still what SFML and the examples use for rotations. Radians are what
+ * the maths library uses. Convert with radians() and degrees() at the boundary.
+ */
+
+namespace trig {
+
+constexpr float PI = 3.14159265358979323846f;
+constexpr double PI_D = 3.14159265358979323846;  // for the sums done in double
+constexpr float TWO_PI = 2 * PI;
+constexpr float HALF_PI = PI / 2;
+constexpr float DEG_TO_RAD = PI / 180.0f;
+constexpr float RAD_TO_DEG = 180.0f / PI;
+
+constexpr float radians(float degrees) { return degrees * DEG_TO_RAD; }
+constexpr float degrees(float radians) { return radians * RAD_TO_DEG; }
+
+enum class Accuracy { Exact, High, Low };
+
+namespace detail {
+
+/// pi/2 in three pieces. The first two have few enough bits that q * piece is exact
+constexpr float PIO2_1 = 1.5703125f;
+constexpr float PIO2_2 = 4.837512969970703125e-4f;
+constexpr float PIO2_3 = 7.54978995489188216e-8f;
+constexpr float TWO_OVER_PI = 0.636619772367581343f;
+
+template <typename T>
+T constant(float x);
+template <>
+inline float constant<float>(float x) {
+  return x;
+}
+template <>
+inline simd::f32 constant<simd::f32>(float x) {
+  return simd::splat(x);
+}
+
+/// sin(r) for r in -pi/4 to pi/4, where z = r * r
+template <Accuracy A, typename T>
+T sin_poly(T r, T z) {
+  if constexpr (A == Accuracy::Low) {
+    return r + r * z * (constant<T>(-1.6662834e-1f) + z * constant<T>(8.1529917e-3f));
+  }
+  return r + r * z * (constant<T>(-1.6666654611e-1f) + z * (constant<T>(8.3321608736e-3f) + z * constant<T>(-1.9515295891e-4f)));
+}
+
+/// cos(r) for r in -pi/4 to pi/4, where z = r * r
+template <Accuracy A, typename T>
+T cos_poly(T z) {
+  if constexpr (A == Accuracy::Low) {
+    return constant<T>(1.0f) + z * (constant<T>(-4.9977631e-1f) + z * constant<T>(4.0488931e-2f));
+  }
+  return constant<T>(1.0f) - constant<T>(0.5f) * z +
+         z * z * (constant<T>(4.166664568298827e-2f) + z * (constant<T>(-1.388731625493765e-3f) + z * constant<T>(2.443315711809948e-5f)));
+}
+
+/// atan(a) for a in 0 to 1
+template <Accuracy A, typename T>
+T atan_poly(T a) {
+  T z = a * a;
+  if constexpr (A == Accuracy::Low) {
+    return a * (constant<T>(0.99535792f) + z * (constant<T>(-0.28869003f) + z * constant<T>(0.079338827f)));
+  }
+  T p = constant<T>(-0.0040549371f);
+  p = constant<T>(0.021864369f) + z * p;
+  p = constant<T>(-0.055914484f) + z * p;
+  p = constant<T>(0.096423658f) + z * p;
+  p = constant<T>(-0.13908700f) + z * p;
+  p = constant<T>(0.19946581f) + z * p;
+  p = constant<T>(-0.33329862f) + z * p;
+  p = constant<T>(0.99999934f) + z * p;
+  return a * p;
+}
+
+template <Accuracy A>
+void sincos(float radians, float& s, float& c) {
+  /// round to the nearest quarter turn. A cast is much quicker than std::floor() without SSE4.1
+  const float q = float(int64_t(radians * TWO_OVER_PI + (radians < 0 ? -0.5f : 0.5f)));
+  const float r = ((radians - q * PIO2_1) - q * PIO2_2) - q * PIO2_3;
+  const float z = r * r;
+  const float sr = sin_poly<A>(r, z);
+  const float cr = cos_poly<A>(z);
+  /// which quarter of the circle the angle was in
+  switch (int64_t(q) & 3) {
+    case 0:
+      s = sr;
+      c = cr;
+      break;
+    case 1:
+      s = cr;
+      c = -sr;
+      break;
+    case 2:
+      s = -sr;
+      c = -cr;
+      break;
+    default:
+      s = -cr;
+      c = sr;
+      break;
+  }
+}
+
+template <Accuracy A>
+float atan2(float y, float x) {
+  const float ax = std::abs(x);
+  const float ay = std::abs(y);
+  const float big = std::max(ax, ay);
+  if (big <= 0) {
+    return 0;
+  }
+  float r = atan_poly<A>(std::min(ax, ay) / big);
+  if (ay > ax) {
+    r = HALF_PI - r;
+  }
+  if (x < 0) {
+    r = PI - r;
+  }
+  return y < 0 ? -r : r;
+}
+
+template <Accuracy A>
+void sincos(const float* radians, float* s, float* c, size_t n) {
+  const simd::f32 half = simd::splat(0.5f);
+  const simd::f32 one_and_half = simd::splat(1.5f);
+  const simd::f32 two_and_half = simd::splat(2.5f);
+  for (size_t i = 0; i < n; i += simd::WIDTH) {
+    simd::f32 x = simd::load(radians + i);
+    simd::f32 q = simd::floor(x * simd::splat(TWO_OVER_PI) + half);
+    simd::f32 r = ((x - q * simd::splat(PIO2_1)) - q * simd::splat(PIO2_2)) - q * simd::splat(PIO2_3);
+    simd::f32 z = r * r;
+    simd::f32 sr = sin_poly<A>(r, z);
+    simd::f32 cr = cos_poly<A>(z);
+    /// the quarter as a float from 0 to 3, and the same sign and swap rules as the scalar version
+    simd::f32 quarter = q - simd::splat(4.0f) * simd::floor(q * simd::splat(0.25f));
+    simd::mask odd = (quarter > half && quarter < one_and_half) || quarter > two_and_half;
+    simd::f32 sv = simd::select(odd, cr, sr);
+    simd::f32 cv = simd::select(odd, sr, cr);
+    sv = simd::select(quarter > one_and_half, -sv, sv);
+    cv = simd::select(quarter > half && quarter < two_and_half, -cv, cv);
+    simd::store(s + i, sv);
+    simd::store(c + i, cv);
+  }
+}
+
+template <Accuracy A>
+void atan2(const float* y, const float* x, float* out, size_t n) {
+  const simd::f32 zero = simd::splat(0.0f);
+  for (size_t i = 0; i < n; i += simd::WIDTH) {
+    simd::f32 vy = simd::load(y + i);
+    simd::f32 vx = simd::load(x + i);
+    simd::f32 ax = simd::abs(vx);
+    simd::f32 ay = simd::abs(vy);
+    simd::f32 big = simd::max(ax, ay);
+    simd::mask origin = big <= zero;
+    simd::f32 a = simd::min(ax, ay) / simd::select(origin, simd::splat(1.0f), big);
+    simd::f32 r = atan_poly<A>(a);
+    r = simd::select(ay > ax, simd::splat(HALF_PI) - r, r);
+    r = simd::select(vx < zero, simd::splat(PI) - r, r);
+    r = simd::select(vy < zero, -r, r);
+    simd::store(out + i, simd::select(origin, zero, r));
+  }
+}
+
+}  // namespace detail
+
+/// the accuracy is a run time choice. The kernels it picks between are compiled separately so it costs one branch per call
+inline void sincos(float radians, float& s, float& c, Accuracy accuracy = Accuracy::High) {
+  if (accuracy == Accuracy::Exact) {
+    s = std::sin(radians);
+    c = std::cos(radians);
+  } else if (accuracy == Accuracy::High) {
+    detail::sincos<Accuracy::High>(radians, s, c);
+  } else {
+    detail::sincos<Accuracy::Low>(radians, s, c);
+  }
+}
+
+inline float sin(float radians, Accuracy accuracy = Accuracy::High) {
+  float s, c;
+  sincos(radians, s, c, accuracy);
+  return s;
+}
+
+inline float cos(float radians, Accuracy accuracy = Accuracy::High) {
+  float s, c;
+  sincos(radians, s, c, accuracy);
+  return c;
+}
+
+/// in -pi to pi like std::atan2. Zero for the origin
+inline float atan2(float y, float x, Accuracy accuracy = Accuracy::High) {
+  if (accuracy == Accuracy::Exact) {
+    return std::atan2(y, x);
+  }
+  return accuracy == Accuracy::High ? detail::atan2<Accuracy::High>(y, x) : detail::atan2<Accuracy::Low>(y, x);
+}
+
+/// the sine and cosine of n angles in radians
+inline void sincos(const float* radians, float* s, float* c, size_t n, Accuracy accuracy = Accuracy::High) {
+  if (accuracy == Accuracy::Exact) {
+    for (size_t i = 0; i < n; i++) {
+      s[i] = std::sin(radians[i]);
+      c[i] = std::cos(radians[i]);
+    }
+  } else if (accuracy == Accuracy::High) {
+    detail::sincos<Accuracy::High>(radians, s, c, n);
+  } else {
+    detail::sincos<Accuracy::Low>(radians, s, c, n);
+  }
+}
+
+inline void atan2(const float* y, const float* x, float* out, size_t n, Accuracy accuracy = Accuracy::High) {
+  if (accuracy == Accuracy::Exact) {
+    for (size_t i = 0; i < n; i++) {
+      out[i] = std::atan2(y[i], x[i]);
+    }
+  } else if (accuracy == Accuracy::High) {
+    detail::atan2<Accuracy::High>(y, x, out, n);
+  } else {
+    detail::atan2<Accuracy::Low>(y, x, out, n);
+  }
+}
+
+namespace detail {
+
+/// sin(x) for x in -pi to pi by its series, so that the table can be made by the compiler
+constexpr double series_sin(double x) {
+  double term = x;
+  double sum = x;
+  for (int k = 1; k < 30; k++) {
+    term *= -x * x / double((2 * k) * (2 * k + 1));
+    sum += term;
+  }
+  return sum;
+}
+
+constexpr int TABLE_BITS = 10;
+constexpr int TABLE_SIZE = 1 << TABLE_BITS;
+
+/// the sine of table entry i in double, for making the table in other number formats too (see fixed_point.h)
+constexpr double table_sin(int i) {
+  double x = 2 * PI_D * double(i) / TABLE_SIZE;
+  return series_sin(x > PI_D ? x - 2 * PI_D : x);
+}
+
+/// one whole turn of sines with the first repeated at the end, so that there is always a next entry
+constexpr std::array<float, TABLE_SIZE + 1> make_sine_table() {
+  std::array<float, TABLE_SIZE + 1> table{};
+  for (int i = 0; i <= TABLE_SIZE; i++) {
+    table[i] = float(table_sin(i));
+  }
+  return table;
+}
+
+inline constexpr std::array<float, TABLE_SIZE + 1> SINE_TABLE = make_sine_table();
+
+}  // namespace detail
+
+}  // namespace trig
+
+class Angle {
+ public:
+  static constexpr double UNITS_PER_TURN = 4294967296.0;
+
+  constexpr Angle() = default;
+
+  static constexpr Angle from_bits(uint32_t bits) { return Angle(bits); }
+  static Angle from_degrees(float degrees) { return from_turns(double(degrees) / 360.0); }
+  static Angle from_radians(float radians) { return from_turns(double(radians) / (2 * trig::PI_D)); }
+  static Angle from_turns(double turns) {
+    turns -= std::floor(turns);
+    return Angle(uint32_t(int64_t(std::llround(turns * UNITS_PER_TURN))));
+  }
+  /// the direction of a vector, which need not be normalized
+  static Angle of(const Vec2& v, trig::Accuracy accuracy = trig::Accuracy::High) { return from_radians(trig::atan2(v.y, v.x, accuracy)); }
+
+  [[nodiscard]] constexpr uint32_t bits() const { return m_bits; }
+  /// -180 up to but not including 180
+  [[nodiscard]] constexpr float degrees() const { return float(int32_t(m_bits) * (360.0 / UNITS_PER_TURN)); }
+  /// -pi up to but not including pi
+  [[nodiscard]] constexpr float radians() const { return float(int32_t(m_bits) * (2 * trig::PI_D / UNITS_PER_TURN)); }
+
+  [[nodiscard]] float sin() const { return lookup(m_bits); }
+  [[nodiscard]] float cos() const { return lookup(m_bits + (1u << 30)); }
+  /// the unit vector pointing this way
+  [[nodiscard]] Vec2 direction() const { return {cos(), sin()}; }
+
+  constexpr Angle& operator+=(Angle a) {
+    m_bits += a.m_bits;
+    return *this;
+  }
+  constexpr Angle& operator-=(Angle a) {
+    m_bits -= a.m_bits;
+    return *this;
+  }
+  constexpr Angle operator+(Angle a) const { return Angle(m_bits + a.m_bits); }
+  constexpr Angle operator-(Angle a) const { return Angle(m_bits - a.m_bits); }
+  constexpr Angle operator-() const { return Angle(0u - m_bits); }
+  constexpr bool operator==(const Angle&) const = default;
+
+ private:
+  constexpr explicit Angle(uint32_t bits) : m_bits(bits) {}
+
+  static float lookup(uint32_t bits) {
+    constexpr int FRACTION_BITS = 32 - trig::detail::TABLE_BITS;
+    const uint32_t i = bits >> FRACTION_BITS;
+    const float t = float(bits & ((1u << FRACTION_BITS) - 1)) * (1.0f / float(1u << FRACTION_BITS));
+    const float a = trig::detail::SINE_TABLE[i];
+    return a + (trig::detail::SINE_TABLE[i + 1] - a) * t;
+  }
+
+  uint32_t m_bits = 0;
+};
+
+namespace trig {
+
+/// the sine and cosine of n binary angles from the table
+inline void sincos(const Angle* angles, float* s, float* c, size_t n) {
+  for (size_t i = 0; i < n; i++) {
+    s[i] = angles[i].sin();
+    c[i] = angles[i].cos();
+  }
+}
+
+}  // namespace trig
+
+#endif  // IMGUI_SFML_STARTER_ANGLE_H
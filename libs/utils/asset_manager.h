@@ -0,0 +1,232 @@
+#ifndef IMGUI_SFML_STARTER_ASSET_MANAGER_H
+#define IMGUI_SFML_STARTER_ASSET_MANAGER_H
+
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <future>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "SFML/Graphics.hpp"
+#include "thread_pool.h"
+
+/***
+ * Loads textures and fonts in the background so that the window can open at once.
+ *
+ * texture.loadFromFile() does two slow things. It decodes the PNG, which is all
+ * CPU work, and then it copies the pixels to the graphics card. For a 3000x3000 map
+ * the decoding is by far the bigger part and it happens before the first frame.
+ *
+ * The AssetManager decodes each image into an sf::Image on a worker thread.
+ * Copying to the graphics card has to happen on the thread that owns the OpenGL
+ * context, so update() does it from the main loop, a band of rows at a time, and
+ * stops when it has used up its time budget for the frame. A big map then arrives
+ * over a few frames while the rest of the program keeps running.
+ *
+ *   AssetManager assets;
+ *   TextureHandle map = assets.texture("assets/images/map-3000x3000.png");
+ *   while (window.isOpen()) {
+ *     assets.update();
+ *     if (map->ready()) {
+ *       window.draw(sf::Sprite(map->texture));
+ *     }
+ *   }
+ *
+ * Asking for the same file twice gives back the same handle so nothing is
+ * loaded twice. The handles are shared pointers and stay valid for as long as anyone
+ * holds one. Each has a future, decoded, for code that would rather wait. wait() does the
+ * whole job at once for anything that is needed before the first frame.
+ *
+ * Requests, update() and wait() should all be called from the main thread.
+ */
+
+enum class AssetState { Decoding, Decoded, Uploading, Ready, Failed };
+
+struct TextureAsset {
+  std::string path;
+  sf::Texture texture;  // only use this once the asset is ready
+  std::shared_future<bool> decoded;
+  [[nodiscard]] AssetState state() const { return m_state.load(); }
+  [[nodiscard]] bool ready() const { return state() == AssetState::Ready; }
+  [[nodiscard]] bool failed() const { return state() == AssetState::Failed; }
+  /// how much of the texture has reached the graphics card, from 0 to 1
+  [[nodiscard]] float progress() const {
+    AssetState s = state();
+    if (s == AssetState::Ready) {
+      return 1.0f;
+    }
+    return s == AssetState::Uploading ? float(m_rows_uploaded) / float(m_image.getSize().y) : 0.0f;
+  }
+
+ private:
+  friend class AssetManager;
+  std::atomic<AssetState> m_state{AssetState::Decoding};
+  sf::Image m_image;  // written by the worker, then read by update() once the state says it is decoded
+  unsigned m_rows_uploaded = 0;
+};
+
+struct FontAsset {
+  std::string path;
+  sf::Font font;
+  std::shared_future<bool> decoded;
+  [[nodiscard]] AssetState state() const { return m_state.load(); }
+  [[nodiscard]] bool ready() const { return state() == AssetState::Ready; }
+  [[nodiscard]] bool failed() const { return state() == AssetState::Failed; }
+
+ private:
+  friend class AssetManager;
+  std::atomic<AssetState> m_state{AssetState::Decoding};
+  std::vector<char> m_bytes;  // sf::Font reads glyphs from this as they are needed so it must outlive the font
+};
+
+using TextureHandle = std::shared_ptr<TextureAsset>;
+using FontHandle = std::shared_ptr<FontAsset>;
+
+class AssetManager {
+ public:
+  /// two threads are plenty to keep ahead of the uploads
+  explicit AssetManager(size_t threads = 2) : m_pool(threads) {}
+
+  TextureHandle texture(const std::string& path) {
+    auto found = m_textures.find(path);
+    if (found != m_textures.end()) {
+      return found->second;
+    }
+    auto asset = std::make_shared<TextureAsset>();
+    asset->path = path;
+    asset->decoded = m_pool
+                         .submit([asset]() {
+                           bool ok = asset->m_image.loadFromFile(asset->path);
+                           asset->m_state = ok ? AssetState::Decoded : AssetState::Failed;
+                           return ok;
+                         })
+                         .share();
+    m_textures[path] = asset;
+    m_uploads.push_back(asset);
+    return asset;
+  }
+
+  /// the file is read on a worker. sf::Font does the rest lazily so there is nothing to upload
+  FontHandle font(const std::string& path) {
+    auto found = m_fonts.find(path);
+    if (found != m_fonts.end()) {
+      return found->second;
+    }
+    auto asset = std::make_shared<FontAsset>();
+    asset->path = path;
+    asset->decoded = m_pool
+                         .submit([asset]() {
+                           std::ifstream file(asset->path, std::ios::binary);
+                           asset->m_bytes.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+                           bool ok = !asset->m_bytes.empty();
+                           asset->m_state = ok ? AssetState::Decoded : AssetState::Failed;
+                           return ok;
+                         })
+                         .share();
+    m_fonts[path] = asset;
+    m_font_loads.push_back(asset);
+    return asset;
+  }
+
+  /***
+   * Do the main thread's share of the loading. Call once a frame. Uploads are done
+   * in bands of about a megabyte and it stops after the first band that takes
+   * the time past the budget, so each frame makes some progress.
+   */
+  void update(sf::Time budget = sf::milliseconds(4)) {
+    sf::Clock clock;
+    for (auto& font : m_font_loads) {
+      if (font->state() == AssetState::Decoded) {
+        finish_font(*font);
+      }
+    }
+    std::erase_if(m_font_loads, [](const FontHandle& f) { return f->ready() || f->failed(); });
+
+    bool any_band = false;
+    for (auto& asset : m_uploads) {
+      if (any_band && clock.getElapsedTime() >= budget) {
+        break;
+      }
+      if (asset->state() == AssetState::Decoded) {
+        start_upload(*asset);
+      }
+      while (asset->state() == AssetState::Uploading && (!any_band || clock.getElapsedTime() < budget)) {
+        upload_band(*asset);
+        any_band = true;
+      }
+    }
+    std::erase_if(m_uploads, [](const TextureHandle& t) { return t->ready() || t->failed(); });
+  }
+
+  /// load the texture completely before returning
+  bool wait(const TextureHandle& asset) {
+    asset->decoded.wait();
+    if (asset->state() == AssetState::Decoded) {
+      start_upload(*asset);
+    }
+    while (asset->state() == AssetState::Uploading) {
+      upload_band(*asset);
+    }
+    return asset->ready();
+  }
+
+  bool wait(const FontHandle& asset) {
+    asset->decoded.wait();
+    if (asset->state() == AssetState::Decoded) {
+      finish_font(*asset);
+    }
+    return asset->ready();
+  }
+
+  /// textures and fonts that are not yet ready
+  [[nodiscard]] size_t pending() const { return m_uploads.size() + m_font_loads.size(); }
+
+  /// forget the manager's own handles. Assets are freed when the last handle goes
+  void clear() {
+    m_textures.clear();
+    m_fonts.clear();
+  }
+
+ private:
+  static constexpr unsigned BAND_PIXELS = 256 * 1024;
+
+  static void start_upload(TextureAsset& asset) {
+    sf::Vector2u size = asset.m_image.getSize();
+    if (!asset.texture.create(size.x, size.y)) {  // too big for this graphics card
+      asset.m_image = sf::Image();
+      asset.m_state = AssetState::Failed;
+      return;
+    }
+    asset.m_rows_uploaded = 0;
+    asset.m_state = AssetState::Uploading;
+  }
+
+  static void upload_band(TextureAsset& asset) {
+    sf::Vector2u size = asset.m_image.getSize();
+    unsigned rows = std::max(1u, BAND_PIXELS / std::max(1u, size.x));
+    rows = std::min(rows, size.y - asset.m_rows_uploaded);
+    const sf::Uint8* pixels = asset.m_image.getPixelsPtr() + size_t(asset.m_rows_uploaded) * size.x * 4;
+    asset.texture.update(pixels, size.x, rows, 0, asset.m_rows_uploaded);
+    asset.m_rows_uploaded += rows;
+    if (asset.m_rows_uploaded >= size.y) {
+      asset.m_image = sf::Image();  // the pixels live on the graphics card now
+      asset.m_state = AssetState::Ready;
+    }
+  }
+
+  static void finish_font(FontAsset& asset) {
+    bool ok = asset.font.loadFromMemory(asset.m_bytes.data(), asset.m_bytes.size());
+    asset.m_state = ok ? AssetState::Ready : AssetState::Failed;
+  }
+
+  std::unordered_map<std::string, TextureHandle> m_textures;
+  std::unordered_map<std::string, FontHandle> m_fonts;
+  std::vector<TextureHandle> m_uploads;  // in the order they were asked for
+  std::vector<FontHandle> m_font_loads;
+  ThreadPool m_pool;  // last, so the workers stop before anything they use is destroyed
+};
+
+#endif  // IMGUI_SFML_STARTER_ASSET_MANAGER_H
@@ -6,6 +6,8 @@
 #define COLLISIONS_H
 
 #include <SFML/Graphics.hpp>
+#include <array>
+#include "vec2.h"
 
 /**
  * In this file is a static struct that contains collision detection functions.  It is a struct
@@ -75,7 +77,7 @@ struct Collisions {
   /// The first value is the minimum, and the second value is the maximum.
   /// The axis is a normalized vector that points in the direction of the projection.
   static std::pair<float, float> project_rect_onto_axis(const sf::RectangleShape& rect, const sf::Vector2f& axis) {
-    std::vector<sf::Vector2f> points(4);
+    std::array<sf::Vector2f, 4> points;
     for (size_t i = 0; i < 4; ++i) {
       points[i] = rect.getTransform().transformPoint(rect.getPoint(i));
     }
@@ -105,7 +107,7 @@ struct Collisions {
   /// This function is more general than the axis-aligned case at the top
   /// as it can handle rotated rectangles
   static bool rectangles_overlap(const sf::RectangleShape& rect1, const sf::RectangleShape& rect2) {
-    std::vector<sf::Vector2f> axes = {rect1.getTransform().transformPoint(rect1.getPoint(1)) - rect1.getTransform().transformPoint(rect1.getPoint(0)),
+    std::array<sf::Vector2f, 4> axes = {rect1.getTransform().transformPoint(rect1.getPoint(1)) - rect1.getTransform().transformPoint(rect1.getPoint(0)),
                                       rect1.getTransform().transformPoint(rect1.getPoint(3)) - rect1.getTransform().transformPoint(rect1.getPoint(0)),
                                       rect2.getTransform().transformPoint(rect2.getPoint(1)) - rect2.getTransform().transformPoint(rect2.getPoint(0)),
                                       rect2.getTransform().transformPoint(rect2.getPoint(3)) - rect2.getTransform().transformPoint(rect2.getPoint(0))};
@@ -140,8 +142,9 @@ struct Collisions {
 
   /// This function returns the 4 vertices of a rectangle in world space,
   /// taking into account the rectangle's position, rotation, and scale.
-  static std::vector<sf::Vector2f> get_rectangle_vertices(const sf::RectangleShape& rect) {
-    std::vector<sf::Vector2f> vertices(4);
+  /// The fixed size arrays here keep the collision tests off the heap.
+  static std::array<sf::Vector2f, 4> get_rectangle_vertices(const sf::RectangleShape& rect) {
+    std::array<sf::Vector2f, 4> vertices;
     for (size_t i = 0; i < 4; ++i) {
       vertices[i] = rect.getTransform().transformPoint(rect.getPoint(i));
     }
@@ -165,19 +168,23 @@ struct Collisions {
 
     // Get rectangle vertices and edges
     auto vertices = get_rectangle_vertices(rect);
-    std::vector<sf::Vector2f> edges = {vertices[1] - vertices[0], vertices[2] - vertices[1], vertices[3] - vertices[2], vertices[0] - vertices[3]};
-
-    // Add the circle's center-to-vertex axes for SAT
-    for (const auto& vertex : vertices) {
-      edges.push_back(circleCenter - vertex);
+    // and the circle's center-to-vertex axes for SAT
+    std::array<sf::Vector2f, 8> edges = {vertices[1] - vertices[0],   vertices[2] - vertices[1],   vertices[3] - vertices[2],   vertices[0] - vertices[3],
+                                         circleCenter - vertices[0], circleCenter - vertices[1], circleCenter - vertices[2], circleCenter - vertices[3]};
+
+    // Turn each edge into its perpendicular axis and normalize them all in one go so that
+    // the projections below are plain dot products. A zero axis stays zero and so can never
+    // separate the shapes, which is what project_vector() would give as well.
+    std::array<sf::Vector2f, 8> axes;
+    for (size_t i = 0; i < edges.size(); ++i) {
+      axes[i] = sf::Vector2f(-edges[i].y, edges[i].x);
     }
+    vec2::normalize(axes);
 
     // Check for overlap on all axes
-    for (const auto& edge : edges) {
-      sf::Vector2f axis(-edge.y, edge.x);  // Perpendicular axis
-
+    for (const auto& axis : axes) {
       // Project circle onto the axis
-      float circleProjection = project_vector(circleCenter, axis);
+      float circleProjection = circleCenter.x * axis.x + circleCenter.y * axis.y;
       float circleMin = circleProjection - circleRadius;
       float circleMax = circleProjection + circleRadius;
 
@@ -185,7 +192,7 @@ struct Collisions {
       float rectMin = std::numeric_limits<float>::max();
       float rectMax = std::numeric_limits<float>::lowest();
       for (const auto& vertex : vertices) {
-        float projection = project_vector(vertex, axis);
+        float projection = vertex.x * axis.x + vertex.y * axis.y;
         rectMin = std::min(rectMin, projection);
         rectMax = std::max(rectMax, projection);
       }
@@ -5,10 +5,11 @@
 #ifndef IMGUI_SFML_STARTER_EXPFILTER_H
 #define IMGUI_SFML_STARTER_EXPFILTER_H
 
+/// one value at a time. To filter many channels together see FilterBank in filter_bank.h
 template <class T>
 class ExpFilter {
  public:
-  T value;
+  T value{};
   float m_alpha;
   explicit ExpFilter(float alpha = 0.5) : m_alpha(alpha){};
   T update(T x) {
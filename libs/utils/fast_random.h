@@ -0,0 +1,182 @@
+#ifndef IMGUI_SFML_STARTER_FAST_RANDOM_H
+#define IMGUI_SFML_STARTER_FAST_RANDOM_H
+
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <span>
+
+/***
+ * Small, fast random number generators for the simulations.
+ *
+ * std::mt19937 is a fine generator but it carries 5KB of state. A function-static
+ * one shared by every caller is also a data race as soon as two threads use it.
+ * rand() has the same problem and is not much good anyway.
+ *
+ * Xoshiro128 (xoshiro128+ by Blackman and Vigna) has 16 bytes of state and each
+ * number costs a few shifts and adds. There are three ways to get one:
+ *
+ *   thread_rng()                - one generator per thread, made on first use. Good for
+ *                                 casual use anywhere. Nothing is shared so there are no locks.
+ *   Xoshiro128::stream(seed, n) - a generator for stream n. Give every agent its own
+ *                                 stream and the results do not depend on which
+ *                                 thread ran which agent, or in what order.
+ *   counter_uniform(key, count) - no state at all. The same key and count always give
+ *                                 the same number, which is handy for per-agent,
+ *                                 per-step noise in parallel code.
+ *
+ * The fill_ functions write a whole batch of numbers at once. That keeps the generator
+ * state in registers for the whole loop and is much quicker than one call per number.
+ *
+ * Call set_random_seed() before starting any threads to make thread_rng()
+ * repeatable from run to run. Each thread gets the streams in the order the threads
+ * first ask for a generator.
+ */
+
+/// SplitMix64 turns any 64 bit value into a well mixed one. Used for seeding.
+inline uint64_t splitmix64(uint64_t& state) {
+  uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+  z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+  z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+  return z ^ (z >> 31);
+}
+
+/// 24 random bits make an exactly representable float in [0,1)
+inline float u32_to_unit_float(uint32_t x) { return float(x >> 8) * (1.0f / 16777216.0f); }
+
+class Xoshiro128 {
+ public:
+  explicit Xoshiro128(uint64_t seed = 0x853C49E6748FEA9Bull) { set_seed(seed); }
+
+  /// an independent generator for each stream number, all from the same seed
+  static Xoshiro128 stream(uint64_t seed, uint64_t stream_id) { return Xoshiro128(seed ^ (stream_id * 0xD1B54A32D192ED03ull)); }
+
+  void set_seed(uint64_t seed) {
+    uint64_t sm = seed;
+    uint64_t a = splitmix64(sm);
+    uint64_t b = splitmix64(sm);
+    m_s[0] = uint32_t(a);
+    m_s[1] = uint32_t(a >> 32);
+    m_s[2] = uint32_t(b);
+    m_s[3] = uint32_t(b >> 32);
+    m_has_spare = false;
+  }
+
+  uint32_t next_u32() {
+    const uint32_t result = m_s[0] + m_s[3];
+    const uint32_t t = m_s[1] << 9;
+    m_s[2] ^= m_s[0];
+    m_s[3] ^= m_s[1];
+    m_s[1] ^= m_s[2];
+    m_s[0] ^= m_s[3];
+    m_s[2] ^= t;
+    m_s[3] = (m_s[3] << 11) | (m_s[3] >> 21);
+    return result;
+  }
+
+  /// uniform in [0,1)
+  float uniform() { return u32_to_unit_float(next_u32()); }
+
+  /// uniform in [a,b)
+  float uniform(float a, float b) { return a + (b - a) * uniform(); }
+
+  /// standard normal distribution using Box-Muller. Numbers come in pairs so one is kept for next time
+  float normal() {
+    if (m_has_spare) {
+      m_has_spare = false;
+      return m_spare;
+    }
+    float c, s;
+    float r = box_muller(c, s);
+    m_spare = r * s;
+    m_has_spare = true;
+    return r * c;
+  }
+
+  float normal(float mean, float sigma) { return mean + sigma * normal(); }
+
+  void fill_uniform(std::span<float> out, float a = 0.0f, float b = 1.0f) {
+    const float range = b - a;
+    for (float& v : out) {
+      v = a + range * uniform();
+    }
+  }
+
+  void fill_normal(std::span<float> out, float mean = 0.0f, float sigma = 1.0f) {
+    size_t i = 0;
+    for (; i + 1 < out.size(); i += 2) {
+      float c, s;
+      float r = sigma * box_muller(c, s);
+      out[i] = mean + r * c;
+      out[i + 1] = mean + r * s;
+    }
+    if (i < out.size()) {
+      out[i] = mean + sigma * normal();
+    }
+  }
+
+ private:
+  /// returns the radius and the cosine and sine of a random angle
+  float box_muller(float& c, float& s) {
+    const float two_pi = 6.28318530718f;
+    float u1 = 1.0f - uniform();  // (0,1] so the log is safe
+    float theta = two_pi * uniform();
+    c = std::cos(theta);
+    s = std::sin(theta);
+    return std::sqrt(-2.0f * std::log(u1));
+  }
+
+  uint32_t m_s[4];
+  float m_spare = 0.0f;
+  bool m_has_spare = false;
+};
+
+/***
+ * A counter based generator (Widynski's 'squares'). There is no state - the key
+ * picks the stream and the counter picks the number in the stream. Use, say,
+ * the agent number as the key and the step number as the counter.
+ *
+ * Squares needs a key with plenty of set bits. Small keys like agent numbers
+ * give poor results so the key is mixed with SplitMix64 first.
+ */
+inline uint32_t counter_u32(uint64_t key, uint64_t counter) {
+  key = splitmix64(key) | 1;  // the key must be odd
+  uint64_t x = counter * key;
+  uint64_t y = x;
+  uint64_t z = y + key;
+  x = x * x + y;
+  x = (x >> 32) | (x << 32);
+  x = x * x + z;
+  x = (x >> 32) | (x << 32);
+  x = x * x + y;
+  x = (x >> 32) | (x << 32);
+  return uint32_t((x * x + z) >> 32);
+}
+
+inline float counter_uniform(uint64_t key, uint64_t counter) { return u32_to_unit_float(counter_u32(key, counter)); }
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// The per-thread generators
+
+inline std::atomic<uint64_t>& random_seed_state() {
+  static std::atomic<uint64_t> seed{0x853C49E6748FEA9Bull};
+  return seed;
+}
+
+inline std::atomic<uint64_t>& random_stream_counter() {
+  static std::atomic<uint64_t> counter{0};
+  return counter;
+}
+
+/// set the seed for all the thread generators that have not been used yet
+inline void set_random_seed(uint64_t seed) {
+  random_seed_state() = seed;
+  random_stream_counter() = 0;
+}
+
+inline Xoshiro128& thread_rng() {
+  thread_local Xoshiro128 rng = Xoshiro128::stream(random_seed_state().load(), random_stream_counter().fetch_add(1));
+  return rng;
+}
+
+#endif  // IMGUI_SFML_STARTER_FAST_RANDOM_H
@@ -0,0 +1,274 @@
+#ifndef IMGUI_SFML_STARTER_FILTER_BANK_H
+#define IMGUI_SFML_STARTER_FILTER_BANK_H
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <span>
+#include <vector>
+#include "angle.h"
+#include "simd.h"
+
+/***
+ * The same filter run over many channels at once: every wheel encoder, IR sensor
+ * and current sense on a robot, or the same sensor on a few hundred simulated robots.
+ *
+ * ExpFilter (expfilter.h) filters one value at a time. A FilterBank keeps each piece
+ * of filter state as an array with one entry per channel, so one sample for every
+ * channel is a few SIMD loads, multiplies and stores per WIDTH channels (see simd.h)
+ * instead of a function call per channel.
+ *
+ *     FilterBank encoders = FilterBank::low_pass(channels, 1000.0f, 30.0f);  // 1kHz samples, 30Hz cut off
+ *     ...
+ *     std::span<const float> smooth = encoders.update(raw);  // raw has one sample per channel
+ *
+ * The kinds of filter are
+ *
+ *   exponential     value = alpha * value + (1 - alpha) * x, as ExpFilter and exponential_filter()
+ *   low_pass        a second order Butterworth style low pass biquad
+ *   notch           a biquad that removes one frequency, such as motor PWM or mains hum
+ *   biquad          any other biquad, from its coefficients
+ *   moving_average  the mean of the last length samples
+ *
+ * All the channels in a bank share the same settings. Channels that need different
+ * ones go in another bank.
+ *
+ * process() runs several samples per channel in one call. The samples are laid out
+ * one row per time step, one column per channel. The filter state then stays in
+ * registers for the whole block, which is the fastest way to run a filter at kHz
+ * rates when the samples arrive in bursts.
+ *
+ * The channel count does not need to be a multiple of WIDTH. The last few channels
+ * are done one at a time with the same arithmetic, so they give the same answers.
+ */
+
+/// y[n] = b0 x[n] + b1 x[n-1] + b2 x[n-2] - a1 y[n-1] - a2 y[n-2], already divided through by a0
+struct BiquadCoefficients {
+  float b0 = 1;
+  float b1 = 0;
+  float b2 = 0;
+  float a1 = 0;
+  float a2 = 0;
+
+  /// from the Audio EQ Cookbook. q = 0.7071 is the flattest pass band without a bump
+  static BiquadCoefficients low_pass(float sample_rate, float cutoff, float q = 0.70710678f) {
+    const double w0 = 2 * trig::PI_D * cutoff / sample_rate;
+    const double alpha = std::sin(w0) / (2 * q);
+    const double cos_w0 = std::cos(w0);
+    const double a0 = 1 + alpha;
+    return {float((1 - cos_w0) / 2 / a0), float((1 - cos_w0) / a0), float((1 - cos_w0) / 2 / a0), float(-2 * cos_w0 / a0), float((1 - alpha) / a0)};
+  }
+
+  /// higher q makes the notch narrower
+  static BiquadCoefficients notch(float sample_rate, float centre, float q = 10.0f) {
+    const double w0 = 2 * trig::PI_D * centre / sample_rate;
+    const double alpha = std::sin(w0) / (2 * q);
+    const double cos_w0 = std::cos(w0);
+    const double a0 = 1 + alpha;
+    return {float(1 / a0), float(-2 * cos_w0 / a0), float(1 / a0), float(-2 * cos_w0 / a0), float((1 - alpha) / a0)};
+  }
+
+  /// the output for a steady input of 1
+  [[nodiscard]] float dc_gain() const { return (b0 + b1 + b2) / (1 + a1 + a2); }
+};
+
+class FilterBank {
+ public:
+  enum class Kind { Exponential, Biquad, MovingAverage };
+
+  /// alpha is the weight on the old value, as in ExpFilter. Closer to 1 is smoother
+  static FilterBank exponential(size_t channels, float alpha) {
+    FilterBank bank(Kind::Exponential, channels);
+    bank.m_alpha = alpha;
+    return bank;
+  }
+
+  static FilterBank biquad(size_t channels, const BiquadCoefficients& coefficients) {
+    FilterBank bank(Kind::Biquad, channels);
+    bank.m_biquad = coefficients;
+    bank.m_z1.assign(bank.m_value.size(), 0.0f);
+    bank.m_z2.assign(bank.m_value.size(), 0.0f);
+    return bank;
+  }
+
+  static FilterBank low_pass(size_t channels, float sample_rate, float cutoff, float q = 0.70710678f) {
+    return biquad(channels, BiquadCoefficients::low_pass(sample_rate, cutoff, q));
+  }
+
+  static FilterBank notch(size_t channels, float sample_rate, float centre, float q = 10.0f) {
+    return biquad(channels, BiquadCoefficients::notch(sample_rate, centre, q));
+  }
+
+  static FilterBank moving_average(size_t channels, size_t length) {
+    assert(length > 0);
+    FilterBank bank(Kind::MovingAverage, channels);
+    bank.m_length = length;
+    bank.m_sum.assign(bank.m_value.size(), 0.0f);
+    bank.m_history.assign(length * bank.m_value.size(), 0.0f);
+    return bank;
+  }
+
+  [[nodiscard]] Kind kind() const { return m_kind; }
+  [[nodiscard]] size_t channels() const { return m_channels; }
+  /// the latest output of every channel
+  [[nodiscard]] std::span<const float> values() const { return {m_value.data(), m_channels}; }
+  [[nodiscard]] float value(size_t channel) const { return m_value[channel]; }
+
+  /// every channel as if it had been reading v for ever
+  void reset(float v = 0) {
+    std::fill(m_value.begin(), m_value.end(), v);
+    if (m_kind == Kind::Biquad) {
+      const float y = v * m_biquad.dc_gain();
+      std::fill(m_z1.begin(), m_z1.end(), y - m_biquad.b0 * v);
+      std::fill(m_z2.begin(), m_z2.end(), m_biquad.b2 * v - m_biquad.a2 * y);
+    } else if (m_kind == Kind::MovingAverage) {
+      std::fill(m_history.begin(), m_history.end(), v);
+      std::fill(m_sum.begin(), m_sum.end(), v * float(m_length));
+    }
+  }
+
+  /// one new sample for every channel. Returns the filtered values
+  std::span<const float> update(std::span<const float> samples) {
+    assert(samples.size() == m_channels);
+    run(samples.data(), m_value.data(), 1);
+    return values();
+  }
+
+  /***
+   * Filter steps samples for every channel. in and out hold steps rows of channels()
+   * values each, oldest first, and may be the same array. values() is left holding the
+   * last row.
+   */
+  void process(std::span<const float> in, std::span<float> out) {
+    assert(in.size() % m_channels == 0 && out.size() == in.size());
+    run(in.data(), out.data(), in.size() / m_channels);
+  }
+
+ private:
+  FilterBank(Kind kind, size_t channels) : m_kind(kind), m_channels(channels), m_value(simd::padded(channels), 0.0f) { assert(channels > 0); }
+
+  /// the kernels are written once and run with either of these: WIDTH channels at a time, then one at a time for the rest
+  struct Lanes {
+    using V = simd::f32;
+    static constexpr size_t N = simd::WIDTH;
+    static V load(const float* p) { return simd::load(p); }
+    static void store(float* p, V v) { simd::store(p, v); }
+    static V splat(float x) { return simd::splat(x); }
+  };
+  struct Scalar {
+    using V = float;
+    static constexpr size_t N = 1;
+    static V load(const float* p) { return *p; }
+    static void store(float* p, V v) { *p = v; }
+    static V splat(float x) { return x; }
+  };
+
+  void run(const float* in, float* out, size_t steps) {
+    if (steps == 0) {
+      return;
+    }
+    const size_t whole = m_channels / simd::WIDTH * simd::WIDTH;
+    switch (m_kind) {
+      case Kind::Exponential:
+        exponential<Lanes>(0, whole, in, out, steps);
+        exponential<Scalar>(whole, m_channels, in, out, steps);
+        break;
+      case Kind::Biquad:
+        biquad<Lanes>(0, whole, in, out, steps);
+        biquad<Scalar>(whole, m_channels, in, out, steps);
+        break;
+      case Kind::MovingAverage:
+        moving_average<Lanes>(0, whole, in, out, steps);
+        moving_average<Scalar>(whole, m_channels, in, out, steps);
+        m_head = (m_head + steps) % m_length;
+        break;
+    }
+  }
+
+  template <typename L>
+  void exponential(size_t first, size_t end, const float* in, float* out, size_t steps) {
+    const auto alpha = L::splat(m_alpha);
+    const auto beta = L::splat(1 - m_alpha);
+    for (size_t c = first; c < end; c += L::N) {
+      auto value = L::load(&m_value[c]);
+      for (size_t s = 0; s < steps; s++) {
+        value = alpha * value + beta * L::load(in + s * m_channels + c);
+        L::store(out + s * m_channels + c, value);
+      }
+      L::store(&m_value[c], value);
+    }
+  }
+
+  /// transposed direct form II, which needs the least state and rounds well in float
+  template <typename L>
+  void biquad(size_t first, size_t end, const float* in, float* out, size_t steps) {
+    const auto b0 = L::splat(m_biquad.b0);
+    const auto b1 = L::splat(m_biquad.b1);
+    const auto b2 = L::splat(m_biquad.b2);
+    const auto a1 = L::splat(m_biquad.a1);
+    const auto a2 = L::splat(m_biquad.a2);
+    for (size_t c = first; c < end; c += L::N) {
+      auto z1 = L::load(&m_z1[c]);
+      auto z2 = L::load(&m_z2[c]);
+      auto y = L::splat(0);
+      for (size_t s = 0; s < steps; s++) {
+        const auto x = L::load(in + s * m_channels + c);
+        y = b0 * x + z1;
+        z1 = b1 * x - a1 * y + z2;
+        z2 = b2 * x - a2 * y;
+        L::store(out + s * m_channels + c, y);
+      }
+      L::store(&m_z1[c], z1);
+      L::store(&m_z2[c], z2);
+      L::store(&m_value[c], y);
+    }
+  }
+
+  /***
+   * A running sum with the oldest sample taken off as each new one goes on. Rounding
+   * errors would build up in the sum for ever, so it is added up afresh from the
+   * history each time the ring buffer comes round.
+   */
+  template <typename L>
+  void moving_average(size_t first, size_t end, const float* in, float* out, size_t steps) {
+    const size_t stride = m_value.size();
+    const auto scale = L::splat(1.0f / float(m_length));
+    for (size_t c = first; c < end; c += L::N) {
+      auto sum = L::load(&m_sum[c]);
+      auto mean = L::splat(0);
+      size_t head = m_head;
+      for (size_t s = 0; s < steps; s++) {
+        const auto x = L::load(in + s * m_channels + c);
+        float* slot = &m_history[head * stride + c];
+        sum = sum + x - L::load(slot);
+        L::store(slot, x);
+        if (++head == m_length) {
+          head = 0;
+          sum = L::splat(0);
+          for (size_t i = 0; i < m_length; i++) {
+            sum = sum + L::load(&m_history[i * stride + c]);
+          }
+        }
+        mean = sum * scale;
+        L::store(out + s * m_channels + c, mean);
+      }
+      L::store(&m_sum[c], sum);
+      L::store(&m_value[c], mean);
+    }
+  }
+
+  Kind m_kind;
+  size_t m_channels;
+  std::vector<float> m_value;  // padded to whole SIMD lanes, like all the state arrays
+  float m_alpha = 0.5f;
+  BiquadCoefficients m_biquad;
+  std::vector<float> m_z1;
+  std::vector<float> m_z2;
+  size_t m_length = 1;
+  size_t m_head = 0;            // the history row the next sample goes in
+  std::vector<float> m_sum;
+  std::vector<float> m_history;  // m_length rows of padded channels
+};
+
+#endif  // IMGUI_SFML_STARTER_FILTER_BANK_H
@@ -0,0 +1,229 @@
+#ifndef IMGUI_SFML_STARTER_FIXED_POINT_H
+#define IMGUI_SFML_STARTER_FIXED_POINT_H
+
+#include <array>
+#include <cmath>
+#include <compare>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include "angle.h"
+
+/***
+ * Fixed point numbers, and a numeric policy so that the same simulation code
+ * can run in float, double or fixed point.
+ *
+ * The robots run on microcontrollers without a floating point unit, or with one
+ * that is too slow to use in the control loop, so the firmware does its sums in
+ * fixed point. Running the simulation with the same arithmetic means its results
+ * match the firmware bit for bit, rounding errors and all.
+ *
+ * Fixed<16> is Q16.16: a signed 32 bit integer holding the value times 65536.
+ * That covers -32768 to 32767.99998 in steps of 1.5e-5. The arithmetic is what
+ * firmware written in C would usually do:
+ *
+ *   a * b  is (int64_t(a) * b) >> 16, so it rounds down, towards minus infinity
+ *   a / b  is (int64_t(a) << 16) / b, so it rounds towards zero
+ *
+ * Anything that would not fit saturates to the largest or smallest value instead
+ * of wrapping around, as the Cortex-M SSAT instruction does. Dividing by zero
+ * gives the largest value with the sign of the dividend.
+ *
+ * Sines and cosines come from a table indexed by a binary Angle (see angle.h), with
+ * integer interpolation, so they are the same on every machine. Square roots are
+ * done bit by bit on integers.
+ *
+ * Code that should work with any of the number types takes a template parameter
+ * T and does anything that is not + - * / or a comparison through Numeric<T>:
+ *
+ *   template <typename T>
+ *   void step(T& x, T& y, Angle heading, T distance) {
+ *     x += Numeric<T>::cos(heading) * distance;
+ *     y += Numeric<T>::sin(heading) * distance;
+ *   }
+ *
+ * Converting from float is explicit so that a stray float constant cannot
+ * quietly bring floating point into the fixed point sums. Use Numeric<T>::from()
+ * at the boundary, where settings and geometry come in.
+ */
+
+template <int FRACTION_BITS>
+class Fixed {
+  static_assert(FRACTION_BITS > 0 && FRACTION_BITS < 31, "a Fixed needs some integer and some fraction bits");
+
+ public:
+  static constexpr int FRACTION = FRACTION_BITS;
+  static constexpr int32_t ONE = int32_t(1) << FRACTION_BITS;
+
+  constexpr Fixed() = default;
+  constexpr Fixed(int value) : m_raw(saturate(int64_t(value) * ONE)) {}
+  /// rounded to the nearest step
+  constexpr explicit Fixed(float value) : Fixed(double(value)) {}
+  constexpr explicit Fixed(double value) : m_raw(saturate(value, value * ONE)) {}
+
+  static constexpr Fixed from_raw(int32_t raw) {
+    Fixed f;
+    f.m_raw = raw;
+    return f;
+  }
+  static constexpr Fixed max() { return from_raw(std::numeric_limits<int32_t>::max()); }
+  static constexpr Fixed lowest() { return from_raw(std::numeric_limits<int32_t>::min()); }
+  /// the smallest step
+  static constexpr Fixed epsilon() { return from_raw(1); }
+
+  [[nodiscard]] constexpr int32_t raw() const { return m_raw; }
+  constexpr explicit operator float() const { return float(m_raw) / float(ONE); }
+  constexpr explicit operator double() const { return double(m_raw) / double(ONE); }
+  /// rounded down
+  constexpr explicit operator int() const { return m_raw >> FRACTION_BITS; }
+
+  constexpr Fixed operator-() const { return from_raw(saturate(-int64_t(m_raw))); }
+  constexpr Fixed& operator+=(Fixed b) { return *this = *this + b; }
+  constexpr Fixed& operator-=(Fixed b) { return *this = *this - b; }
+  constexpr Fixed& operator*=(Fixed b) { return *this = *this * b; }
+  constexpr Fixed& operator/=(Fixed b) { return *this = *this / b; }
+
+  friend constexpr Fixed operator+(Fixed a, Fixed b) { return from_raw(saturate(int64_t(a.m_raw) + b.m_raw)); }
+  friend constexpr Fixed operator-(Fixed a, Fixed b) { return from_raw(saturate(int64_t(a.m_raw) - b.m_raw)); }
+  friend constexpr Fixed operator*(Fixed a, Fixed b) { return from_raw(saturate((int64_t(a.m_raw) * b.m_raw) >> FRACTION_BITS)); }
+  friend constexpr Fixed operator/(Fixed a, Fixed b) {
+    if (b.m_raw == 0) {
+      return a.m_raw < 0 ? lowest() : max();
+    }
+    return from_raw(saturate(int64_t(a.m_raw) * ONE / b.m_raw));
+  }
+  friend constexpr auto operator<=>(Fixed a, Fixed b) = default;
+
+ private:
+  static constexpr int32_t saturate(int64_t v) {
+    if (v > std::numeric_limits<int32_t>::max()) {
+      return std::numeric_limits<int32_t>::max();
+    }
+    if (v < std::numeric_limits<int32_t>::min()) {
+      return std::numeric_limits<int32_t>::min();
+    }
+    return int32_t(v);
+  }
+
+  /// NaN is taken as zero
+  static constexpr int32_t saturate(double value, double scaled) {
+    if (!(value <= value)) {  // only NaN fails this
+      return 0;
+    }
+    if (scaled >= 2147483647.0) {
+      return std::numeric_limits<int32_t>::max();
+    }
+    if (scaled <= -2147483648.0) {
+      return std::numeric_limits<int32_t>::min();
+    }
+    return int32_t(int64_t(scaled + (scaled < 0 ? -0.5 : 0.5)));
+  }
+
+  int32_t m_raw = 0;
+};
+
+using Q16_16 = Fixed<16>;
+
+namespace fixed_detail {
+
+/// a whole turn of sines as Q2.30 integers, the first repeated at the end
+constexpr std::array<int32_t, trig::detail::TABLE_SIZE + 1> make_sine_table() {
+  std::array<int32_t, trig::detail::TABLE_SIZE + 1> table{};
+  for (int i = 0; i <= trig::detail::TABLE_SIZE; i++) {
+    const double s = trig::detail::table_sin(i);
+    table[i] = int32_t(int64_t(s * 1073741824.0 + (s < 0 ? -0.5 : 0.5)));
+  }
+  return table;
+}
+
+inline constexpr std::array<int32_t, trig::detail::TABLE_SIZE + 1> SINE_TABLE = make_sine_table();
+
+/// the sine of a binary angle as Q2.30, with integer interpolation between the table entries
+constexpr int32_t sin_q30(uint32_t bits) {
+  constexpr int FRACTION_BITS = 32 - trig::detail::TABLE_BITS;
+  const uint32_t i = bits >> FRACTION_BITS;
+  const int64_t t = bits & ((1u << FRACTION_BITS) - 1);
+  const int64_t a = SINE_TABLE[i];
+  return int32_t(a + (((SINE_TABLE[i + 1] - a) * t) >> FRACTION_BITS));
+}
+
+/// the integer square root, rounded down
+constexpr uint64_t isqrt(uint64_t v) {
+  uint64_t result = 0;
+  uint64_t bit = uint64_t(1) << 62;
+  while (bit > v) {
+    bit >>= 2;
+  }
+  while (bit != 0) {
+    if (v >= result + bit) {
+      v -= result + bit;
+      result = (result >> 1) + bit;
+    } else {
+      result >>= 1;
+    }
+    bit >>= 2;
+  }
+  return result;
+}
+
+}  // namespace fixed_detail
+
+/***
+ * The numeric policy: everything generic code needs beyond the arithmetic
+ * operators. This version is for float and double, and for integer types where
+ * only the limits make sense.
+ */
+template <typename T>
+struct Numeric {
+  static constexpr T from(float v) { return T(v); }
+  static constexpr float to_float(T v) { return float(v); }
+  static constexpr T max() { return std::numeric_limits<T>::max(); }
+  static constexpr T lowest() { return std::numeric_limits<T>::lowest(); }
+  static T sqrt(T v) { return std::sqrt(v); }
+  static T round(T v) { return std::round(v); }
+  static T sin(Angle a) {
+    if constexpr (std::is_same_v<T, float>) {
+      return a.sin();  // the same table that the rest of the simulation uses
+    } else {
+      return std::sin(T(int32_t(a.bits())) * T(2 * trig::PI_D / Angle::UNITS_PER_TURN));
+    }
+  }
+  static T cos(Angle a) {
+    if constexpr (std::is_same_v<T, float>) {
+      return a.cos();
+    } else {
+      return std::cos(T(int32_t(a.bits())) * T(2 * trig::PI_D / Angle::UNITS_PER_TURN));
+    }
+  }
+};
+
+template <int F>
+struct Numeric<Fixed<F>> {
+  using T = Fixed<F>;
+  static constexpr T from(float v) { return T(v); }
+  static constexpr float to_float(T v) { return float(v); }
+  static constexpr T max() { return T::max(); }
+  static constexpr T lowest() { return T::lowest(); }
+  /// zero for anything negative
+  static constexpr T sqrt(T v) {
+    if (v.raw() <= 0) {
+      return T();
+    }
+    return T::from_raw(int32_t(fixed_detail::isqrt(uint64_t(v.raw()) << F)));
+  }
+  /// to the nearest whole number, halves away from zero
+  static constexpr T round(T v) {
+    constexpr int32_t half = T::ONE / 2;
+    if (v.raw() < 0) {
+      return -round(-v);
+    }
+    if (v.raw() > T::max().raw() - half) {
+      return T::from_raw(T::max().raw() & ~(T::ONE - 1));
+    }
+    return T::from_raw((v.raw() + half) & ~(T::ONE - 1));
+  }
+  static constexpr T sin(Angle a) { return T::from_raw(fixed_detail::sin_q30(a.bits()) >> (30 - F)); }
+  static constexpr T cos(Angle a) { return T::from_raw(fixed_detail::sin_q30(a.bits() + (1u << 30)) >> (30 - F)); }
+};
+
+#endif  // IMGUI_SFML_STARTER_FIXED_POINT_H
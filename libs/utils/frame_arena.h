@@ -0,0 +1,169 @@
+#ifndef IMGUI_SFML_STARTER_FRAME_ARENA_H
+#define IMGUI_SFML_STARTER_FRAME_ARENA_H
+
+#include <algorithm>
+#include <bit>
+#include <cstdarg>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <memory_resource>
+#include <string>
+#include <vector>
+
+/***
+ * Memory for things that only live for one frame: the HUD text, scratch vertices,
+ * lists of things found this frame.
+ *
+ * The arena is one block of memory and an offset into it. Allocating moves the
+ * offset along, freeing does nothing, and reset() puts the offset back to the start
+ * once the frame is done. That is a handful of instructions against a trip through
+ * the heap for every string and vector.
+ *
+ * It is a std::pmr::memory_resource, so the standard containers can use it as they are:
+ *
+ *     FrameArena arena;
+ *     while (window.isOpen()) {
+ *       arena.reset();
+ *       std::pmr::string txt = arena.string();
+ *       appendf(txt, "Mouse: %d,%d\n", mouse.x, mouse.y);
+ *       std::pmr::vector<sf::Vertex> quads = arena.vector<sf::Vertex>(4 * rects.size());
+ *       ...
+ *       window.display();
+ *     }
+ *
+ * Nothing allocated from the arena may be kept past reset(). Declare the containers
+ * inside the loop so that they are destroyed at the end of each pass, after
+ * window.display(), and reset the arena at the top of the loop.
+ *
+ * If a frame needs more than the block holds, the rest comes from the upstream
+ * resource (the heap by default) and reset() swaps the block for one big enough for
+ * that frame. After a frame or two of warming up nothing more comes from the heap.
+ * heap_allocations() counts every trip upstream so that can be checked.
+ *
+ * An arena belongs to one thread. Give each thread its own.
+ */
+class FrameArena : public std::pmr::memory_resource {
+ public:
+  explicit FrameArena(size_t capacity = 64 * 1024, std::pmr::memory_resource* upstream = std::pmr::new_delete_resource())
+      : m_upstream(upstream), m_capacity(capacity) {
+    m_block = static_cast<std::byte*>(m_upstream->allocate(m_capacity, alignof(std::max_align_t)));
+    m_heap_allocations++;
+  }
+
+  ~FrameArena() override {
+    release_overflow();
+    m_upstream->deallocate(m_block, m_capacity, alignof(std::max_align_t));
+  }
+
+  FrameArena(const FrameArena&) = delete;
+  FrameArena& operator=(const FrameArena&) = delete;
+
+  /// call once a frame, before anything is allocated for it. Everything allocated since the last reset is gone
+  void reset() {
+    m_peak = std::max(m_peak, m_frame_peak);
+    if (m_overflow != nullptr) {
+      release_overflow();
+      /// grow so that a frame like this one fits in the block next time
+      m_upstream->deallocate(m_block, m_capacity, alignof(std::max_align_t));
+      m_capacity = std::bit_ceil(m_frame_peak);
+      m_block = static_cast<std::byte*>(m_upstream->allocate(m_capacity, alignof(std::max_align_t)));
+      m_heap_allocations++;
+    }
+    m_offset = 0;
+    m_overflow_bytes = 0;
+    m_frame_peak = 0;
+  }
+
+  std::pmr::string string() { return std::pmr::string(this); }
+
+  template <typename T>
+  std::pmr::vector<T> vector(size_t size = 0) {
+    return std::pmr::vector<T>(size, this);
+  }
+
+  /// bytes handed out so far this frame
+  [[nodiscard]] size_t used() const { return m_offset + m_overflow_bytes; }
+  [[nodiscard]] size_t capacity() const { return m_capacity; }
+  /// the most any frame has used
+  [[nodiscard]] size_t peak() const { return std::max(m_peak, m_frame_peak); }
+  /// blocks taken from upstream since the arena was made, including the first
+  [[nodiscard]] uint64_t heap_allocations() const { return m_heap_allocations; }
+
+ private:
+  /// memory taken from upstream when the block is full, freed at the next reset
+  struct Overflow {
+    Overflow* next;
+    size_t size;
+    size_t alignment;
+  };
+
+  static size_t align_up(size_t n, size_t alignment) { return (n + alignment - 1) & ~(alignment - 1); }
+
+  void* do_allocate(size_t bytes, size_t alignment) override {
+    const size_t start = align_up(m_offset, alignment);
+    if (start + bytes <= m_capacity) {
+      m_offset = start + bytes;
+      m_frame_peak = std::max(m_frame_peak, used());
+      return m_block + start;
+    }
+    /// the header goes in front, far enough back that the memory after it is still aligned
+    const size_t align = std::max(alignment, alignof(Overflow));
+    const size_t header = align_up(sizeof(Overflow), align);
+    auto* memory = static_cast<std::byte*>(m_upstream->allocate(header + bytes, align));
+    m_heap_allocations++;
+    auto* overflow = reinterpret_cast<Overflow*>(memory + header - sizeof(Overflow));
+    *overflow = {m_overflow, header + bytes, align};
+    m_overflow = overflow;
+    m_overflow_bytes += bytes + alignment;
+    m_frame_peak = std::max(m_frame_peak, used());
+    return memory + header;
+  }
+
+  /// only the last allocation is given back, which is what a growing string or vector frees
+  void do_deallocate(void* p, size_t bytes, size_t) override {
+    auto* bp = static_cast<std::byte*>(p);
+    if (bp + bytes == m_block + m_offset) {
+      m_offset = size_t(bp - m_block);
+    }
+  }
+
+  bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+
+  void release_overflow() {
+    while (m_overflow != nullptr) {
+      Overflow o = *m_overflow;
+      auto* memory = reinterpret_cast<std::byte*>(m_overflow) + sizeof(Overflow) - align_up(sizeof(Overflow), o.alignment);
+      m_upstream->deallocate(memory, o.size, o.alignment);
+      m_overflow = o.next;
+    }
+  }
+
+  std::pmr::memory_resource* m_upstream;
+  std::byte* m_block = nullptr;
+  size_t m_capacity;
+  size_t m_offset = 0;
+  Overflow* m_overflow = nullptr;
+  size_t m_overflow_bytes = 0;
+  size_t m_frame_peak = 0;
+  size_t m_peak = 0;
+  uint64_t m_heap_allocations = 0;
+};
+
+/// printf onto the end of a string. With an arena string there is no std::string temporary to allocate
+inline void appendf(std::pmr::string& s, const char* format, ...) {
+  va_list args;
+  va_start(args, format);
+  va_list copy;
+  va_copy(copy, args);
+  const int n = std::vsnprintf(nullptr, 0, format, copy);
+  va_end(copy);
+  if (n > 0) {
+    const size_t end = s.size();
+    s.resize(end + size_t(n));
+    std::vsnprintf(s.data() + end, size_t(n) + 1, format, args);
+  }
+  va_end(args);
+}
+
+#endif  // IMGUI_SFML_STARTER_FRAME_ARENA_H
@@ -0,0 +1,170 @@
+#ifndef IMGUI_SFML_STARTER_FRAME_PACER_H
+#define IMGUI_SFML_STARTER_FRAME_PACER_H
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+/***
+ * Start frames at an even rate, to well under a millisecond.
+ *
+ * setFramerateLimit() sleeps for what is left of the frame inside display(). The
+ * operating system wakes a sleeping thread late, by anything from a few tens of
+ * microseconds on Linux to a whole timer tick of 1-16ms on Windows, so the frames
+ * come out uneven. At 144Hz a frame is only 6.9ms and that shows as judder.
+ *
+ * FramePacer sleeps until a little before the frame is due and spins for the rest.
+ * How early it wakes is learnt as it goes: each frame it measures how late the
+ * sleep really finished and keeps a running mean and spread of that. It wakes the
+ * mean plus twice the spread early, so only the odd very late wake up makes a
+ * frame late. On a machine with coarse timers it learns to wake earlier and spin
+ * longer. The spin costs some CPU time, which spin_ms() reports.
+ *
+ * Call wait() at the top of the loop, before the events are read:
+ *
+ *     FramePacer pacer(144);
+ *     while (window.isOpen()) {
+ *       pacer.wait();
+ *       ... events, update, draw
+ *       window.display();
+ *     }
+ *
+ * That also cuts the time from input to display. setFramerateLimit() reads the
+ * input, draws and then sleeps before showing the frame, so what is shown is a
+ * frame old. With the wait first, the input is read just before the frame is drawn.
+ *
+ * Switch off VSync and the frame rate limit when using the pacer, or they will
+ * fight over when the frame is shown.
+ */
+class FramePacer {
+ public:
+  using clock = std::chrono::steady_clock;
+
+  explicit FramePacer(double rate = 60.0) { set_rate(rate); }
+
+  void set_rate(double rate) { m_period = std::chrono::duration_cast<clock::duration>(std::chrono::duration<double>(1.0 / rate)); }
+  [[nodiscard]] double rate() const { return 1.0 / std::chrono::duration<double>(m_period).count(); }
+
+  /// without the spin the pacer only sleeps, which is as uneven as setFramerateLimit()
+  void set_spin(bool spin) { m_spin = spin; }
+  [[nodiscard]] bool spin() const { return m_spin; }
+
+  /// wait until the next frame is due
+  void wait() {
+    auto now = clock::now();
+    m_next += m_period;
+    if (now > m_next + m_period) {
+      /// more than a frame behind. Start again from now rather than rush to catch up
+      m_next = now;
+      m_late++;
+    } else if (now > m_next) {
+      m_late++;
+    }
+    const auto margin = m_spin ? std::chrono::duration_cast<clock::duration>(std::chrono::duration<double, std::milli>(sleep_margin_ms())) : clock::duration::zero();
+    const auto wake = m_next - margin;
+    if (now < wake) {
+      std::this_thread::sleep_until(wake);
+      now = clock::now();
+      learn(std::chrono::duration<double, std::milli>(now - wake).count());
+    }
+    const auto spin_start = now;
+    while (m_spin && now < m_next) {
+      now = clock::now();
+    }
+    m_spin_ms = std::chrono::duration<double, std::milli>(now - spin_start).count();
+  }
+
+  /// how early the sleep ends, to allow for waking late
+  [[nodiscard]] double sleep_margin_ms() const { return std::clamp(m_oversleep_mean + 2 * std::sqrt(m_oversleep_variance), 0.05, 1000.0 / rate()); }
+  /// the average time the sleep overran by
+  [[nodiscard]] double oversleep_ms() const { return m_oversleep_mean; }
+  /// the time spent spinning in the last wait()
+  [[nodiscard]] double spin_ms() const { return m_spin_ms; }
+  /// frames that were already due when wait() was called
+  [[nodiscard]] uint64_t late_frames() const { return m_late; }
+
+ private:
+  /// exponentially weighted mean and variance of the oversleep, so the estimate follows changes in load
+  void learn(double oversleep_ms) {
+    const double weight = 0.05;
+    const double difference = oversleep_ms - m_oversleep_mean;
+    m_oversleep_mean += weight * difference;
+    m_oversleep_variance = (1 - weight) * (m_oversleep_variance + weight * difference * difference);
+  }
+
+  clock::duration m_period{};
+  clock::time_point m_next = clock::now();
+  bool m_spin = true;
+  double m_oversleep_mean = 1.0;  // a guess to start from. It settles within a second or so
+  double m_oversleep_variance = 0.0;
+  double m_spin_ms = 0;
+  uint64_t m_late = 0;
+};
+
+/***
+ * The last few hundred frame times, or any other times, and their percentiles.
+ * p99 is the time that 99 frames in 100 beat, which shows the occasional long
+ * frame that an average hides.
+ */
+class FrameStats {
+ public:
+  struct Summary {
+    float p50 = 0;
+    float p95 = 0;
+    float p99 = 0;
+    float max = 0;
+    float mean = 0;
+  };
+
+  explicit FrameStats(size_t capacity = 1000) : m_capacity(capacity) { m_values.reserve(capacity); }
+
+  void add(float ms) {
+    if (m_values.size() < m_capacity) {
+      m_values.push_back(ms);
+    } else {
+      m_values[m_next] = ms;
+      m_next = (m_next + 1) % m_capacity;
+    }
+  }
+
+  void clear() {
+    m_values.clear();
+    m_next = 0;
+  }
+
+  [[nodiscard]] Summary summary() const {
+    Summary s;
+    if (m_values.empty()) {
+      return s;
+    }
+    m_sorted = m_values;
+    std::sort(m_sorted.begin(), m_sorted.end());
+    auto at = [&](float p) { return m_sorted[std::min(m_sorted.size() - 1, size_t(p * float(m_sorted.size())))]; };
+    s.p50 = at(0.50f);
+    s.p95 = at(0.95f);
+    s.p99 = at(0.99f);
+    s.max = m_sorted.back();
+    double sum = 0;
+    for (float v : m_sorted) {
+      sum += v;
+    }
+    s.mean = float(sum / double(m_sorted.size()));
+    return s;
+  }
+
+  /// for ImPlot::PlotLine(label, data(), size(), 1, 0, 0, offset()), which plots them oldest first
+  [[nodiscard]] const float* data() const { return m_values.data(); }
+  [[nodiscard]] int size() const { return int(m_values.size()); }
+  [[nodiscard]] int offset() const { return int(m_next); }
+
+ private:
+  size_t m_capacity;
+  std::vector<float> m_values;
+  size_t m_next = 0;  // the oldest, once the buffer is full
+  mutable std::vector<float> m_sorted;
+};
+
+#endif  // IMGUI_SFML_STARTER_FRAME_PACER_H
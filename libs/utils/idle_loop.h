@@ -0,0 +1,140 @@
+#ifndef IMGUI_SFML_STARTER_IDLE_LOOP_H
+#define IMGUI_SFML_STARTER_IDLE_LOOP_H
+
+#include <SFML/System/Clock.hpp>
+#include <SFML/System/Sleep.hpp>
+#include <SFML/Window/Event.hpp>
+#include <SFML/Window/Window.hpp>
+#include <algorithm>
+#include <cstdint>
+
+/***
+ * Only redraw the window when something has changed.
+ *
+ * A viewer that redraws at 60 frames a second keeps a CPU core and the GPU busy
+ * even when nobody is touching it and nothing is moving. IdleLoop takes over the
+ * event polling. While there is nothing to draw it waits for the next event instead
+ * of returning at once, so an idle window costs next to nothing.
+ *
+ *     IdleLoop loop(window);
+ *     while (window.isOpen()) {
+ *       sf::Event event{};
+ *       while (loop.poll_event(event)) {   // waits here when there is nothing to draw
+ *         ...
+ *       }
+ *       if (simulation_running) {
+ *         loop.request_redraw();           // and the next pass will not wait
+ *       }
+ *       ... update with loop.elapsed() and draw as usual
+ *     }
+ *
+ * A frame is drawn
+ *
+ *   - after any event, and for a few frames more so that ImGui can catch up with
+ *     hovering, popups and the like, which take it a frame or two to settle
+ *   - after request_redraw(), for something that changed without an event:
+ *     a running simulation, a key held down, tiles still loading
+ *   - when the timeout runs out, for anything that changes slowly on its own, such
+ *     as a clock or a blinking cursor. With no timeout it waits for ever
+ *
+ * SFML 2 cannot wait for an event with a time limit. Its own waitEvent() checks
+ * for events and sleeps 10ms at a time, so a wait with a timeout does the same.
+ *
+ * frames_skipped() counts the frames that would have been drawn at the frame rate
+ * given to the constructor but were not. set_enabled(false) draws every frame, as
+ * if the loop were not there, for comparison.
+ */
+class IdleLoop {
+ public:
+  /// frame_rate should match the window's frame rate limit or the monitor, for counting the skipped frames
+  explicit IdleLoop(sf::Window& window, float frame_rate = 60.0f) : m_window(window), m_frame_time(sf::seconds(1.0f / frame_rate)) {}
+
+  /// as sf::Window::pollEvent(). The first call in each pass round the loop waits if there is nothing to draw
+  bool poll_event(sf::Event& event) {
+    if (m_first_poll) {
+      m_first_poll = false;
+      if (m_enabled && m_redraw_frames == 0 && wait_event(event)) {
+        got_event();
+        return true;
+      }
+    }
+    if (m_window.pollEvent(event)) {
+      got_event();
+      return true;
+    }
+    /// the events are done, so this pass will draw a frame
+    m_first_poll = true;
+    m_redraw_frames = std::max(0, m_redraw_frames - 1);
+    m_frames_drawn++;
+    return false;
+  }
+
+  /// draw at least this many more frames without waiting
+  void request_redraw(int frames = 1) { m_redraw_frames = std::max(m_redraw_frames, frames); }
+
+  /// the longest to wait with nothing happening. Zero waits until there is an event
+  void set_timeout(sf::Time timeout) { m_timeout = timeout; }
+
+  void set_enabled(bool enabled) { m_enabled = enabled; }
+  [[nodiscard]] bool enabled() const { return m_enabled; }
+
+  /// the time since the last call, less any time spent waiting. Use it in place of a clock restart for the frame time
+  sf::Time elapsed() {
+    const sf::Time t = m_frame_clock.restart() - m_waited;
+    m_waited = sf::Time::Zero;
+    return std::max(t, sf::Time::Zero);
+  }
+
+  [[nodiscard]] uint64_t frames_drawn() const { return m_frames_drawn; }
+  [[nodiscard]] uint64_t frames_skipped() const { return m_frames_skipped; }
+  /// the fraction of the time since the loop was made that was spent waiting
+  [[nodiscard]] float idle_fraction() const {
+    const float total = m_up_time.getElapsedTime().asSeconds();
+    return total > 0 ? m_total_waited.asSeconds() / total : 0.0f;
+  }
+
+  /// frames drawn after each event, so that ImGui settles
+  static constexpr int SETTLE_FRAMES = 3;
+
+ private:
+  void got_event() { m_redraw_frames = std::max(m_redraw_frames, SETTLE_FRAMES); }
+
+  /// true if an event came before the timeout
+  bool wait_event(sf::Event& event) {
+    sf::Clock clock;
+    bool got = false;
+    if (m_timeout == sf::Time::Zero) {
+      got = m_window.waitEvent(event);
+    } else {
+      got = m_window.pollEvent(event);
+      while (!got && clock.getElapsedTime() < m_timeout) {
+        sf::sleep(std::min(sf::milliseconds(10), m_timeout - clock.getElapsedTime()));
+        got = m_window.pollEvent(event);
+      }
+    }
+    const sf::Time waited = clock.getElapsedTime();
+    m_waited += waited;
+    m_total_waited += waited;
+    m_skipped_time += waited;
+    const auto whole = int64_t(m_skipped_time / m_frame_time);
+    m_frames_skipped += uint64_t(whole);
+    m_skipped_time -= m_frame_time * float(whole);
+    return got;
+  }
+
+  sf::Window& m_window;
+  sf::Time m_frame_time;
+  sf::Time m_timeout = sf::Time::Zero;
+  bool m_enabled = true;
+  bool m_first_poll = true;
+  int m_redraw_frames = SETTLE_FRAMES;  // draw the first few frames whatever happens
+  sf::Clock m_frame_clock;
+  sf::Clock m_up_time;
+  sf::Time m_waited = sf::Time::Zero;
+  sf::Time m_total_waited = sf::Time::Zero;
+  sf::Time m_skipped_time = sf::Time::Zero;  // waiting not yet counted as a whole frame
+  uint64_t m_frames_drawn = 0;
+  uint64_t m_frames_skipped = 0;
+};
+
+#endif  // IMGUI_SFML_STARTER_IDLE_LOOP_H
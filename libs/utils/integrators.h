@@ -0,0 +1,287 @@
+#ifndef IMGUI_SFML_STARTER_INTEGRATORS_H
+#define IMGUI_SFML_STARTER_INTEGRATORS_H
+
+#include <cstddef>
+#include <vector>
+
+/***
+ * Numerical integrators for a batch of particles moving in 2D.
+ *
+ * Every integrator advances position and velocity by one time step using an
+ * acceleration function. They differ in how much they trust the accelerations:
+ *
+ *   Euler              - x += v.dt then v += a.dt. Everything uses the values from the
+ *                        start of the step. Cheap, but energy grows with every step. A
+ *                        spring will oscillate ever more wildly unless dt is tiny.
+ *   SemiImplicitEuler  - v += a.dt then x += v.dt. Just swapping the order keeps the
+ *                        energy bounded. Vehicle::update() already works this way.
+ *   VelocityVerlet     - the position uses the old acceleration as well as the velocity,
+ *                        and the velocity uses the average of the old and new
+ *                        accelerations. Second order accurate and the energy stays
+ *                        bounded. It costs one acceleration call per step,
+ *                        the same as Euler.
+ *   RK4                - the classic fourth order Runge-Kutta. Very accurate for
+ *                        smooth forces but it calls the acceleration function four times
+ *                        per step, and the energy still drifts slowly over long runs.
+ *
+ * The particle state is a structure of arrays, with x, y, vx, vy, ax and ay each in
+ * their own vector. Every integration loop is then a plain loop over floats that the
+ * compiler can vectorise.
+ *
+ * The acceleration function is called as
+ *
+ *   accel(const ParticleView& state, float* ax, float* ay)
+ *
+ * and must fill ax and ay for all state.count particles. For RK4 the state it sees
+ * is a trial state, not the one stored in the ParticleState.
+ *
+ * Velocity Verlet needs the acceleration at the start of the step. That is the one
+ * left in ax,ay by the previous step, so call reset() after changing the state
+ * by hand. The next step will then work it out afresh.
+ */
+
+enum class Integrator { Euler, SemiImplicitEuler, VelocityVerlet, RK4 };
+
+inline const char* integrator_name(Integrator method) {
+  switch (method) {
+    case Integrator::Euler:
+      return "Euler";
+    case Integrator::SemiImplicitEuler:
+      return "Semi-implicit Euler";
+    case Integrator::VelocityVerlet:
+      return "Velocity Verlet";
+    case Integrator::RK4:
+      return "RK4";
+  }
+  return "";
+}
+
+/// the number of times each integrator calls the acceleration function per step
+inline int integrator_evaluations(Integrator method) { return method == Integrator::RK4 ? 4 : 1; }
+
+struct ParticleView {
+  const float* x;
+  const float* y;
+  const float* vx;
+  const float* vy;
+  size_t count;
+};
+
+struct ParticleState {
+  std::vector<float> x;
+  std::vector<float> y;
+  std::vector<float> vx;
+  std::vector<float> vy;
+  std::vector<float> ax;  // the acceleration from the last evaluation
+  std::vector<float> ay;
+
+  [[nodiscard]] size_t size() const { return x.size(); }
+
+  void resize(size_t n) {
+    for (auto* v : {&x, &y, &vx, &vy, &ax, &ay}) {
+      v->resize(n, 0.0f);
+    }
+  }
+
+  void add(float px, float py, float pvx = 0, float pvy = 0) {
+    x.push_back(px);
+    y.push_back(py);
+    vx.push_back(pvx);
+    vy.push_back(pvy);
+    ax.push_back(0);
+    ay.push_back(0);
+  }
+
+  [[nodiscard]] ParticleView view() const { return {x.data(), y.data(), vx.data(), vy.data(), x.size()}; }
+};
+
+class ParticleIntegrator {
+ public:
+  explicit ParticleIntegrator(Integrator method = Integrator::VelocityVerlet) : m_method(method) {}
+
+  void set_method(Integrator method) {
+    m_method = method;
+    reset();
+  }
+  [[nodiscard]] Integrator method() const { return m_method; }
+
+  /// the stored accelerations are out of date. Work them out again on the next step
+  void reset() { m_primed = false; }
+
+  template <class AccelFn>
+  void step(ParticleState& s, float dt, AccelFn&& accel) {
+    switch (m_method) {
+      case Integrator::Euler:
+        step_euler(s, dt, accel);
+        break;
+      case Integrator::SemiImplicitEuler:
+        step_semi_implicit(s, dt, accel);
+        break;
+      case Integrator::VelocityVerlet:
+        step_verlet(s, dt, accel);
+        break;
+      case Integrator::RK4:
+        step_rk4(s, dt, accel);
+        break;
+    }
+  }
+
+ private:
+  template <class AccelFn>
+  void step_euler(ParticleState& s, float dt, AccelFn& accel) {
+    const size_t n = s.size();
+    float* x = s.x.data();
+    float* y = s.y.data();
+    float* vx = s.vx.data();
+    float* vy = s.vy.data();
+    float* ax = s.ax.data();
+    float* ay = s.ay.data();
+    accel(s.view(), ax, ay);
+    for (size_t i = 0; i < n; i++) {
+      x[i] += vx[i] * dt;
+      y[i] += vy[i] * dt;
+      vx[i] += ax[i] * dt;
+      vy[i] += ay[i] * dt;
+    }
+    m_primed = false;
+  }
+
+  template <class AccelFn>
+  void step_semi_implicit(ParticleState& s, float dt, AccelFn& accel) {
+    const size_t n = s.size();
+    float* x = s.x.data();
+    float* y = s.y.data();
+    float* vx = s.vx.data();
+    float* vy = s.vy.data();
+    float* ax = s.ax.data();
+    float* ay = s.ay.data();
+    accel(s.view(), ax, ay);
+    for (size_t i = 0; i < n; i++) {
+      vx[i] += ax[i] * dt;
+      vy[i] += ay[i] * dt;
+      x[i] += vx[i] * dt;
+      y[i] += vy[i] * dt;
+    }
+    m_primed = false;
+  }
+
+  template <class AccelFn>
+  void step_verlet(ParticleState& s, float dt, AccelFn& accel) {
+    const size_t n = s.size();
+    if (!m_primed || m_primed_size != n) {
+      accel(s.view(), s.ax.data(), s.ay.data());
+    }
+    float* x = s.x.data();
+    float* y = s.y.data();
+    float* vx = s.vx.data();
+    float* vy = s.vy.data();
+    float* ax = s.ax.data();
+    float* ay = s.ay.data();
+    const float half_dt = 0.5f * dt;
+    /// a half kick and a drift, so that vx,vy hold the velocity at the middle of the step
+    for (size_t i = 0; i < n; i++) {
+      vx[i] += ax[i] * half_dt;
+      vy[i] += ay[i] * half_dt;
+      x[i] += vx[i] * dt;
+      y[i] += vy[i] * dt;
+    }
+    /// then the second half kick with the acceleration at the new positions
+    accel(s.view(), ax, ay);
+    for (size_t i = 0; i < n; i++) {
+      vx[i] += ax[i] * half_dt;
+      vy[i] += ay[i] * half_dt;
+    }
+    m_primed = true;
+    m_primed_size = n;
+  }
+
+  /***
+   * RK4 treats position and velocity as one state whose rate of change is
+   * (velocity, acceleration). Each of the four stages makes a trial state from
+   * the previous stage's rates, and the weighted sum of the four sets of rates
+   * is added on at the end.
+   */
+  template <class AccelFn>
+  void step_rk4(ParticleState& s, float dt, AccelFn& accel) {
+    const size_t n = s.size();
+    resize_scratch(n);
+    float* x = s.x.data();
+    float* y = s.y.data();
+    float* vx = s.vx.data();
+    float* vy = s.vy.data();
+    float* kx = m_kx.data();  // the rates from the latest stage
+    float* ky = m_ky.data();
+    float* kvx = m_kvx.data();
+    float* kvy = m_kvy.data();
+    float* sum_x = m_sum_x.data();  // the weighted sums of the rates
+    float* sum_y = m_sum_y.data();
+    float* sum_vx = m_sum_vx.data();
+    float* sum_vy = m_sum_vy.data();
+    float* tx = m_tx.data();  // the trial state
+    float* ty = m_ty.data();
+    float* tvx = m_tvx.data();
+    float* tvy = m_tvy.data();
+    const ParticleView trial{tx, ty, tvx, tvy, n};
+
+    /// stage 1 - the rates at the start
+    accel(s.view(), kvx, kvy);
+    for (size_t i = 0; i < n; i++) {
+      kx[i] = vx[i];
+      ky[i] = vy[i];
+      sum_x[i] = kx[i];
+      sum_y[i] = ky[i];
+      sum_vx[i] = kvx[i];
+      sum_vy[i] = kvy[i];
+    }
+    /// stages 2 and 3 at the midpoint, 4 at the end
+    const float stage_dt[3] = {0.5f * dt, 0.5f * dt, dt};
+    const float stage_weight[3] = {2.0f, 2.0f, 1.0f};
+    for (int stage = 0; stage < 3; stage++) {
+      const float h = stage_dt[stage];
+      const float w = stage_weight[stage];
+      for (size_t i = 0; i < n; i++) {
+        tx[i] = x[i] + kx[i] * h;
+        ty[i] = y[i] + ky[i] * h;
+        tvx[i] = vx[i] + kvx[i] * h;
+        tvy[i] = vy[i] + kvy[i] * h;
+      }
+      accel(trial, kvx, kvy);
+      for (size_t i = 0; i < n; i++) {
+        kx[i] = tvx[i];
+        ky[i] = tvy[i];
+        sum_x[i] += w * kx[i];
+        sum_y[i] += w * ky[i];
+        sum_vx[i] += w * kvx[i];
+        sum_vy[i] += w * kvy[i];
+      }
+    }
+    const float sixth_dt = dt / 6.0f;
+    for (size_t i = 0; i < n; i++) {
+      x[i] += sum_x[i] * sixth_dt;
+      y[i] += sum_y[i] * sixth_dt;
+      vx[i] += sum_vx[i] * sixth_dt;
+      vy[i] += sum_vy[i] * sixth_dt;
+    }
+    /// leave the average acceleration behind in case anyone wants to draw it
+    for (size_t i = 0; i < n; i++) {
+      s.ax[i] = sum_vx[i] / 6.0f;
+      s.ay[i] = sum_vy[i] / 6.0f;
+    }
+    m_primed = false;
+  }
+
+  void resize_scratch(size_t n) {
+    for (auto* v : {&m_kx, &m_ky, &m_kvx, &m_kvy, &m_sum_x, &m_sum_y, &m_sum_vx, &m_sum_vy, &m_tx, &m_ty, &m_tvx, &m_tvy}) {
+      v->resize(n);
+    }
+  }
+
+  Integrator m_method;
+  bool m_primed = false;
+  size_t m_primed_size = 0;
+  std::vector<float> m_kx, m_ky, m_kvx, m_kvy;
+  std::vector<float> m_sum_x, m_sum_y, m_sum_vx, m_sum_vy;
+  std::vector<float> m_tx, m_ty, m_tvx, m_tvy;
+};
+
+#endif  // IMGUI_SFML_STARTER_INTEGRATORS_H
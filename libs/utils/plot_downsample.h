@@ -0,0 +1,254 @@
+#ifndef IMGUI_SFML_STARTER_PLOT_DOWNSAMPLE_H
+#define IMGUI_SFML_STARTER_PLOT_DOWNSAMPLE_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+#include "implot.h"
+
+/***
+ * Plot series with millions of points at the cost of a few thousand.
+ *
+ * ImPlot::PlotLine() draws every point it is given. A plot is only a thousand
+ * or so pixels wide, though, so once there are more points than pixels most of
+ * that work is lines drawn over each other. Ten minutes of 1kHz telemetry is
+ * 600000 points and the interface grinds to a halt.
+ *
+ * What a line looks like in one column of pixels is set by the smallest and
+ * largest values in that column. A DownsampledSeries keeps, for blocks of 4, 8,
+ * 16 ... samples, where the smallest and largest values in each block are. Each
+ * frame it finds the samples inside the plot, picks the size of block that puts
+ * about one block in each column of pixels, and plots just the two extreme points
+ * of each of those blocks. That looks the same as plotting everything, spikes
+ * included, and costs four points per column at most however long the series is.
+ *
+ * LTTB (Largest Triangle Three Buckets, Steinarsson 2013) can be used instead to
+ * bring that down to one point per column. It keeps the points that matter most to
+ * the shape of the line, which gives a cleaner line but can shave the tops off spikes.
+ *
+ *   DownsampledSeries speed;
+ *   for (...) {
+ *     speed.push_back(time, value);
+ *   }
+ *   ...
+ *   if (ImPlot::BeginPlot("Speed")) {
+ *     speed.plot("speed");
+ *     ImPlot::EndPlot();
+ *   }
+ *
+ * The x values must never go down, as with time. Adding a point is cheap, so a
+ * series can grow while it is being plotted. The block tables take about a third of the
+ * memory of the points themselves.
+ */
+
+enum class Downsample {
+  None,    // every point in view. Only for short series
+  MinMax,  // the extremes in each column of pixels
+  LTTB,    // about one point per column, chosen by area
+};
+
+/***
+ * Largest Triangle Three Buckets. Picks threshold points from in that keep
+ * the look of the line. The first and last points are always kept.
+ */
+inline void lttb(const ImPlotPoint* in, size_t count, size_t threshold, std::vector<ImPlotPoint>& out) {
+  out.clear();
+  if (threshold >= count || threshold < 3) {
+    out.assign(in, in + count);
+    return;
+  }
+  out.reserve(threshold);
+  const double bucket = double(count - 2) / double(threshold - 2);
+  size_t a = 0;
+  out.push_back(in[0]);
+  for (size_t i = 0; i < threshold - 2; i++) {
+    /// the average of the next bucket stands in for the point still to be chosen
+    size_t next_first = size_t(double(i + 1) * bucket) + 1;
+    size_t next_last = std::min(size_t(double(i + 2) * bucket) + 1, count);
+    double avg_x = 0;
+    double avg_y = 0;
+    for (size_t j = next_first; j < next_last; j++) {
+      avg_x += in[j].x;
+      avg_y += in[j].y;
+    }
+    double n = double(std::max<size_t>(1, next_last - next_first));
+    avg_x /= n;
+    avg_y /= n;
+
+    size_t first = size_t(double(i) * bucket) + 1;
+    size_t last = next_first;
+    double best_area = -1;
+    size_t best = first;
+    for (size_t j = first; j < last; j++) {
+      double area = std::abs((in[a].x - avg_x) * (in[j].y - in[a].y) - (in[a].x - in[j].x) * (avg_y - in[a].y));
+      if (area > best_area) {
+        best_area = area;
+        best = j;
+      }
+    }
+    out.push_back(in[best]);
+    a = best;
+  }
+  out.push_back(in[count - 1]);
+}
+
+class DownsampledSeries {
+ public:
+  static constexpr int FIRST_BLOCK_SHIFT = 2;  // the finest blocks hold 4 samples
+
+  void reserve(size_t count) {
+    m_x.reserve(count);
+    m_y.reserve(count);
+  }
+
+  void clear() {
+    m_x.clear();
+    m_y.clear();
+    m_levels.clear();
+  }
+
+  /// x must be no less than the x of the point before
+  void push_back(double x, float y) {
+    const uint32_t i = (uint32_t)m_x.size();
+    m_x.push_back(x);
+    m_y.push_back(y);
+    for (size_t level = 0; level < m_levels.size(); level++) {
+      add_to_block(m_levels[level], i >> (level + FIRST_BLOCK_SHIFT), i);
+    }
+    /// start a coarser level once it would have more than one block
+    size_t level = m_levels.size();
+    if (m_x.size() > (size_t(1) << (level + FIRST_BLOCK_SHIFT))) {
+      m_levels.emplace_back();
+      if (level == 0) {
+        for (uint32_t j = 0; j <= i; j++) {
+          add_to_block(m_levels[0], j >> FIRST_BLOCK_SHIFT, j);
+        }
+      } else {
+        const std::vector<Block>& finer = m_levels[level - 1];
+        for (size_t b = 0; b < finer.size(); b++) {
+          add_to_block(m_levels[level], b / 2, finer[b].min);
+          add_to_block(m_levels[level], b / 2, finer[b].max);
+        }
+      }
+    }
+  }
+
+  [[nodiscard]] size_t size() const { return m_x.size(); }
+  [[nodiscard]] bool empty() const { return m_x.empty(); }
+  [[nodiscard]] double x(size_t i) const { return m_x[i]; }
+  [[nodiscard]] float y(size_t i) const { return m_y[i]; }
+
+  /// the points that would be plotted for the x range, with about columns pixels across it
+  const std::vector<ImPlotPoint>& downsample(double x_min, double x_max, int columns, Downsample method = Downsample::MinMax) {
+    m_points.clear();
+    if (m_x.empty()) {
+      return m_points;
+    }
+    columns = std::max(1, columns);
+    /// one point either side of the range so the line runs off the edges of the plot
+    size_t first = std::lower_bound(m_x.begin(), m_x.end(), x_min) - m_x.begin();
+    size_t last = std::upper_bound(m_x.begin(), m_x.end(), x_max) - m_x.begin();
+    first = first > 0 ? first - 1 : 0;
+    last = std::min(last + 1, m_x.size());
+
+    /// a coarse outline of everything outside the range keeps the fit to data button working
+    const int outside = std::max(1, columns / 8);
+    if (method == Downsample::None) {
+      append_outline(0, first, outside);
+      for (size_t i = first; i < last; i++) {
+        m_points.emplace_back(m_x[i], m_y[i]);
+      }
+      append_outline(last, m_x.size(), outside);
+      return m_points;
+    }
+    append_outline(0, first, outside);
+    size_t before = m_points.size();
+    append_outline(first, last, columns);
+    if (method == Downsample::LTTB && m_points.size() - before > (size_t)columns) {
+      lttb(m_points.data() + before, m_points.size() - before, (size_t)columns, m_lttb);
+      m_points.resize(before);
+      m_points.insert(m_points.end(), m_lttb.begin(), m_lttb.end());
+    }
+    append_outline(last, m_x.size(), outside);
+    return m_points;
+  }
+
+  /***
+   * Plot the part of the series inside the current plot. Call it between
+   * ImPlot::BeginPlot() and ImPlot::EndPlot() like ImPlot::PlotLine().
+   */
+  void plot(const char* label, Downsample method = Downsample::MinMax, ImPlotLineFlags flags = 0) {
+    ImPlotRect limits = ImPlot::GetPlotLimits();
+    int columns = (int)ImPlot::GetPlotSize().x;
+    const std::vector<ImPlotPoint>& points = downsample(limits.X.Min, limits.X.Max, columns, method);
+    ImPlot::PlotLineG(label, &DownsampledSeries::getter, (void*)&points, (int)points.size(), flags);
+  }
+
+  /// the number of points the last downsample() or plot() produced
+  [[nodiscard]] size_t plotted() const { return m_points.size(); }
+
+ private:
+  struct Block {
+    uint32_t min;  // index of the smallest y in the block
+    uint32_t max;  // index of the largest y
+  };
+
+  static ImPlotPoint getter(int idx, void* data) { return (*(const std::vector<ImPlotPoint>*)data)[idx]; }
+
+  void add_to_block(std::vector<Block>& blocks, size_t block, uint32_t i) {
+    if (block == blocks.size()) {
+      blocks.push_back({i, i});
+      return;
+    }
+    Block& b = blocks[block];
+    if (m_y[i] < m_y[b.min]) {
+      b.min = i;
+    }
+    if (m_y[i] > m_y[b.max]) {
+      b.max = i;
+    }
+  }
+
+  /// the extremes of samples first to last - 1 in about columns blocks, or the samples themselves if there are few
+  void append_outline(size_t first, size_t last, int columns) {
+    if (first >= last) {
+      return;
+    }
+    const size_t count = last - first;
+    if (count <= 4 * (size_t)columns || m_levels.empty()) {
+      for (size_t i = first; i < last; i++) {
+        m_points.emplace_back(m_x[i], m_y[i]);
+      }
+      return;
+    }
+    /// the coarsest level that still has a block for every column
+    size_t level = 0;
+    while (level + 1 < m_levels.size() && (count >> (level + 1 + FIRST_BLOCK_SHIFT)) >= (size_t)columns) {
+      level++;
+    }
+    const int shift = int(level + FIRST_BLOCK_SHIFT);
+    const std::vector<Block>& blocks = m_levels[level];
+    /// the blocks at the ends may reach outside the range. Their extremes are only used if they are inside it
+    m_points.emplace_back(m_x[first], m_y[first]);
+    for (size_t b = first >> shift; b <= (last - 1) >> shift && b < blocks.size(); b++) {
+      uint32_t lo = std::min(blocks[b].min, blocks[b].max);
+      uint32_t hi = std::max(blocks[b].min, blocks[b].max);
+      if (lo > first && lo < last - 1) {
+        m_points.emplace_back(m_x[lo], m_y[lo]);
+      }
+      if (hi != lo && hi > first && hi < last - 1) {
+        m_points.emplace_back(m_x[hi], m_y[hi]);
+      }
+    }
+    m_points.emplace_back(m_x[last - 1], m_y[last - 1]);
+  }
+
+  std::vector<double> m_x;
+  std::vector<float> m_y;
+  std::vector<std::vector<Block>> m_levels;  // level n has blocks of 4 << n samples
+  std::vector<ImPlotPoint> m_points;
+  std::vector<ImPlotPoint> m_lttb;
+};
+
+#endif  // IMGUI_SFML_STARTER_PLOT_DOWNSAMPLE_H
@@ -0,0 +1,353 @@
+#ifndef IMGUI_SFML_STARTER_PROFILER_H
+#define IMGUI_SFML_STARTER_PROFILER_H
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "alloc_tracker.h"
+
+/***
+ * A small profiler that times named blocks of code on any thread.
+ *
+ * Put PROFILE_SCOPE("name") at the top of a block and the time from there to the
+ * end of the block is recorded. PROFILE_FUNCTION() does the same using the
+ * function name. Call PROFILE_FRAME() once at the start of each frame so the
+ * blocks can be grouped into frames.
+ *
+ *   while (window.isOpen()) {
+ *     PROFILE_FRAME();
+ *     {
+ *       PROFILE_SCOPE("events");
+ *       ...
+ *     }
+ *     {
+ *       PROFILE_SCOPE("update");
+ *       ...
+ *
+ * Every thread records into its own buffer, so recording needs no locks. Each buffer
+ * is a ring of the most recent 16384 blocks, so a new block costs two reads of the clock
+ * and one store. That is about 800KB a thread. When a thread ends its buffer is handed
+ * to the next new thread, so short lived threads do not each cost another one.
+ *
+ * Times are nanoseconds from std::chrono::steady_clock. The names must be string
+ * literals, or at least live as long as the program, because only the pointer is kept.
+ *
+ * A ProfilerView (profiler_view.h) shows the blocks of the last frame
+ * as a timeline, one row per thread, and the history of where the frame time went.
+ * write_chrome_trace() saves everything in the buffers in the format used by chrome://tracing
+ * and https://ui.perfetto.dev.
+ *
+ * When the allocation tracker is installed (see alloc_tracker.h) each block also records
+ * the heap allocations made inside it on its own thread, and frame_allocations() gives the
+ * total for a whole frame across all threads. The trace carries them as arguments on each block.
+ *
+ * Define PROFILER_DISABLED before including this to compile the macros away.
+ */
+
+struct ProfileEvent {
+  const char* name;
+  int64_t start;  // ns
+  int64_t end;    // ns
+  uint32_t depth;  // 0 for a block that is not inside another one
+  uint32_t allocations = 0;  // heap allocations inside the block, on its thread
+  uint64_t bytes = 0;        // bytes those allocations asked for
+  int64_t peak = 0;          // the most the thread's live heap rose above where it was at the start
+};
+
+class ProfileThread {
+ public:
+  static constexpr size_t CAPACITY = 1 << 14;  // CAPACITY * sizeof(ProfileEvent) is the size of each buffer
+
+  ProfileThread(std::string name, int id) : m_name(std::move(name)), m_id(id), m_allocations(&alloc_tracker::this_thread()) {}
+
+  /// owner thread only
+  void push(const ProfileEvent& event) {
+    uint64_t head = m_head.load(std::memory_order_relaxed);
+    m_events[head & (CAPACITY - 1)] = event;
+    m_head.store(head + 1, std::memory_order_release);
+  }
+
+  /***
+   * Copy the events that end between from and to. Only the newest half of the
+   * ring is read, which leaves the owner plenty of room to keep writing while
+   * this runs.
+   */
+  void copy(int64_t from, int64_t to, std::vector<ProfileEvent>& out) const {
+    visit(from, to, [&](const ProfileEvent& e) { out.push_back(e); });
+  }
+
+  /// the time in ns spent in blocks with this name that end between from and to, without copying them
+  [[nodiscard]] int64_t total(const char* name, int64_t from, int64_t to) const {
+    int64_t sum = 0;
+    visit(from, to, [&](const ProfileEvent& e) {
+      if (std::strcmp(e.name, name) == 0) {
+        sum += e.end - e.start;
+      }
+    });
+    return sum;
+  }
+
+  /// a copy, because the name changes when the buffer is handed to a new thread
+  [[nodiscard]] std::string name() const {
+    std::lock_guard<std::mutex> lock(m_name_mutex);
+    return m_name;
+  }
+  /// the same into a string the caller keeps, which does not allocate once it is long enough
+  void name(std::string& out) const {
+    std::lock_guard<std::mutex> lock(m_name_mutex);
+    out.assign(m_name);
+  }
+  [[nodiscard]] int id() const { return m_id; }
+  /// the thread's heap counters, which only count when the tracker is installed
+  [[nodiscard]] const alloc_tracker::ThreadCounters& allocations() const { return *m_allocations; }
+  [[nodiscard]] alloc_tracker::ThreadCounters& allocations() { return *m_allocations; }
+
+  uint32_t open = 0;  // how many blocks are open on the owner thread
+
+ private:
+  friend class Profiler;
+
+  template <typename F>
+  void visit(int64_t from, int64_t to, F&& f) const {
+    uint64_t head = m_head.load(std::memory_order_acquire);
+    uint64_t count = std::min<uint64_t>(head, CAPACITY / 2);
+    /// a recycled buffer still holds the events of the thread that had it before
+    uint64_t first = std::max(head - count, m_first.load(std::memory_order_acquire));
+    for (uint64_t i = first; i < head; i++) {
+      const ProfileEvent& e = m_events[i & (CAPACITY - 1)];
+      if (e.end >= from && e.end <= to) {
+        f(e);
+      }
+    }
+  }
+
+  /// hand the buffer to the calling thread, which is a new one. Called with the profiler's lock held
+  void reuse() {
+    m_first.store(m_head.load(std::memory_order_relaxed), std::memory_order_release);
+    rename("thread " + std::to_string(m_id));
+    m_allocations = &alloc_tracker::this_thread();
+    open = 0;
+    m_retired.store(false, std::memory_order_relaxed);
+  }
+
+  void rename(const std::string& name) {
+    std::lock_guard<std::mutex> lock(m_name_mutex);
+    m_name = name;
+  }
+
+  std::string m_name;
+  mutable std::mutex m_name_mutex;  // the name is read by the view and the trace writer on other threads
+  int m_id;
+  alloc_tracker::ThreadCounters* m_allocations;
+  std::atomic<uint64_t> m_head{0};
+  std::atomic<uint64_t> m_first{0};     // the first event recorded by the current owner
+  std::atomic<bool> m_retired{false};  // the owner has ended and the buffer is free
+  std::array<ProfileEvent, CAPACITY> m_events{};
+};
+
+class Profiler {
+ public:
+  static constexpr size_t FRAME_HISTORY = 512;
+
+  static Profiler& get() {
+    static Profiler profiler;
+    return profiler;
+  }
+
+  static int64_t now() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+  }
+
+  /// the buffer for the calling thread, found the first time it is needed. It is given back when the thread ends
+  ProfileThread& thread() {
+    struct Owner {
+      ProfileThread* buffer = nullptr;
+      ~Owner() {
+        if (buffer) {
+          buffer->m_retired.store(true, std::memory_order_release);
+        }
+      }
+    };
+    thread_local Owner mine;
+    if (!mine.buffer) {
+      mine.buffer = &adopt();
+    }
+    return *mine.buffer;
+  }
+
+  void set_thread_name(const std::string& name) { thread().rename(name); }
+
+  /// mark the start of a frame. Call it from one thread only, usually the main one
+  void frame() {
+    m_frame_starts[m_frame_count % FRAME_HISTORY] = now();
+    m_frame_heap[m_frame_count % FRAME_HISTORY] = alloc_tracker::total();
+    m_frame_count++;
+  }
+
+  [[nodiscard]] uint64_t frame_count() const { return m_frame_count; }
+
+  /***
+   * The heap allocations made by all the threads in a recent complete frame. 1 is the
+   * last complete one. live is how much the heap grew and peak is the sum of the
+   * thread peaks, since the program started, at the end of that frame.
+   */
+  [[nodiscard]] alloc_tracker::Counts frame_allocations(uint64_t frames_ago) const {
+    if (frames_ago == 0 || frames_ago >= m_frame_count || frames_ago >= FRAME_HISTORY) {
+      return {};
+    }
+    const alloc_tracker::Counts& end = m_frame_heap[(m_frame_count - frames_ago) % FRAME_HISTORY];
+    const alloc_tracker::Counts& start = m_frame_heap[(m_frame_count - 1 - frames_ago) % FRAME_HISTORY];
+    return {end.allocations - start.allocations, end.frees - start.frees, end.bytes - start.bytes, end.live - start.live, end.peak};
+  }
+
+  /// the start of a recent frame. 0 is the frame in progress, 1 the last complete one and so on
+  [[nodiscard]] int64_t frame_start(uint64_t frames_ago) const {
+    if (frames_ago >= m_frame_count || frames_ago >= FRAME_HISTORY) {
+      return 0;
+    }
+    return m_frame_starts[(m_frame_count - 1 - frames_ago) % FRAME_HISTORY];
+  }
+
+  /***
+   * The time in ns the calling thread spent in blocks with this name in a recent complete
+   * frame, 1 being the last one. Nothing is copied, so it is cheap enough for a HUD.
+   */
+  [[nodiscard]] int64_t block_time(const char* name, uint64_t frames_ago = 1) {
+    if (frames_ago == 0 || frames_ago >= m_frame_count || frames_ago >= FRAME_HISTORY) {
+      return 0;
+    }
+    return thread().total(name, frame_start(frames_ago), frame_start(frames_ago - 1));
+  }
+
+  /***
+   * The buffers of the threads that have recorded anything. The pointers stay valid for
+   * the life of the program. out is cleared and filled, so a caller that keeps it from
+   * frame to frame does not allocate once it is big enough.
+   */
+  void threads(std::vector<const ProfileThread*>& out) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    out.clear();
+    for (const auto& t : m_threads) {
+      out.push_back(t.get());
+    }
+  }
+
+  /// everything still in the buffers as a JSON file that chrome://tracing and Perfetto can open
+  bool write_chrome_trace(const std::string& path) const {
+    FILE* file = std::fopen(path.c_str(), "w");
+    if (!file) {
+      return false;
+    }
+    std::fprintf(file, "{\"traceEvents\":[\n");
+    const bool heap = alloc_tracker::installed();
+    bool first = true;
+    std::vector<const ProfileThread*> buffers;
+    threads(buffers);
+    std::vector<ProfileEvent> events;
+    for (const ProfileThread* t : buffers) {
+      events.clear();
+      t->copy(INT64_MIN, INT64_MAX, events);
+      std::fprintf(file, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"%s\"}}", first ? "" : ",\n", t->id(),
+                   t->name().c_str());
+      first = false;
+      for (const ProfileEvent& e : events) {
+        std::fprintf(file, ",\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f", e.name, t->id(), double(e.start) / 1000.0,
+                     double(e.end - e.start) / 1000.0);
+        if (heap) {
+          std::fprintf(file, ",\"args\":{\"allocations\":%u,\"bytes\":%llu,\"peak\":%lld}", e.allocations, (unsigned long long)e.bytes, (long long)e.peak);
+        }
+        std::fprintf(file, "}");
+      }
+    }
+    std::fprintf(file, "\n]}\n");
+    return std::fclose(file) == 0;
+  }
+
+  std::atomic<bool> enabled{true};
+
+ private:
+  Profiler() = default;
+
+  /// a buffer left by a thread that has ended, or a new one
+  ProfileThread& adopt() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (const auto& t : m_threads) {
+      if (t->m_retired.load(std::memory_order_acquire)) {
+        t->reuse();
+        return *t;
+      }
+    }
+    int id = (int)m_threads.size();
+    m_threads.push_back(std::make_unique<ProfileThread>(id == 0 ? "main" : "thread " + std::to_string(id), id));
+    return *m_threads.back();
+  }
+
+  mutable std::mutex m_mutex;
+  std::vector<std::unique_ptr<ProfileThread>> m_threads;
+  std::array<int64_t, FRAME_HISTORY> m_frame_starts{};
+  std::array<alloc_tracker::Counts, FRAME_HISTORY> m_frame_heap{};
+  uint64_t m_frame_count = 0;
+};
+
+/// times its own lifetime
+class ProfileZone {
+ public:
+  explicit ProfileZone(const char* name) : m_name(name) {
+    if (Profiler::get().enabled.load(std::memory_order_relaxed)) {
+      m_thread = &Profiler::get().thread();
+      m_thread->open++;
+      alloc_tracker::ThreadCounters& heap = m_thread->allocations();
+      m_heap = heap.counts();
+      m_outer_peak = heap.begin_scope();
+      m_start = Profiler::now();
+    }
+  }
+
+  ~ProfileZone() {
+    if (m_thread) {
+      int64_t end = Profiler::now();
+      m_thread->open--;
+      alloc_tracker::ThreadCounters& heap = m_thread->allocations();
+      const alloc_tracker::Counts now = heap.counts();
+      const int64_t peak = heap.end_scope(m_outer_peak);
+      m_thread->push({m_name, m_start, end, m_thread->open, uint32_t(now.allocations - m_heap.allocations), now.bytes - m_heap.bytes,
+                      std::max<int64_t>(0, peak - m_heap.live)});
+    }
+  }
+
+  ProfileZone(const ProfileZone&) = delete;
+  ProfileZone& operator=(const ProfileZone&) = delete;
+
+ private:
+  const char* m_name;
+  ProfileThread* m_thread = nullptr;
+  int64_t m_start = 0;
+  alloc_tracker::Counts m_heap;
+  int64_t m_outer_peak = 0;
+};
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+
+#ifndef PROFILER_DISABLED
+#define PROFILE_SCOPE(name) ProfileZone PROFILE_CONCAT(profile_zone_, __COUNTER__)(name)
+#define PROFILE_FUNCTION() PROFILE_SCOPE(__func__)
+#define PROFILE_FRAME() Profiler::get().frame()
+#define PROFILE_THREAD(name) Profiler::get().set_thread_name(name)
+#else
+#define PROFILE_SCOPE(name)
+#define PROFILE_FUNCTION()
+#define PROFILE_FRAME()
+#define PROFILE_THREAD(name)
+#endif
+
+#endif  // IMGUI_SFML_STARTER_PROFILER_H
@@ -0,0 +1,302 @@
+#ifndef IMGUI_SFML_STARTER_PROFILER_VIEW_H
+#define IMGUI_SFML_STARTER_PROFILER_VIEW_H
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "imgui.h"
+#include "implot.h"
+#include "profiler.h"
+
+/***
+ * An ImGui window that shows what the Profiler recorded.
+ *
+ * The top plot is a timeline of the last complete frame with a row for each
+ * thread. Blocks inside other blocks are drawn below them, so it reads like an
+ * upside down flame graph. Hover over a block to see its name and duration.
+ *
+ * The bottom plot is the recent history of the top level blocks on the thread that calls
+ * this, stacked so that the height of the pile is the time spent in named blocks
+ * each frame. Anything not inside a block shows as the gap up to the frame time line.
+ *
+ * When the allocation tracker is installed (see alloc_tracker.h) there is a line for the
+ * heap allocations in the last frame, a plot of them for each top level block, and a table of
+ * each thread's totals. Set allocation_budget and any frame that makes more allocations than
+ * that is counted and shown in red.
+ *
+ * Call it once a frame between ImGui::SFML::Update() and ImGui::SFML::Render(). It needs an ImPlot context.
+ * It keeps its working arrays from frame to frame, so once it has seen every thread and
+ * every block name it makes no heap allocations of its own to count against the budget.
+ */
+
+class ProfilerView {
+ public:
+  static constexpr int HISTORY = 240;  // frames
+
+  int allocation_budget = -1;  // heap allocations allowed in a frame, or -1 for no limit
+
+  void draw(bool* open = nullptr) {
+    Profiler& profiler = Profiler::get();
+    if (!ImGui::Begin("Profiler", open)) {
+      ImGui::End();
+      return;
+    }
+    if (ImGui::Button(m_paused ? "Resume" : "Pause")) {
+      m_paused = !m_paused;
+    }
+    ImGui::SameLine();
+    if (ImGui::Button("Save trace")) {
+      m_saved = profiler.write_chrome_trace("profile.json") ? "saved profile.json" : "unable to save profile.json";
+    }
+    ImGui::SameLine();
+    ImGui::TextUnformatted(m_saved.c_str());
+
+    if (!m_paused && profiler.frame_count() >= 2) {
+      collect(profiler);
+    }
+    ImGui::Text("Frame %.2f ms", double(m_frame_end - m_frame_begin) / 1e6);
+    const bool heap = alloc_tracker::installed();
+    if (heap) {
+      draw_heap_summary();
+    }
+    draw_timeline();
+    draw_history();
+    if (heap) {
+      draw_heap_history();
+      draw_heap_threads(profiler);
+    }
+    ImGui::End();
+  }
+
+ private:
+  struct Lane {
+    std::string name;
+    std::vector<ProfileEvent> events;
+  };
+
+  /// the history arrays are rings of HISTORY frames. m_next is the slot the next frame goes in, and the oldest once they are full
+  struct Phase {
+    const char* name;
+    std::vector<float> ms = std::vector<float>(HISTORY, 0.0f);
+    std::vector<float> allocations = std::vector<float>(HISTORY, 0.0f);
+  };
+
+  void collect(const Profiler& profiler) {
+    m_frame_begin = profiler.frame_start(1);
+    m_frame_end = profiler.frame_start(0);
+    profiler.threads(m_threads);
+    m_lane_count = 0;
+    for (const ProfileThread* t : m_threads) {
+      if (m_lane_count == m_lanes.size()) {
+        m_lanes.emplace_back();
+      }
+      Lane& lane = m_lanes[m_lane_count];
+      lane.events.clear();
+      t->copy(m_frame_begin, m_frame_end, lane.events);
+      if (!lane.events.empty()) {
+        t->name(lane.name);
+        m_lane_count++;
+      }
+    }
+    /// the top level blocks on this thread, added up by name
+    m_mine.clear();
+    Profiler::get().thread().copy(m_frame_begin, m_frame_end, m_mine);
+    for (Phase& phase : m_phases) {
+      phase.ms[m_next] = 0;
+      phase.allocations[m_next] = 0;
+    }
+    for (const ProfileEvent& e : m_mine) {
+      if (e.depth != 0) {
+        continue;
+      }
+      auto found = std::find_if(m_phases.begin(), m_phases.end(), [&](const Phase& p) { return std::strcmp(p.name, e.name) == 0; });
+      if (found == m_phases.end()) {
+        m_phases.push_back({e.name});
+        found = m_phases.end() - 1;
+      }
+      found->ms[m_next] += float(e.end - e.start) / 1e6f;
+      found->allocations[m_next] += float(e.allocations);
+    }
+    m_frame_ms[m_next] = float(m_frame_end - m_frame_begin) / 1e6f;
+    m_frame_heap = profiler.frame_allocations(1);
+    m_frame_allocations[m_next] = float(m_frame_heap.allocations);
+    if (allocation_budget >= 0 && m_frame_heap.allocations > uint64_t(allocation_budget)) {
+      m_over_budget++;
+    }
+    m_next = (m_next + 1) % HISTORY;
+    m_count = std::min(m_count + 1, HISTORY);
+    /// how many frames ago each slot was, for the x axis
+    for (int i = 0; i < m_count; i++) {
+      m_xs[i] = -float((m_next + HISTORY - 1 - i) % HISTORY);
+    }
+  }
+
+  /// for ImPlot's offset argument, so that the rings are plotted oldest first
+  [[nodiscard]] int oldest() const { return m_count < HISTORY ? 0 : m_next; }
+
+  void draw_timeline() {
+    const double frame_ms = double(m_frame_end - m_frame_begin) / 1e6;
+    const int lanes = (int)m_lane_count;
+    uint32_t max_depth = 0;
+    for (int l = 0; l < lanes; l++) {
+      for (const ProfileEvent& e : m_lanes[l].events) {
+        max_depth = std::max(max_depth, e.depth);
+      }
+    }
+    const double row = 1.0 / double(max_depth + 2);  // height of one depth within a lane, leaving a gap
+    if (!ImPlot::BeginPlot("##timeline", ImVec2(-1, 60.0f + 24.0f * float(std::max(1, lanes) * (max_depth + 1))))) {
+      return;
+    }
+    ImPlot::SetupAxes("ms", nullptr, 0, ImPlotAxisFlags_Invert | ImPlotAxisFlags_NoTickLabels);
+    ImPlot::SetupAxisLimits(ImAxis_X1, 0, std::max(1.0, frame_ms), ImPlotCond_Always);
+    ImPlot::SetupAxisLimits(ImAxis_Y1, 0, std::max(1, lanes), ImPlotCond_Always);
+    ImDrawList* draw_list = ImPlot::GetPlotDrawList();
+    ImPlot::PushPlotClipRect();
+    ImPlotPoint mouse = ImPlot::GetPlotMousePos();
+    const ProfileEvent* hovered = nullptr;
+    for (int l = 0; l < lanes; l++) {
+      ImVec2 label = ImPlot::PlotToPixels(0, l);
+      draw_list->AddText(ImVec2(label.x + 2, label.y), IM_COL32(200, 200, 200, 255), m_lanes[l].name.c_str());
+      for (const ProfileEvent& e : m_lanes[l].events) {
+        double x0 = double(e.start - m_frame_begin) / 1e6;
+        double x1 = double(e.end - m_frame_begin) / 1e6;
+        double y0 = l + row * (e.depth + 1);
+        double y1 = y0 + row * 0.9;
+        ImVec2 p0 = ImPlot::PlotToPixels(x0, y0);
+        ImVec2 p1 = ImPlot::PlotToPixels(x1, y1);
+        ImVec2 a(std::min(p0.x, p1.x), std::min(p0.y, p1.y));
+        ImVec2 b(std::max(p0.x, p1.x), std::max(p0.y, p1.y));
+        draw_list->AddRectFilled(a, ImVec2(std::max(b.x, a.x + 1), b.y), colour(e.name));
+        if (b.x - a.x > ImGui::CalcTextSize(e.name).x + 4) {
+          draw_list->AddText(ImVec2(a.x + 2, a.y), IM_COL32(0, 0, 0, 255), e.name);
+        }
+        if (mouse.x >= x0 && mouse.x <= x1 && mouse.y >= y0 && mouse.y <= y1) {
+          hovered = &e;
+        }
+      }
+    }
+    ImPlot::PopPlotClipRect();
+    if (hovered && ImPlot::IsPlotHovered()) {
+      ImGui::BeginTooltip();
+      ImGui::Text("%s  %.3f ms", hovered->name, double(hovered->end - hovered->start) / 1e6);
+      if (alloc_tracker::installed()) {
+        ImGui::Text("%u allocations, %llu bytes, peak %lld bytes", hovered->allocations, (unsigned long long)hovered->bytes, (long long)hovered->peak);
+      }
+      ImGui::EndTooltip();
+    }
+    ImPlot::EndPlot();
+  }
+
+  void draw_history() {
+    if (m_count == 0 || !ImPlot::BeginPlot("Frame budget", ImVec2(-1, 220))) {
+      return;
+    }
+    const int n = m_count;
+    ImPlot::SetupAxes("frames ago", "ms", ImPlotAxisFlags_AutoFit, ImPlotAxisFlags_AutoFit);
+    ImPlot::SetupLegend(ImPlotLocation_NorthWest);
+    std::fill(m_below.begin(), m_below.end(), 0.0f);
+    for (const Phase& phase : m_phases) {
+      for (int i = 0; i < n; i++) {
+        m_above[i] = m_below[i] + phase.ms[i];
+      }
+      ImPlot::SetNextFillStyle(ImGui::ColorConvertU32ToFloat4(colour(phase.name)));
+      ImPlot::PlotShaded(phase.name, m_xs.data(), m_below.data(), m_above.data(), n, 0, oldest());
+      std::swap(m_below, m_above);
+    }
+    ImPlot::PlotLine("frame", m_xs.data(), m_frame_ms.data(), n, 0, oldest());
+    ImPlot::EndPlot();
+  }
+
+  void draw_heap_summary() {
+    const bool over = allocation_budget >= 0 && m_frame_heap.allocations > uint64_t(allocation_budget);
+    ImVec4 colour = over ? ImVec4(1.0f, 0.3f, 0.3f, 1.0f) : ImGui::GetStyleColorVec4(ImGuiCol_Text);
+    ImGui::TextColored(colour, "Heap %llu allocations, %llu frees, %.1f kB", (unsigned long long)m_frame_heap.allocations,
+                       (unsigned long long)m_frame_heap.frees, double(m_frame_heap.bytes) / 1024.0);
+    if (allocation_budget >= 0) {
+      ImGui::SameLine();
+      ImGui::TextColored(colour, " budget %d, %d frames over", allocation_budget, m_over_budget);
+    }
+  }
+
+  /// the allocations in each top level block on this thread, and the whole frame on every thread
+  void draw_heap_history() {
+    if (m_count == 0 || !ImPlot::BeginPlot("Heap allocations", ImVec2(-1, 160))) {
+      return;
+    }
+    const int n = m_count;
+    ImPlot::SetupAxes("frames ago", "allocations", ImPlotAxisFlags_AutoFit, ImPlotAxisFlags_AutoFit);
+    ImPlot::SetupLegend(ImPlotLocation_NorthWest);
+    for (const Phase& phase : m_phases) {
+      ImPlot::SetNextLineStyle(ImGui::ColorConvertU32ToFloat4(colour(phase.name)));
+      ImPlot::PlotLine(phase.name, m_xs.data(), phase.allocations.data(), n, 0, oldest());
+    }
+    ImPlot::PlotLine("frame", m_xs.data(), m_frame_allocations.data(), n, 0, oldest());
+    if (allocation_budget >= 0) {
+      const double budget = allocation_budget;
+      ImPlot::PlotInfLines("budget", &budget, 1, ImPlotInfLinesFlags_Horizontal);
+    }
+    ImPlot::EndPlot();
+  }
+
+  /// what each thread has done since the program started
+  void draw_heap_threads(const Profiler& profiler) {
+    if (!ImGui::BeginTable("heap threads", 5, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg)) {
+      return;
+    }
+    ImGui::TableSetupColumn("thread");
+    ImGui::TableSetupColumn("allocations");
+    ImGui::TableSetupColumn("frees");
+    ImGui::TableSetupColumn("live kB");
+    ImGui::TableSetupColumn("peak kB");
+    ImGui::TableHeadersRow();
+    profiler.threads(m_threads);
+    for (const ProfileThread* t : m_threads) {
+      alloc_tracker::Counts c = t->allocations().counts();
+      ImGui::TableNextRow();
+      ImGui::TableNextColumn();
+      t->name(m_thread_name);
+      ImGui::TextUnformatted(m_thread_name.c_str());
+      ImGui::TableNextColumn();
+      ImGui::Text("%llu", (unsigned long long)c.allocations);
+      ImGui::TableNextColumn();
+      ImGui::Text("%llu", (unsigned long long)c.frees);
+      ImGui::TableNextColumn();
+      ImGui::Text("%.1f", double(c.live) / 1024.0);
+      ImGui::TableNextColumn();
+      ImGui::Text("%.1f", double(c.peak) / 1024.0);
+    }
+    ImGui::EndTable();
+  }
+
+  /// the same colour for a name every time
+  static ImU32 colour(const char* name) {
+    uint32_t h = 2166136261u;
+    for (const char* c = name; *c; c++) {
+      h = (h ^ (unsigned char)*c) * 16777619u;
+    }
+    return IM_COL32(110 + (h & 0x7F), 110 + ((h >> 8) & 0x7F), 110 + ((h >> 16) & 0x7F), 255);
+  }
+
+  bool m_paused = false;
+  std::string m_saved;
+  int64_t m_frame_begin = 0;
+  int64_t m_frame_end = 0;
+  std::vector<const ProfileThread*> m_threads;
+  std::string m_thread_name;
+  std::vector<Lane> m_lanes;  // only the first m_lane_count are in use. The rest keep their arrays for later frames
+  size_t m_lane_count = 0;
+  std::vector<ProfileEvent> m_mine;
+  std::vector<Phase> m_phases;
+  std::vector<float> m_frame_ms = std::vector<float>(HISTORY, 0.0f);
+  std::vector<float> m_frame_allocations = std::vector<float>(HISTORY, 0.0f);
+  std::vector<float> m_xs = std::vector<float>(HISTORY, 0.0f);
+  std::vector<float> m_below = std::vector<float>(HISTORY, 0.0f);  // the stacked plot's lower and upper edges
+  std::vector<float> m_above = std::vector<float>(HISTORY, 0.0f);
+  int m_next = 0;
+  int m_count = 0;  // frames in the history, up to HISTORY
+  alloc_tracker::Counts m_frame_heap;
+  int m_over_budget = 0;
+};
+
+#endif  // IMGUI_SFML_STARTER_PROFILER_VIEW_H
@@ -8,7 +8,8 @@
 #include <cassert>
 #include <cmath>
 #include <iostream>
-#include <random>
+#include "fast_random.h"
+#include "vec2.h"
 
 #ifndef M_PI
 #define M_PI 3.14159265358979323846
@@ -23,6 +24,11 @@ class PVector {
 
   // Constructors
   explicit PVector(float x = 0, float y = 0) : x(x), y(y) {}
+  explicit PVector(const Vec2& v) : x(v.x), y(v.y) {}
+  explicit PVector(const sf::Vector2f& v) : x(v.x), y(v.y) {}
+
+  operator Vec2() const { return {x, y}; }
+  operator sf::Vector2f() const { return {x, y}; }
 
   static PVector from_angle(float angle) { return PVector(cosf(angle), sinf(angle)); }
 
@@ -30,12 +36,7 @@ class PVector {
   static PVector up() { return PVector(0, 1); }
   static PVector right() { return PVector(1, 0); }
 
-  PVector random() {
-    static std::random_device rd;
-    static std::mt19937 gen(rd());
-    std::uniform_real_distribution<float> dist(0, 2 * M_PI);
-    return from_angle(dist(gen));
-  }
+  PVector random() { return from_angle(thread_rng().uniform(0, 2 * M_PI)); }
 
   PVector left_normal() const {
     PVector v(-y, x);
@@ -0,0 +1,323 @@
+#ifndef IMGUI_SFML_STARTER_RENDER_COMMANDS_H
+#define IMGUI_SFML_STARTER_RENDER_COMMANDS_H
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <future>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "SFML/Graphics.hpp"
+#include "thread_pool.h"
+
+/***
+ * Build the vertices for a frame on worker threads and leave only the drawing to the main thread.
+ *
+ * SFML can only draw from the thread that owns the window's OpenGL context.
+ * Working out what to draw is ordinary CPU work, though: positions, colours,
+ * the triangles of a sensor fan or the quads of a line of text. A CommandBuffer
+ * collects that work as a list of draw commands that any thread can fill in.
+ * The main thread then just hands the finished vertices to the graphics driver.
+ *
+ * Each command is a range of vertices with a primitive type and a texture.
+ * Transforms are applied to the vertices as they are recorded, so the work is
+ * done on the worker. A new command that uses the same state as the last one
+ * just extends it, so a buffer full of shapes usually costs one or two draw calls.
+ * Only the list types, Triangles and Lines, are recorded. Fans and strips are turned into
+ * triangles on the way in so that they can be joined up.
+ *
+ * A buffer keeps its memory from frame to frame. Once it has grown to the size of a
+ * frame, recording allocates nothing.
+ *
+ * A CommandBuffer must only be filled by one thread at a time. Give each task its own.
+ */
+
+/***
+ * The size, position and place in the font texture of each character, for
+ * laying out text away from the main thread.
+ *
+ * sf::Font adds new characters to its texture the first time they are used,
+ * which touches OpenGL, so that has to happen on the main thread. prepare() does
+ * that up front for a set of characters. After that the table is read only and any thread
+ * may use it. Characters that were not prepared are skipped.
+ */
+class GlyphTable {
+ public:
+  static constexpr const char* PRINTABLE = " !\"#$%&'()*+,-./0123456789:;<=>?@ABCDEFGHIJKLMNOPQRSTUVWXYZ[\\]^_`abcdefghijklmnopqrstuvwxyz{|}~";
+
+  /// main thread only
+  void prepare(const sf::Font& font, unsigned size, const std::string& characters = PRINTABLE) {
+    m_glyphs.clear();
+    for (char c : characters) {
+      m_glyphs[(unsigned char)c] = font.getGlyph((unsigned char)c, size, false);
+    }
+    m_line_spacing = font.getLineSpacing(size);
+    m_texture = &font.getTexture(size);  // the texture grows as glyphs are added, so get it last
+    m_size = size;
+  }
+
+  [[nodiscard]] const sf::Glyph* glyph(unsigned char c) const {
+    auto found = m_glyphs.find(c);
+    return found == m_glyphs.end() ? nullptr : &found->second;
+  }
+  [[nodiscard]] const sf::Texture* texture() const { return m_texture; }
+  [[nodiscard]] float line_spacing() const { return m_line_spacing; }
+  [[nodiscard]] unsigned size() const { return m_size; }
+
+ private:
+  std::unordered_map<unsigned char, sf::Glyph> m_glyphs;
+  const sf::Texture* m_texture = nullptr;
+  float m_line_spacing = 0;
+  unsigned m_size = 0;
+};
+
+class CommandBuffer : public sf::Drawable {
+ public:
+  struct Command {
+    sf::PrimitiveType type;
+    const sf::Texture* texture;
+    size_t first;
+    size_t count;
+  };
+
+  void clear() {
+    m_vertices.clear();
+    m_commands.clear();
+    m_transform = sf::Transform::Identity;
+  }
+
+  /// applied to everything recorded after this
+  void set_transform(const sf::Transform& transform) { m_transform = transform; }
+  [[nodiscard]] const sf::Transform& transform() const { return m_transform; }
+
+  /// vertices in world coordinates, before the current transform. Only Triangles and Lines are joined up
+  void vertices(const sf::Vertex* vertices, size_t count, sf::PrimitiveType type, const sf::Texture* texture = nullptr) {
+    if (type == sf::TriangleFan) {
+      for (size_t i = 1; i + 1 < count; i++) {
+        triangle(vertices[0], vertices[i], vertices[i + 1], texture);
+      }
+      return;
+    }
+    if (type == sf::TriangleStrip) {
+      for (size_t i = 0; i + 2 < count; i++) {
+        triangle(vertices[i], vertices[i + 1], vertices[i + 2], texture);
+      }
+      return;
+    }
+    if (type == sf::LineStrip) {
+      if (count < 2) {
+        return;
+      }
+      /// each point but the ends is shared by two lines
+      sf::Vertex* out = reserve(sf::Lines, texture, 2 * (count - 1));
+      for (size_t i = 0; i + 1 < count; i++) {
+        out[2 * i] = transformed(vertices[i]);
+        out[2 * i + 1] = transformed(vertices[i + 1]);
+      }
+      return;
+    }
+    sf::Vertex* out = reserve(type, texture, count);
+    for (size_t i = 0; i < count; i++) {
+      out[i] = vertices[i];
+      out[i].position = m_transform.transformPoint(vertices[i].position);
+    }
+  }
+
+  void triangle(const sf::Vertex& a, const sf::Vertex& b, const sf::Vertex& c, const sf::Texture* texture = nullptr) {
+    sf::Vertex* out = reserve(sf::Triangles, texture, 3);
+    out[0] = transformed(a);
+    out[1] = transformed(b);
+    out[2] = transformed(c);
+  }
+
+  void line(const sf::Vertex& a, const sf::Vertex& b, const sf::Texture* texture = nullptr) {
+    sf::Vertex* out = reserve(sf::Lines, texture, 2);
+    out[0] = transformed(a);
+    out[1] = transformed(b);
+  }
+
+  void line(sf::Vector2f a, sf::Vector2f b, sf::Color color) { line(sf::Vertex(a, color), sf::Vertex(b, color)); }
+
+  /// a solid rectangle, or part of a texture if texture_rect is given
+  void rectangle(const sf::FloatRect& r, sf::Color color, const sf::Texture* texture = nullptr, const sf::FloatRect& texture_rect = {}) {
+    const float u0 = texture_rect.left;
+    const float v0 = texture_rect.top;
+    const float u1 = u0 + texture_rect.width;
+    const float v1 = v0 + texture_rect.height;
+    sf::Vertex top_left({r.left, r.top}, color, {u0, v0});
+    sf::Vertex top_right({r.left + r.width, r.top}, color, {u1, v0});
+    sf::Vertex bottom_right({r.left + r.width, r.top + r.height}, color, {u1, v1});
+    sf::Vertex bottom_left({r.left, r.top + r.height}, color, {u0, v1});
+    triangle(top_left, top_right, bottom_right, texture);
+    triangle(top_left, bottom_right, bottom_left, texture);
+  }
+
+  /// the outline of a rectangle as lines
+  void frame(const sf::FloatRect& r, sf::Color color) {
+    sf::Vector2f a(r.left, r.top);
+    sf::Vector2f b(r.left + r.width, r.top);
+    sf::Vector2f c(r.left + r.width, r.top + r.height);
+    sf::Vector2f d(r.left, r.top + r.height);
+    line(a, b, color);
+    line(b, c, color);
+    line(c, d, color);
+    line(d, a, color);
+  }
+
+  /***
+   * One line of quads per line of text with its top left corner at position, like
+   * an sf::Text at that position. No kerning, which makes little difference
+   * for short labels. Returns the width of the widest line.
+   */
+  float text(const GlyphTable& glyphs, const std::string& string, sf::Vector2f position, sf::Color color) {
+    const sf::Texture* texture = glyphs.texture();
+    float x = 0;
+    float y = (float)glyphs.size();  // the baseline of the first line
+    float widest = 0;
+    for (char c : string) {
+      if (c == '\n') {
+        widest = std::max(widest, x);
+        x = 0;
+        y += glyphs.line_spacing();
+        continue;
+      }
+      const sf::Glyph* glyph = glyphs.glyph((unsigned char)c);
+      if (!glyph) {
+        continue;
+      }
+      sf::FloatRect quad(position.x + x + glyph->bounds.left, position.y + y + glyph->bounds.top, glyph->bounds.width, glyph->bounds.height);
+      sf::FloatRect uv((float)glyph->textureRect.left, (float)glyph->textureRect.top, (float)glyph->textureRect.width, (float)glyph->textureRect.height);
+      if (quad.width > 0 && quad.height > 0) {
+        rectangle(quad, color, texture, uv);
+      }
+      x += glyph->advance;
+    }
+    return std::max(widest, x);
+  }
+
+  [[nodiscard]] size_t vertex_count() const { return m_vertices.size(); }
+  [[nodiscard]] size_t command_count() const { return m_commands.size(); }
+  [[nodiscard]] const std::vector<Command>& commands() const { return m_commands; }
+
+ private:
+  void draw(sf::RenderTarget& target, sf::RenderStates states) const override {
+    for (const Command& command : m_commands) {
+      states.texture = command.texture;
+      target.draw(m_vertices.data() + command.first, command.count, command.type, states);
+    }
+  }
+
+  [[nodiscard]] sf::Vertex transformed(const sf::Vertex& v) const {
+    sf::Vertex out = v;
+    out.position = m_transform.transformPoint(v.position);
+    return out;
+  }
+
+  /// room for count more vertices, extending the last command if the state is the same
+  sf::Vertex* reserve(sf::PrimitiveType type, const sf::Texture* texture, size_t count) {
+    if (m_commands.empty() || m_commands.back().type != type || m_commands.back().texture != texture) {
+      m_commands.push_back({type, texture, m_vertices.size(), 0});
+    }
+    m_commands.back().count += count;
+    m_vertices.resize(m_vertices.size() + count);
+    return m_vertices.data() + m_vertices.size() - count;
+  }
+
+  std::vector<sf::Vertex> m_vertices;
+  std::vector<Command> m_commands;
+  sf::Transform m_transform;
+};
+
+/***
+ * Records the layers of a frame in parallel while the main thread draws the frame before.
+ *
+ * Each layer, such as the background, the sensor fans and the text, has a
+ * recorder function and a CommandBuffer of its own for each of two frames.
+ * record() hands the recorders to a thread pool and returns straight away.
+ * submit() draws the frame recorded before that one, waiting only if it is
+ * not finished yet, so recording overlaps with the simulation and the drawing.
+ * The price is that what is shown is one frame behind what was recorded.
+ * Pass pipelined = false to wait for and draw the newest frame instead.
+ *
+ * The recorders run on other threads while the main thread carries on. Give them copies
+ * of anything the main thread will change, not references to it.
+ */
+class RenderPipeline {
+ public:
+  using Recorder = std::function<void(CommandBuffer&)>;
+
+  RenderPipeline(size_t layers, ThreadPool& pool) : m_pool(pool) {
+    for (auto& frame : m_frames) {
+      frame.layers.resize(layers);
+    }
+  }
+
+  ~RenderPipeline() {
+    for (auto& frame : m_frames) {
+      for (auto& task : frame.pending) {
+        if (task.valid()) {
+          task.wait();  // the recorders write into our buffers so they must finish first
+        }
+      }
+    }
+  }
+
+  /// start recording the next frame, one recorder per layer, in drawing order
+  void record(std::vector<Recorder> recorders) {
+    Frame& frame = m_frames[m_next];
+    wait(frame);  // it was drawn by the last submit() but may still be running if that was not called
+    frame.pending.clear();
+    for (size_t i = 0; i < frame.layers.size() && i < recorders.size(); i++) {
+      CommandBuffer* buffer = &frame.layers[i];
+      frame.pending.push_back(m_pool.submit([buffer, recorder = std::move(recorders[i])]() {
+        buffer->clear();
+        recorder(*buffer);
+      }));
+    }
+    frame.recorded = true;
+    m_next = 1 - m_next;
+  }
+
+  /// draw on the main thread
+  void submit(sf::RenderTarget& target, bool pipelined = true) {
+    Frame* frame = &m_frames[m_next];  // the older of the two
+    if (!pipelined || !frame->recorded) {
+      frame = &m_frames[1 - m_next];
+    }
+    wait(*frame);
+    m_draw_calls = 0;
+    m_vertices = 0;
+    for (const CommandBuffer& layer : frame->layers) {
+      target.draw(layer);
+      m_draw_calls += layer.command_count();
+      m_vertices += layer.vertex_count();
+    }
+  }
+
+  [[nodiscard]] size_t draw_calls() const { return m_draw_calls; }
+  [[nodiscard]] size_t vertices() const { return m_vertices; }
+
+ private:
+  struct Frame {
+    std::vector<CommandBuffer> layers;
+    std::vector<std::future<void>> pending;
+    bool recorded = false;
+  };
+
+  static void wait(Frame& frame) {
+    for (auto& task : frame.pending) {
+      if (task.valid()) {
+        task.get();  // passes on anything a recorder threw
+      }
+    }
+  }
+
+  ThreadPool& m_pool;
+  Frame m_frames[2];
+  int m_next = 0;
+  size_t m_draw_calls = 0;
+  size_t m_vertices = 0;
+};
+
+#endif  // IMGUI_SFML_STARTER_RENDER_COMMANDS_H
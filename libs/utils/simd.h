@@ -0,0 +1,159 @@
+#ifndef IMGUI_SFML_STARTER_SIMD_H
+#define IMGUI_SFML_STARTER_SIMD_H
+
+#include <cmath>
+#include <cstddef>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#define SIMD_AVX 1
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define SIMD_SSE 1
+#endif
+
+/***
+ * A very thin wrapper around the SSE and AVX float registers so that batch kernels
+ * can be written once and read like ordinary arithmetic:
+ *
+ *     for (size_t i = 0; i < n; i += simd::WIDTH) {
+ *       simd::f32 x = simd::load(&px[i]);
+ *       simd::f32 y = simd::load(&py[i]);
+ *       simd::store(&len[i], simd::sqrt(x * x + y * y));
+ *     }
+ *
+ * The widest instruction set enabled for the compiler is used. AVX needs -mavx or
+ * better (see the ENABLE_NATIVE_ARCH option in the top level CMakeLists.txt).
+ * SSE2 is always available on x86-64. Anything else falls back to a single
+ * scalar lane so the kernels still compile and give the same answers.
+ *
+ * Branches in kernels become masks. Compute both results and pick one:
+ *
+ *     simd::f32 r = simd::select(d2 < simd::splat(1.0f), a, b);
+ *
+ * Arrays used with these kernels should be padded to a multiple of WIDTH. Loads
+ * and stores are unaligned so no special allocator is needed.
+ */
+namespace simd {
+
+#if defined(SIMD_AVX)
+constexpr size_t WIDTH = 8;
+struct f32 {
+  __m256 v;
+};
+struct mask {
+  __m256 v;
+};
+inline f32 load(const float* p) { return {_mm256_loadu_ps(p)}; }
+inline void store(float* p, f32 a) { _mm256_storeu_ps(p, a.v); }
+inline f32 splat(float x) { return {_mm256_set1_ps(x)}; }
+inline f32 operator+(f32 a, f32 b) { return {_mm256_add_ps(a.v, b.v)}; }
+inline f32 operator-(f32 a, f32 b) { return {_mm256_sub_ps(a.v, b.v)}; }
+inline f32 operator*(f32 a, f32 b) { return {_mm256_mul_ps(a.v, b.v)}; }
+inline f32 operator/(f32 a, f32 b) { return {_mm256_div_ps(a.v, b.v)}; }
+inline f32 operator-(f32 a) { return {_mm256_xor_ps(a.v, _mm256_set1_ps(-0.0f))}; }
+inline f32 sqrt(f32 a) { return {_mm256_sqrt_ps(a.v)}; }
+inline f32 rsqrt_approx(f32 a) { return {_mm256_rsqrt_ps(a.v)}; }
+inline f32 min(f32 a, f32 b) { return {_mm256_min_ps(a.v, b.v)}; }
+inline f32 max(f32 a, f32 b) { return {_mm256_max_ps(a.v, b.v)}; }
+inline f32 abs(f32 a) { return {_mm256_andnot_ps(_mm256_set1_ps(-0.0f), a.v)}; }
+inline f32 floor(f32 a) { return {_mm256_floor_ps(a.v)}; }
+inline mask operator<(f32 a, f32 b) { return {_mm256_cmp_ps(a.v, b.v, _CMP_LT_OQ)}; }
+inline mask operator<=(f32 a, f32 b) { return {_mm256_cmp_ps(a.v, b.v, _CMP_LE_OQ)}; }
+inline mask operator>(f32 a, f32 b) { return {_mm256_cmp_ps(a.v, b.v, _CMP_GT_OQ)}; }
+inline mask operator>=(f32 a, f32 b) { return {_mm256_cmp_ps(a.v, b.v, _CMP_GE_OQ)}; }
+inline mask operator&&(mask a, mask b) { return {_mm256_and_ps(a.v, b.v)}; }
+inline mask operator||(mask a, mask b) { return {_mm256_or_ps(a.v, b.v)}; }
+inline mask operator!(mask a) { return {_mm256_xor_ps(a.v, _mm256_castsi256_ps(_mm256_set1_epi32(-1)))}; }
+inline f32 select(mask m, f32 a, f32 b) { return {_mm256_blendv_ps(b.v, a.v, m.v)}; }
+inline bool any(mask m) { return _mm256_movemask_ps(m.v) != 0; }
+
+#elif defined(SIMD_SSE)
+constexpr size_t WIDTH = 4;
+struct f32 {
+  __m128 v;
+};
+struct mask {
+  __m128 v;
+};
+inline f32 load(const float* p) { return {_mm_loadu_ps(p)}; }
+inline void store(float* p, f32 a) { _mm_storeu_ps(p, a.v); }
+inline f32 splat(float x) { return {_mm_set1_ps(x)}; }
+inline f32 operator+(f32 a, f32 b) { return {_mm_add_ps(a.v, b.v)}; }
+inline f32 operator-(f32 a, f32 b) { return {_mm_sub_ps(a.v, b.v)}; }
+inline f32 operator*(f32 a, f32 b) { return {_mm_mul_ps(a.v, b.v)}; }
+inline f32 operator/(f32 a, f32 b) { return {_mm_div_ps(a.v, b.v)}; }
+inline f32 operator-(f32 a) { return {_mm_xor_ps(a.v, _mm_set1_ps(-0.0f))}; }
+inline f32 sqrt(f32 a) { return {_mm_sqrt_ps(a.v)}; }
+inline f32 rsqrt_approx(f32 a) { return {_mm_rsqrt_ps(a.v)}; }
+inline f32 min(f32 a, f32 b) { return {_mm_min_ps(a.v, b.v)}; }
+inline f32 max(f32 a, f32 b) { return {_mm_max_ps(a.v, b.v)}; }
+inline f32 abs(f32 a) { return {_mm_andnot_ps(_mm_set1_ps(-0.0f), a.v)}; }
+/// SSE2 has no floor either. Truncate and step down where that went up. Only for |a| < 2^31
+inline f32 floor(f32 a) {
+  __m128 t = _mm_cvtepi32_ps(_mm_cvttps_epi32(a.v));
+  return {_mm_sub_ps(t, _mm_and_ps(_mm_cmpgt_ps(t, a.v), _mm_set1_ps(1.0f)))};
+}
+inline mask operator<(f32 a, f32 b) { return {_mm_cmplt_ps(a.v, b.v)}; }
+inline mask operator<=(f32 a, f32 b) { return {_mm_cmple_ps(a.v, b.v)}; }
+inline mask operator>(f32 a, f32 b) { return {_mm_cmpgt_ps(a.v, b.v)}; }
+inline mask operator>=(f32 a, f32 b) { return {_mm_cmpge_ps(a.v, b.v)}; }
+inline mask operator&&(mask a, mask b) { return {_mm_and_ps(a.v, b.v)}; }
+inline mask operator||(mask a, mask b) { return {_mm_or_ps(a.v, b.v)}; }
+inline mask operator!(mask a) { return {_mm_xor_ps(a.v, _mm_castsi128_ps(_mm_set1_epi32(-1)))}; }
+/// SSE2 has no blend instruction so do it with bitwise operations
+inline f32 select(mask m, f32 a, f32 b) { return {_mm_or_ps(_mm_and_ps(m.v, a.v), _mm_andnot_ps(m.v, b.v))}; }
+inline bool any(mask m) { return _mm_movemask_ps(m.v) != 0; }
+
+#else
+constexpr size_t WIDTH = 1;
+struct f32 {
+  float v;
+};
+struct mask {
+  bool v;
+};
+inline f32 load(const float* p) { return {*p}; }
+inline void store(float* p, f32 a) { *p = a.v; }
+inline f32 splat(float x) { return {x}; }
+inline f32 operator+(f32 a, f32 b) { return {a.v + b.v}; }
+inline f32 operator-(f32 a, f32 b) { return {a.v - b.v}; }
+inline f32 operator*(f32 a, f32 b) { return {a.v * b.v}; }
+inline f32 operator/(f32 a, f32 b) { return {a.v / b.v}; }
+inline f32 operator-(f32 a) { return {-a.v}; }
+inline f32 sqrt(f32 a) { return {std::sqrt(a.v)}; }
+inline f32 rsqrt_approx(f32 a) { return {1.0f / std::sqrt(a.v)}; }
+inline f32 min(f32 a, f32 b) { return {a.v < b.v ? a.v : b.v}; }
+inline f32 max(f32 a, f32 b) { return {a.v > b.v ? a.v : b.v}; }
+inline f32 abs(f32 a) { return {std::fabs(a.v)}; }
+inline f32 floor(f32 a) { return {std::floor(a.v)}; }
+inline mask operator<(f32 a, f32 b) { return {a.v < b.v}; }
+inline mask operator<=(f32 a, f32 b) { return {a.v <= b.v}; }
+inline mask operator>(f32 a, f32 b) { return {a.v > b.v}; }
+inline mask operator>=(f32 a, f32 b) { return {a.v >= b.v}; }
+inline mask operator&&(mask a, mask b) { return {a.v && b.v}; }
+inline mask operator||(mask a, mask b) { return {a.v || b.v}; }
+inline mask operator!(mask a) { return {!a.v}; }
+inline f32 select(mask m, f32 a, f32 b) { return m.v ? a : b; }
+inline bool any(mask m) { return m.v; }
+#endif
+
+inline f32& operator+=(f32& a, f32 b) {
+  a = a + b;
+  return a;
+}
+inline f32& operator-=(f32& a, f32 b) {
+  a = a - b;
+  return a;
+}
+inline f32& operator*=(f32& a, f32 b) {
+  a = a * b;
+  return a;
+}
+
+/// round a count up to a whole number of lanes
+constexpr size_t padded(size_t n) { return (n + WIDTH - 1) / WIDTH * WIDTH; }
+
+}  // namespace simd
+
+#endif  // IMGUI_SFML_STARTER_SIMD_H
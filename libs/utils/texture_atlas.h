@@ -0,0 +1,306 @@
+#ifndef IMGUI_SFML_STARTER_TEXTURE_ATLAS_H
+#define IMGUI_SFML_STARTER_TEXTURE_ATLAS_H
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <string>
+#include <vector>
+#include "SFML/Graphics.hpp"
+
+/***
+ * Packs lots of small images into one big texture.
+ *
+ * SFML can draw any number of sprites in a single call as long as they all use
+ * the same texture. Every change of texture means another call to the graphics
+ * driver. If the sprites for a scene all come from one atlas, the whole
+ * scene can be drawn in one go (see SpriteBatch).
+ *
+ * Images are added by name, one at a time or a whole folder at once. pack()
+ * then places them with a skyline packer. The skyline is the outline of the top
+ * edges of everything placed so far. Each image, tallest first, goes where it
+ * would sit lowest on the skyline, and the skyline is raised over it. That is
+ * quick and packs sprites of similar heights with very little waste.
+ *
+ * Each image gets a border of copies of its own edge pixels. Without it, a sprite
+ * drawn at a fractional position or scale can pick up a line of its neighbour
+ * when the texture is smoothed.
+ *
+ * rect(name) gives the position of an image in the atlas. rect(name, sub_rect)
+ * converts a rectangle within the original image, such as one frame of an
+ * animation, to one in the atlas.
+ */
+
+class TextureAtlas {
+ public:
+  explicit TextureAtlas(int padding = 2) : m_padding(padding) {}
+
+  void add(const std::string& name, const sf::Image& image) { m_pending.push_back({name, image}); }
+
+  /// just one part of an image, such as one cell of a big sheet of props
+  void add(const std::string& name, const sf::Image& image, const sf::IntRect& part) {
+    sf::Image piece;
+    piece.create((unsigned)part.width, (unsigned)part.height, sf::Color::Transparent);
+    piece.copy(image, 0, 0, part);
+    add(name, piece);
+  }
+
+  bool add_file(const std::string& name, const std::string& path) {
+    sf::Image image;
+    if (!image.loadFromFile(path)) {
+      return false;
+    }
+    add(name, image);
+    return true;
+  }
+
+  /***
+   * Every png in a folder, named by the file name without the extension. Skips anything
+   * larger than max_side. The size comes from the png header, so the big images are
+   * never decoded: dungeon.png alone would take 180MB.
+   */
+  int add_directory(const std::string& directory, unsigned max_side = 1024) {
+    namespace fs = std::filesystem;
+    int count = 0;
+    std::error_code error;
+    std::vector<fs::path> files;
+    for (const auto& entry : fs::directory_iterator(directory, error)) {
+      if (entry.is_regular_file() && entry.path().extension() == ".png") {
+        files.push_back(entry.path());
+      }
+    }
+    std::sort(files.begin(), files.end());  // the same atlas every time, whatever order the folder lists in
+    for (const auto& path : files) {
+      unsigned width = 0;
+      unsigned height = 0;
+      if (!png_size(path.string(), width, height) || width > max_side || height > max_side) {
+        continue;
+      }
+      sf::Image image;
+      if (!image.loadFromFile(path.string())) {
+        continue;
+      }
+      add(path.stem().string(), image);
+      count++;
+    }
+    return count;
+  }
+
+  /***
+   * Place all the added images and upload the atlas to the graphics card. The atlas
+   * starts at 256 pixels square and doubles until everything fits or it reaches
+   * the largest texture the card allows. Returns false if it never fits.
+   */
+  bool pack() {
+    const int limit = (int)sf::Texture::getMaximumSize();
+    std::vector<size_t> order(m_pending.size());
+    for (size_t i = 0; i < order.size(); i++) {
+      order[i] = i;
+    }
+    std::sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+      sf::Vector2u sa = m_pending[a].image.getSize();
+      sf::Vector2u sb = m_pending[b].image.getSize();
+      return sa.y != sb.y ? sa.y > sb.y : sa.x > sb.x;
+    });
+    std::vector<sf::Vector2i> places(m_pending.size());
+    int width = 256;
+    int height = 256;
+    while (!place_all(order, places, width, height)) {
+      if (width <= height) {
+        width *= 2;
+      } else {
+        height *= 2;
+      }
+      if (width > limit || height > limit) {
+        return false;
+      }
+    }
+    /// the skyline usually leaves the atlas less than full height so trim it
+    int used_height = 0;
+    for (size_t i = 0; i < places.size(); i++) {
+      used_height = std::max(used_height, places[i].y + (int)m_pending[i].image.getSize().y + 2 * m_padding);
+    }
+    height = std::max(1, used_height);
+
+    sf::Image atlas;
+    atlas.create(width, height, sf::Color::Transparent);
+    m_rects.clear();
+    for (size_t i = 0; i < m_pending.size(); i++) {
+      const sf::Image& image = m_pending[i].image;
+      sf::Vector2u size = image.getSize();
+      int left = places[i].x + m_padding;
+      int top = places[i].y + m_padding;
+      atlas.copy(image, left, top);
+      extrude(atlas, image, left, top);
+      m_rects[m_pending[i].name] = sf::IntRect(left, top, (int)size.x, (int)size.y);
+    }
+    m_pending.clear();
+    m_image_size = sf::Vector2u(width, height);
+    return m_texture.loadFromImage(atlas);
+  }
+
+  [[nodiscard]] const sf::Texture& texture() const { return m_texture; }
+  [[nodiscard]] sf::Texture& texture() { return m_texture; }
+  [[nodiscard]] sf::Vector2u size() const { return m_image_size; }
+  [[nodiscard]] bool contains(const std::string& name) const { return m_rects.count(name) > 0; }
+  [[nodiscard]] const std::map<std::string, sf::IntRect>& rects() const { return m_rects; }
+
+  /// where the named image is in the atlas. An empty rectangle if there is no such image
+  [[nodiscard]] sf::IntRect rect(const std::string& name) const {
+    auto it = m_rects.find(name);
+    return it == m_rects.end() ? sf::IntRect() : it->second;
+  }
+
+  /// a part of the named image, such as one frame from a sprite sheet
+  [[nodiscard]] sf::IntRect rect(const std::string& name, const sf::IntRect& sub_rect) const {
+    sf::IntRect r = rect(name);
+    return {r.left + sub_rect.left, r.top + sub_rect.top, sub_rect.width, sub_rect.height};
+  }
+
+  /// the size of a png from its header, without reading the rest. False if the file is not a png
+  static bool png_size(const std::string& path, unsigned& width, unsigned& height) {
+    /// the eight byte signature, then the IHDR chunk's length and type, then the width and height
+    unsigned char header[24];
+    std::ifstream file(path, std::ios::binary);
+    if (!file.read(reinterpret_cast<char*>(header), sizeof(header))) {
+      return false;
+    }
+    const unsigned char signature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+    if (std::memcmp(header, signature, 8) != 0 || std::memcmp(header + 12, "IHDR", 4) != 0) {
+      return false;
+    }
+    auto big_endian = [&](int at) { return (unsigned(header[at]) << 24) | (unsigned(header[at + 1]) << 16) | (unsigned(header[at + 2]) << 8) | header[at + 3]; };
+    width = big_endian(16);
+    height = big_endian(20);
+    return true;
+  }
+
+  /// the fraction of the atlas covered by images
+  [[nodiscard]] float occupancy() const {
+    double used = 0;
+    for (const auto& [name, r] : m_rects) {
+      used += double(r.width) * r.height;
+    }
+    double total = double(m_image_size.x) * m_image_size.y;
+    return total > 0 ? float(used / total) : 0.0f;
+  }
+
+ private:
+  struct Pending {
+    std::string name;
+    sf::Image image;
+  };
+
+  /// one span of the skyline, from x to x + width at height y
+  struct SkylineNode {
+    int x;
+    int y;
+    int width;
+  };
+
+  bool place_all(const std::vector<size_t>& order, std::vector<sf::Vector2i>& places, int width, int height) const {
+    std::vector<SkylineNode> skyline = {{0, 0, width}};
+    for (size_t i : order) {
+      sf::Vector2u size = m_pending[i].image.getSize();
+      int w = (int)size.x + 2 * m_padding;
+      int h = (int)size.y + 2 * m_padding;
+      int best_node = -1;
+      int best_y = height;
+      int best_width = width;
+      for (size_t n = 0; n < skyline.size(); n++) {
+        int y;
+        if (fits(skyline, n, w, h, width, height, y)) {
+          /// lowest wins, and the narrowest span if it is a tie
+          if (y < best_y || (y == best_y && skyline[n].width < best_width)) {
+            best_node = (int)n;
+            best_y = y;
+            best_width = skyline[n].width;
+          }
+        }
+      }
+      if (best_node < 0) {
+        return false;
+      }
+      places[i] = {skyline[best_node].x, best_y};
+      raise(skyline, best_node, w, best_y + h);
+    }
+    return true;
+  }
+
+  /// can a w x h rectangle sit on the skyline starting at node n? y gets the height it would sit at
+  static bool fits(const std::vector<SkylineNode>& skyline, size_t n, int w, int h, int width, int height, int& y) {
+    int x = skyline[n].x;
+    if (x + w > width) {
+      return false;
+    }
+    y = 0;
+    int remaining = w;
+    for (size_t k = n; remaining > 0; k++) {
+      if (k >= skyline.size()) {
+        return false;
+      }
+      y = std::max(y, skyline[k].y);
+      if (y + h > height) {
+        return false;
+      }
+      remaining -= skyline[k].width;
+    }
+    return true;
+  }
+
+  /// a new span at the new height over the rectangle, trimming or removing the spans under it
+  static void raise(std::vector<SkylineNode>& skyline, int n, int w, int top) {
+    SkylineNode node{skyline[n].x, top, w};
+    skyline.insert(skyline.begin() + n, node);
+    size_t k = n + 1;
+    while (k < skyline.size()) {
+      int overlap = node.x + node.width - skyline[k].x;
+      if (overlap <= 0) {
+        break;
+      }
+      skyline[k].x += overlap;
+      skyline[k].width -= overlap;
+      if (skyline[k].width > 0) {
+        break;
+      }
+      skyline.erase(skyline.begin() + (long)k);
+    }
+    /// join neighbours at the same height
+    for (size_t i = 0; i + 1 < skyline.size();) {
+      if (skyline[i].y == skyline[i + 1].y) {
+        skyline[i].width += skyline[i + 1].width;
+        skyline.erase(skyline.begin() + (long)i + 1);
+      } else {
+        i++;
+      }
+    }
+  }
+
+  /// copy the outermost pixels of the image out into its border
+  void extrude(sf::Image& atlas, const sf::Image& image, int left, int top) const {
+    sf::Vector2u size = image.getSize();
+    const int w = (int)size.x;
+    const int h = (int)size.y;
+    for (int p = 1; p <= m_padding; p++) {
+      for (int x = 0; x < w; x++) {
+        atlas.setPixel(left + x, top - p, image.getPixel(x, 0));
+        atlas.setPixel(left + x, top + h - 1 + p, image.getPixel(x, h - 1));
+      }
+      for (int y = -p; y < h + p; y++) {
+        int sy = std::clamp(y, 0, h - 1);
+        atlas.setPixel(left - p, top + y, image.getPixel(0, sy));
+        atlas.setPixel(left + w - 1 + p, top + y, image.getPixel(w - 1, sy));
+      }
+    }
+  }
+
+  int m_padding;
+  std::vector<Pending> m_pending;
+  std::map<std::string, sf::IntRect> m_rects;
+  sf::Vector2u m_image_size;
+  sf::Texture m_texture;
+};
+
+#endif  // IMGUI_SFML_STARTER_TEXTURE_ATLAS_H
@@ -0,0 +1,115 @@
+#ifndef IMGUI_SFML_STARTER_THREAD_POOL_H
+#define IMGUI_SFML_STARTER_THREAD_POOL_H
+
+#include <algorithm>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+/***
+ * A fixed set of worker threads that take tasks from a shared queue.
+ *
+ * This is the pool from 405-thread-pool made reusable. submit() hands back a
+ * std::future for the result of the task so the caller can wait for it, or
+ * just check now and then whether it is done.
+ *
+ *   ThreadPool pool(4);
+ *   std::future<sf::Image> image = pool.submit([] { sf::Image i; i.loadFromFile("big.png"); return i; });
+ *
+ * Tasks that are still queued when the pool is destroyed are run before the
+ * workers stop, so nothing that was submitted is ever lost.
+ */
+
+class ThreadPool {
+ public:
+  /// threads = 0 leaves one core for the main thread
+  explicit ThreadPool(size_t threads = 0) {
+    if (threads == 0) {
+      threads = std::max(2u, std::thread::hardware_concurrency()) - 1;
+    }
+    for (size_t i = 0; i < threads; ++i) {
+      m_workers.emplace_back([this] { work(); });
+    }
+  }
+
+  ~ThreadPool() {
+    {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      m_stop = true;
+    }
+    m_condition.notify_all();
+    for (std::thread& worker : m_workers) {
+      worker.join();
+    }
+  }
+
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  template <typename F>
+  std::future<std::invoke_result_t<F>> submit(F&& f) {
+    using Result = std::invoke_result_t<F>;
+    /// std::function must be copyable and a packaged_task is not, so share it
+    auto task = std::make_shared<std::packaged_task<Result()>>(std::forward<F>(f));
+    std::future<Result> result = task->get_future();
+    {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      if (m_stop) {
+        throw std::runtime_error("ThreadPool is stopped");
+      }
+      m_tasks.emplace([task] { (*task)(); });
+      m_busy++;
+    }
+    m_condition.notify_one();
+    return result;
+  }
+
+  /// block until every task submitted so far has finished
+  void wait_idle() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_idle.wait(lock, [this] { return m_busy == 0; });
+  }
+
+  [[nodiscard]] size_t size() const { return m_workers.size(); }
+
+ private:
+  void work() {
+    while (true) {
+      std::function<void()> task;
+      {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_condition.wait(lock, [this] { return m_stop || !m_tasks.empty(); });
+        if (m_stop && m_tasks.empty()) {
+          return;
+        }
+        task = std::move(m_tasks.front());
+        m_tasks.pop();
+      }
+      task();  // exceptions end up in the future, not here
+      {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_busy--;
+        if (m_busy == 0) {
+          m_idle.notify_all();
+        }
+      }
+    }
+  }
+
+  std::vector<std::thread> m_workers;
+  std::queue<std::function<void()>> m_tasks;
+  std::mutex m_mutex;
+  std::condition_variable m_condition;
+  std::condition_variable m_idle;
+  size_t m_busy = 0;  // queued or running
+  bool m_stop = false;
+};
+
+#endif  // IMGUI_SFML_STARTER_THREAD_POOL_H
@@ -0,0 +1,373 @@
+#ifndef IMGUI_SFML_STARTER_TILE_MAP_H
+#define IMGUI_SFML_STARTER_TILE_MAP_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "SFML/Graphics.hpp"
+#include "thread_pool.h"
+#include "view_culling.h"
+
+/***
+ * A big image cut into square tiles at several sizes, saved to disk once.
+ *
+ * Level 0 is the image at full size. Each level after that is half the width and
+ * height of the one before, down to a level that fits in one tile. Every level is cut
+ * into tiles, 256 pixels square by default. The tiles at the right and bottom
+ * edges are smaller when the image is not an exact number of tiles.
+ *
+ * Tiles go in a folder, one PNG per tile, with a small index file that records
+ * the size and date of the source image. open() uses the folder if it is up to
+ * date and builds it otherwise, which for a 3000x3000 map takes a second or so and
+ * only happens once.
+ *
+ * A whole level 0 never has to be a texture, so this works for images far bigger
+ * than the graphics card can hold. Use a TiledMapRenderer to draw it.
+ */
+
+class TilePyramid {
+ public:
+  bool open(const std::string& source, const std::string& cache_dir, unsigned tile_size = 256) {
+    m_dir = cache_dir;
+    m_tile = tile_size;
+    std::string stamp = source_stamp(source);
+    if (read_index(stamp)) {
+      return true;
+    }
+    sf::Image image;
+    if (!image.loadFromFile(source)) {
+      return false;
+    }
+    return build(image, stamp);
+  }
+
+  /// cut up an image that is already in memory. The stamp is saved in the index to tell if the tiles are out of date
+  bool build(const sf::Image& image, const std::string& stamp = "") {
+    namespace fs = std::filesystem;
+    m_width = image.getSize().x;
+    m_height = image.getSize().y;
+    if (m_width == 0 || m_height == 0 || m_tile == 0) {
+      return false;
+    }
+    m_levels = 1;
+    while (level_width(m_levels - 1) > m_tile || level_height(m_levels - 1) > m_tile) {
+      m_levels++;
+    }
+    std::error_code error;
+    fs::remove_all(m_dir, error);
+    /// the PNG encoding is the slow part, and each tile can be done on its own
+    ThreadPool pool;
+    std::vector<std::future<bool>> saved;
+    sf::Image level = image;
+    for (unsigned l = 0; l < m_levels; l++) {
+      fs::create_directories(fs::path(m_dir) / std::to_string(l), error);
+      if (error) {
+        return false;
+      }
+      if (l > 0) {
+        level = half_size(level);
+      }
+      for (unsigned ty = 0; ty < tiles_down(l); ty++) {
+        for (unsigned tx = 0; tx < tiles_across(l); tx++) {
+          sf::IntRect r = tile_rect(l, tx, ty);
+          sf::Image tile;
+          tile.create(r.width, r.height);
+          tile.copy(level, 0, 0, r);
+          saved.push_back(pool.submit([tile = std::move(tile), path = tile_path(l, tx, ty)]() { return tile.saveToFile(path); }));
+        }
+      }
+    }
+    bool ok = true;
+    for (auto& s : saved) {
+      ok = s.get() && ok;
+    }
+    return ok && write_index(stamp);
+  }
+
+  [[nodiscard]] std::string tile_path(unsigned level, unsigned tx, unsigned ty) const {
+    return m_dir + "/" + std::to_string(level) + "/" + std::to_string(tx) + "-" + std::to_string(ty) + ".png";
+  }
+
+  /// the pixels of one tile within its level
+  [[nodiscard]] sf::IntRect tile_rect(unsigned level, unsigned tx, unsigned ty) const {
+    int left = int(tx * m_tile);
+    int top = int(ty * m_tile);
+    int w = std::min(int(m_tile), int(level_width(level)) - left);
+    int h = std::min(int(m_tile), int(level_height(level)) - top);
+    return {left, top, w, h};
+  }
+
+  [[nodiscard]] unsigned level_width(unsigned level) const { return std::max(1u, (m_width + (1u << level) - 1) >> level); }
+  [[nodiscard]] unsigned level_height(unsigned level) const { return std::max(1u, (m_height + (1u << level) - 1) >> level); }
+  [[nodiscard]] unsigned tiles_across(unsigned level) const { return (level_width(level) + m_tile - 1) / m_tile; }
+  [[nodiscard]] unsigned tiles_down(unsigned level) const { return (level_height(level) + m_tile - 1) / m_tile; }
+  [[nodiscard]] unsigned levels() const { return m_levels; }
+  [[nodiscard]] unsigned tile_size() const { return m_tile; }
+  [[nodiscard]] sf::Vector2u size() const { return {m_width, m_height}; }
+
+ private:
+  /// the average of each 2x2 block. An odd last row or column is averaged with itself
+  static sf::Image half_size(const sf::Image& image) {
+    const unsigned w = image.getSize().x;
+    const unsigned h = image.getSize().y;
+    const unsigned hw = std::max(1u, (w + 1) / 2);
+    const unsigned hh = std::max(1u, (h + 1) / 2);
+    const sf::Uint8* src = image.getPixelsPtr();
+    std::vector<sf::Uint8> dst(size_t(hw) * hh * 4);
+    for (unsigned y = 0; y < hh; y++) {
+      const unsigned y0 = std::min(2 * y, h - 1);
+      const unsigned y1 = std::min(2 * y + 1, h - 1);
+      for (unsigned x = 0; x < hw; x++) {
+        const unsigned x0 = std::min(2 * x, w - 1);
+        const unsigned x1 = std::min(2 * x + 1, w - 1);
+        for (unsigned c = 0; c < 4; c++) {
+          unsigned sum = src[(size_t(y0) * w + x0) * 4 + c] + src[(size_t(y0) * w + x1) * 4 + c] + src[(size_t(y1) * w + x0) * 4 + c] +
+                         src[(size_t(y1) * w + x1) * 4 + c];
+          dst[(size_t(y) * hw + x) * 4 + c] = sf::Uint8((sum + 2) / 4);
+        }
+      }
+    }
+    sf::Image half;
+    half.create(hw, hh, dst.data());
+    return half;
+  }
+
+  /// changes if the source file is replaced or edited
+  static std::string source_stamp(const std::string& source) {
+    namespace fs = std::filesystem;
+    std::error_code error;
+    auto bytes = fs::file_size(source, error);
+    auto time = fs::last_write_time(source, error);
+    if (error) {
+      return "";
+    }
+    return source + " " + std::to_string(bytes) + " " + std::to_string(time.time_since_epoch().count());
+  }
+
+  [[nodiscard]] std::string index_path() const { return m_dir + "/pyramid.txt"; }
+
+  bool read_index(const std::string& stamp) {
+    std::ifstream file(index_path());
+    std::string magic;
+    std::string saved_stamp;
+    unsigned tile = 0;
+    if (!(file >> magic >> m_width >> m_height >> tile >> m_levels) || magic != "TILES1" || tile != m_tile) {
+      return false;
+    }
+    file >> std::ws;
+    std::getline(file, saved_stamp);
+    return !stamp.empty() && saved_stamp == stamp;
+  }
+
+  [[nodiscard]] bool write_index(const std::string& stamp) const {
+    std::ofstream file(index_path());
+    file << "TILES1 " << m_width << " " << m_height << " " << m_tile << " " << m_levels << "\n" << stamp << "\n";
+    return file.good();
+  }
+
+  std::string m_dir;
+  unsigned m_tile = 256;
+  unsigned m_width = 0;
+  unsigned m_height = 0;
+  unsigned m_levels = 0;
+};
+
+/***
+ * Draws the part of a TilePyramid that is inside the current view.
+ *
+ * Call update() once a frame with the view that the map will be drawn with. It picks
+ * the level whose pixels are closest to, but no smaller than, the pixels on the
+ * screen. So, zoomed right out, a handful of small tiles cover the whole map. Only
+ * the tiles that overlap the view are wanted, so the cost of a frame depends on
+ * the size of the window and not the size of the map.
+ *
+ * Wanted tiles are read from disk and decoded on worker threads. Up to
+ * max_uploads of them per frame become textures, and the most recently used
+ * textures are kept, up to a fixed number. The least recently used one makes way for each new one.
+ * While a tile is on its way, the same area is drawn, blurred, from the
+ * nearest coarser tile that is already loaded. The single tile at the top
+ * level is fetched first, and never evicted, so there is always something to show.
+ */
+
+class TiledMapRenderer : public sf::Drawable {
+ public:
+  explicit TiledMapRenderer(const TilePyramid& pyramid, size_t capacity = 256, size_t threads = 2)
+      : m_pyramid(pyramid), m_capacity(capacity), m_pool(threads) {}
+
+  int max_uploads = 8;  // new textures per frame
+  int max_requests = 32;  // tiles being read at once. Zooming and panning quickly can ask for lots
+
+  void update(const sf::View& view, sf::Vector2u target_size) {
+    m_draw_list.clear();
+    const unsigned levels = m_pyramid.levels();
+    if (levels == 0) {
+      return;
+    }
+    /// the top tile stands in for everything else, so touch it every frame to keep it out of the way of the eviction
+    if (!touch(key(levels - 1, 0, 0))) {
+      request(levels - 1, 0, 0);
+    }
+
+    /// map units per screen pixel chooses the level
+    sf::FloatRect port = view.getViewport();
+    float screen_pixels = std::max(1.0f, port.width * (float)target_size.x);
+    float map_per_pixel = view.getSize().x / screen_pixels;
+    int level = map_per_pixel > 1 ? (int)std::floor(std::log2(map_per_pixel)) : 0;
+    m_level = (unsigned)std::clamp(level, 0, (int)levels - 1);
+
+    /// the tiles under the view, at that level
+    const float tile_world = float(m_pyramid.tile_size() << m_level);
+    sf::FloatRect seen = view_bounds(view);
+    int x0 = std::max(0, (int)std::floor(seen.left / tile_world));
+    int y0 = std::max(0, (int)std::floor(seen.top / tile_world));
+    int x1 = std::min((int)m_pyramid.tiles_across(m_level) - 1, (int)std::floor((seen.left + seen.width) / tile_world));
+    int y1 = std::min((int)m_pyramid.tiles_down(m_level) - 1, (int)std::floor((seen.top + seen.height) / tile_world));
+    m_visible = (x1 >= x0 && y1 >= y0) ? size_t(x1 - x0 + 1) * size_t(y1 - y0 + 1) : 0;
+    /// never evict a tile that is needed for this frame
+    m_capacity = std::max(m_capacity, 2 * m_visible + max_uploads + levels);
+
+    for (int ty = y0; ty <= y1; ty++) {
+      for (int tx = x0; tx <= x1; tx++) {
+        if (!touch(key(m_level, tx, ty))) {
+          request(m_level, tx, ty);
+        }
+      }
+    }
+    upload_arrivals();
+
+    /// everything the cache changes has been done so the textures are safe to point to
+    m_drawn = 0;
+    m_fallbacks = 0;
+    for (int ty = y0; ty <= y1; ty++) {
+      for (int tx = x0; tx <= x1; tx++) {
+        add_to_draw_list(m_level, (unsigned)tx, (unsigned)ty);
+      }
+    }
+  }
+
+  [[nodiscard]] unsigned level() const { return m_level; }
+  [[nodiscard]] size_t visible() const { return m_visible; }          // tiles in view
+  [[nodiscard]] size_t drawn() const { return m_drawn; }              // tiles drawn at the right level
+  [[nodiscard]] size_t fallbacks() const { return m_fallbacks; }      // tiles stood in for by a coarser level
+  [[nodiscard]] size_t cached() const { return m_tiles.size(); }      // textures held
+  [[nodiscard]] size_t pending() const { return m_requests.size(); }  // tiles being read
+  [[nodiscard]] size_t capacity() const { return m_capacity; }
+
+ private:
+  struct Tile {
+    uint64_t key;
+    sf::Texture texture;
+  };
+
+  struct DrawItem {
+    const sf::Texture* texture;
+    sf::IntRect rect;     // part of the texture
+    sf::Vector2f position;
+    float scale;
+  };
+
+  static uint64_t key(unsigned level, unsigned tx, unsigned ty) { return (uint64_t(level) << 48) | (uint64_t(ty) << 24) | tx; }
+
+  /// move a cached tile to the front of the queue. false if it is not cached
+  bool touch(uint64_t k) {
+    auto found = m_index.find(k);
+    if (found == m_index.end()) {
+      return false;
+    }
+    m_tiles.splice(m_tiles.begin(), m_tiles, found->second);
+    return true;
+  }
+
+  void request(unsigned level, unsigned tx, unsigned ty) {
+    uint64_t k = key(level, tx, ty);
+    if (m_index.count(k) || m_requests.count(k) || (int)m_requests.size() >= max_requests) {
+      return;
+    }
+    m_requests[k] = m_pool.submit([path = m_pyramid.tile_path(level, tx, ty)]() {
+      sf::Image image;
+      image.loadFromFile(path);
+      return image;
+    });
+  }
+
+  void upload_arrivals() {
+    int uploads = 0;
+    for (auto it = m_requests.begin(); it != m_requests.end() && uploads < max_uploads;) {
+      if (it->second.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+        ++it;
+        continue;
+      }
+      sf::Image image = it->second.get();
+      if (image.getSize().x > 0) {
+        m_tiles.push_front({it->first, sf::Texture()});
+        m_tiles.front().texture.loadFromImage(image);
+        m_index[it->first] = m_tiles.begin();
+        uploads++;
+      }
+      it = m_requests.erase(it);
+    }
+    while (m_tiles.size() > m_capacity) {
+      m_index.erase(m_tiles.back().key);
+      m_tiles.pop_back();
+    }
+  }
+
+  /// the tile if it is loaded, or the matching part of the closest coarser tile that is
+  void add_to_draw_list(unsigned level, unsigned tx, unsigned ty) {
+    const unsigned tile = m_pyramid.tile_size();
+    sf::IntRect r = m_pyramid.tile_rect(level, tx, ty);
+    for (unsigned up = 0; level + up < m_pyramid.levels(); up++) {
+      unsigned l = level + up;
+      auto found = m_index.find(key(l, tx >> up, ty >> up));
+      if (found == m_index.end()) {
+        continue;
+      }
+      /// this tile's pixels, in the coarser tile's pixels
+      int left = int((tx & ((1u << up) - 1)) * (tile >> up));
+      int top = int((ty & ((1u << up) - 1)) * (tile >> up));
+      int w = std::max(1, r.width >> up);
+      int h = std::max(1, r.height >> up);
+      float scale = float(1u << l);
+      sf::Vector2f position(float(r.left << level), float(r.top << level));
+      m_draw_list.push_back({&found->second->texture, {left, top, w, h}, position, scale});
+      if (up == 0) {
+        m_drawn++;
+      } else {
+        m_fallbacks++;
+      }
+      return;
+    }
+  }
+
+  void draw(sf::RenderTarget& target, sf::RenderStates states) const override {
+    sf::Sprite sprite;
+    for (const DrawItem& item : m_draw_list) {
+      sprite.setTexture(*item.texture);
+      sprite.setTextureRect(item.rect);
+      sprite.setPosition(item.position);
+      sprite.setScale(item.scale, item.scale);
+      target.draw(sprite, states);
+    }
+  }
+
+  const TilePyramid& m_pyramid;
+  size_t m_capacity;
+  std::list<Tile> m_tiles;  // most recently used first. A list so the textures never move
+  std::unordered_map<uint64_t, std::list<Tile>::iterator> m_index;
+  std::unordered_map<uint64_t, std::future<sf::Image>> m_requests;
+  std::vector<DrawItem> m_draw_list;
+  unsigned m_level = 0;
+  size_t m_visible = 0;
+  size_t m_drawn = 0;
+  size_t m_fallbacks = 0;
+  ThreadPool m_pool;  // last, so the workers stop before the requests they fill are destroyed
+};
+
+#endif  // IMGUI_SFML_STARTER_TILE_MAP_H
@@ -7,6 +7,8 @@
 
 #include <SFML/Graphics.hpp>
 #include <cmath>
+#include "angle.h"
+#include "vec2.h"
 
 inline float exponential_filter(float var, float new_value, float alpha = 0.5) {
   var = alpha * var + (1 - alpha) * new_value;
@@ -15,9 +17,7 @@ inline float exponential_filter(float var, float new_value, float alpha = 0.5) {
 
 // Returns distance between points
 inline float distance(const sf::Vector2f& a, const sf::Vector2f& b) {
-  float dx = a.x - b.x;
-  float dy = a.y - b.y;
-  return std::sqrt(dx * dx + dy * dy);
+  return getDistance(a, b);
 }
 
 inline bool isWithinBounds(const sf::Vector2u& size, int x, int y) {
@@ -34,14 +34,8 @@ inline sf::Color getColorAtPixel(const sf::Image& image, sf::Vector2f point) {
   return isWithinBounds(image.getSize(), x, y) ? image.getPixel(x, y) : sf::Color::Transparent;
 }
 
+/// angle in degrees, like sf::Transformable
 inline sf::Vector2f rotatePoint(const sf::Vector2f& point, const sf::Vector2f& center, float angle) {
-  // Convert angle from degrees to radians
-  float radian = angle * (3.14159265 / 180.0);
-
-  // Calculate the new x and y positions using the rotation matrix
-  float newX = std::cos(radian) * (point.x - center.x) - std::sin(radian) * (point.y - center.y) + center.x;
-  float newY = std::sin(radian) * (point.x - center.x) + std::cos(radian) * (point.y - center.y) + center.y;
-
-  return sf::Vector2f(newX, newY);
+  return (Vec2(point) - center).rotated(trig::radians(angle)) + center;
 }
 #endif  // IMGUI_SFML_STARTER_UTILS_H
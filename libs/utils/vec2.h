@@ -1,84 +1,200 @@
-//
-// Created by peter on 18/11/24.
-//
+#ifndef IMGUI_SFML_STARTER_VEC2_H
+#define IMGUI_SFML_STARTER_VEC2_H
 
-#ifndef VEC2_H
-#define VEC2_H
-
-#include <SFML/Graphics.hpp>
+#include <SFML/System/Vector2.hpp>
+#include <algorithm>
+#include <bit>
 #include <cmath>
+#include <concepts>
+#include <cstdint>
+#include <limits>
+#include <ranges>
+#include <span>
+
+/***
+ * 2D vector maths for everything that works in the plane.
+ *
+ * Vec2 is two floats, like sf::Vector2f, and converts to and from one for
+ * free, so code can use whichever it is given. Everything that does not need
+ * SFML or the maths library is constexpr. Unlike PVector nothing asserts:
+ * dividing by zero gives infinity as floats do, and normalizing a zero vector
+ * gives a zero vector.
+ *
+ * The functions in the vec2 namespace fill or normalize a whole span of vectors
+ * at once. They take spans of anything with x and y members, and have overloads
+ * for std::vector, std::array and other contiguous containers, so a std::vector
+ * of sf::Vector2f, Vec2 or PVector can be passed as it is without copying. The
+ * sensor fans in 015 and the collision axes in collisions.h use them.
+ *
+ * Where a length is only compared with another, compare length_sq() and save the
+ * square root. Precision::Fast swaps the square root and divide for an approximate
+ * reciprocal square root and one Newton step, good to about 0.2%.
+ *
+ * Angles are in radians. sf::Transformable and utils.h rotatePoint() use degrees.
+ */
 
 struct Vec2 {
-  float x, y;
+  float x = 0;
+  float y = 0;
 
-  Vec2() : x(0.0f), y(0.0f) {}
-  Vec2(float x_, float y_) : x(x_), y(y_) {}
+  constexpr Vec2() = default;
+  constexpr Vec2(float x_, float y_) : x(x_), y(y_) {}
   Vec2(const sf::Vector2f& v) : x(v.x), y(v.y) {}
-  Vec2(const sf::Vector2i& v) : x(v.x), y(v.y) {}
-  Vec2(const sf::Vector2u& v) : x(v.x), y(v.y) {}
+  Vec2(const sf::Vector2i& v) : x((float)v.x), y((float)v.y) {}
+  Vec2(const sf::Vector2u& v) : x((float)v.x), y((float)v.y) {}
+
+  operator sf::Vector2f() const { return {x, y}; }
+  operator sf::Vector2i() const { return {(int)x, (int)y}; }
+  /// POTENTIALLY DANGEROUS - DROPS SIGN
+  explicit operator sf::Vector2u() const { return {(unsigned)x, (unsigned)y}; }
 
-  /// convert to sf::Vector2f
-  operator sf::Vector2f() const { return sf::Vector2f(x, y); }
-  /// convert to sf::Vector2i
-  operator sf::Vector2i() const { return sf::Vector2i((int)x, (int)y); }
-  /// convert to sf::Vector2u  - POTENTIALLY DANGEROUS - DROPS SIGN
-  operator sf::Vector2u() const { return sf::Vector2u((unsigned int)x, (unsigned int)y); }
+  static Vec2 from_angle(float radians) { return {std::cos(radians), std::sin(radians)}; }
 
-  void operator+=(const Vec2& v) {
+  constexpr Vec2& operator+=(const Vec2& v) {
     x += v.x;
     y += v.y;
+    return *this;
   }
-
-  void operator-=(const Vec2& v) {
+  constexpr Vec2& operator-=(const Vec2& v) {
     x -= v.x;
     y -= v.y;
+    return *this;
+  }
+  constexpr Vec2& operator*=(float f) {
+    x *= f;
+    y *= f;
+    return *this;
+  }
+  constexpr Vec2& operator/=(float f) {
+    x /= f;
+    y /= f;
+    return *this;
   }
 
-  float length() const { return sqrt(x * x + y * y); }
-
-  Vec2 getNormalized() const {
-    const float len = length();
-    return Vec2(x / len, y / len);
+  [[nodiscard]] constexpr float length_sq() const { return x * x + y * y; }
+  [[nodiscard]] float length() const { return std::sqrt(x * x + y * y); }
+  [[nodiscard]] float angle() const { return std::atan2(y, x); }
+
+  /// the same direction with a length of one, or zero if there is no direction
+  [[nodiscard]] Vec2 normalized() const {
+    const float len_sq = length_sq();
+    if (len_sq <= std::numeric_limits<float>::min()) {
+      return {};
+    }
+    const float r = 1.0f / std::sqrt(len_sq);
+    return {x * r, y * r};
   }
 
-  Vec2 normal() const { return Vec2(-y, x); }
+  /// kept for older code
+  [[nodiscard]] Vec2 getNormalized() const { return normalized(); }
+
+  /// a quarter turn anticlockwise in maths axes, which is clockwise on the screen because y points down
+  [[nodiscard]] constexpr Vec2 normal() const { return {-y, x}; }
+
+  /// rotation by an angle whose cosine and sine are already known
+  [[nodiscard]] constexpr Vec2 rotated(float c, float s) const { return {c * x - s * y, s * x + c * y}; }
+  [[nodiscard]] Vec2 rotated(float radians) const { return rotated(std::cos(radians), std::sin(radians)); }
 };
 
-inline Vec2 operator+(const Vec2& v1, const Vec2& v2) {
-  return Vec2(v1.x + v2.x, v1.y + v2.y);
+constexpr Vec2 operator+(const Vec2& a, const Vec2& b) { return {a.x + b.x, a.y + b.y}; }
+constexpr Vec2 operator-(const Vec2& a, const Vec2& b) { return {a.x - b.x, a.y - b.y}; }
+constexpr Vec2 operator-(const Vec2& v) { return {-v.x, -v.y}; }
+constexpr Vec2 operator*(const Vec2& v, float f) { return {v.x * f, v.y * f}; }
+constexpr Vec2 operator*(float f, const Vec2& v) { return {v.x * f, v.y * f}; }
+constexpr Vec2 operator/(const Vec2& v, float f) { return {v.x / f, v.y / f}; }
+
+constexpr float dot(const Vec2& a, const Vec2& b) { return a.x * b.x + a.y * b.y; }
+/// positive if b is anticlockwise from a in maths axes
+constexpr float cross(const Vec2& a, const Vec2& b) { return a.x * b.y - a.y * b.x; }
+constexpr float distance_sq(const Vec2& a, const Vec2& b) { return (a - b).length_sq(); }
+constexpr Vec2 lerp(const Vec2& a, const Vec2& b, float t) { return a + (b - a) * t; }
+inline float getDistance(const Vec2& a, const Vec2& b) { return (a - b).length(); }
+
+/// the point on the segment from v to w that is closest to p
+constexpr Vec2 closest_point_on_segment(const Vec2& v, const Vec2& w, const Vec2& p) {
+  const Vec2 line = w - v;
+  const float l2 = line.length_sq();
+  if (l2 <= std::numeric_limits<float>::epsilon()) {
+    return v;  // v == w
+  }
+  /// the projection of p onto the line through v and w is v + t(w - v). Clamping t keeps it on the segment
+  const float t = std::clamp(dot(p - v, line) / l2, 0.0f, 1.0f);
+  return v + line * t;
 }
 
-inline Vec2 operator-(const Vec2& v1, const Vec2& v2) {
-  return Vec2(v1.x - v2.x, v1.y - v2.y);
+/// minimum distance between line segment vw and point p
+inline float minimum_distance(const Vec2& v, const Vec2& w, const Vec2& p) { return getDistance(p, closest_point_on_segment(v, w, p)); }
+
+/***
+ * An approximate 1/sqrt(x), from the bits of the float and one Newton step.
+ * Good to about 0.2% which is plenty for normalizing a direction. Not for x <= 0.
+ */
+constexpr float rsqrt_fast(float x) {
+  const float half = 0.5f * x;
+  float r = std::bit_cast<float>(0x5f375a86u - (std::bit_cast<uint32_t>(x) >> 1));
+  r = r * (1.5f - half * r * r);
+  return r;
 }
 
-inline Vec2 operator*(const Vec2& v, float f) {
-  return Vec2(v.x * f, v.y * f);
+enum class Precision { Exact, Fast };
+
+template <typename V>
+concept XY = requires(V v) {
+  { v.x } -> std::convertible_to<float>;
+  { v.y } -> std::convertible_to<float>;
+};
+
+namespace vec2 {
+
+/***
+ * Unit vectors at first, first + step, first + 2 step ... as in the rays of a
+ * sensor fan. Each one is the last turned by step, so there is only one sine and
+ * cosine for the lot. The error grows by about one part in ten million per vector.
+ */
+template <XY V>
+void directions(std::span<V> out, float first, float step) {
+  const float c = std::cos(step);
+  const float s = std::sin(step);
+  Vec2 d = Vec2::from_angle(first);
+  for (V& v : out) {
+    v.x = d.x;
+    v.y = d.y;
+    d = d.rotated(c, s);
+  }
 }
 
-inline float dot(const Vec2& v1, const Vec2& v2) {
-  return v1.x * v2.x + v1.y * v2.y;
+/// zero vectors are left as they are
+template <XY V>
+void normalize(std::span<V> vectors, Precision precision = Precision::Exact) {
+  for (V& v : vectors) {
+    const float len_sq = v.x * v.x + v.y * v.y;
+    if (len_sq > std::numeric_limits<float>::min()) {
+      const float r = precision == Precision::Fast ? rsqrt_fast(len_sq) : 1.0f / std::sqrt(len_sq);
+      v.x *= r;
+      v.y *= r;
+    }
+  }
 }
 
-inline float getDistance(const Vec2& v1, const Vec2& v2) {
-  return (v1 - v2).length();
+/***
+ * The same again for a std::vector, std::array or anything else that holds its
+ * vectors in one block. A std::span<V> cannot be deduced from those, so these
+ * make the span and pass it on.
+ */
+template <typename R>
+concept XYRange = std::ranges::contiguous_range<R> && std::ranges::sized_range<R> && XY<std::ranges::range_value_t<R>> &&
+                  !requires { std::remove_cvref_t<R>::extent; };  // a span already has its own overload
+
+template <XYRange R>
+void directions(R&& out, float first, float step) {
+  directions(std::span<std::ranges::range_value_t<R>>(out), first, step);
 }
 
-// line is from v-wchar_t
-// point is p
-inline float minimum_distance(Vec2 v, Vec2 w, Vec2 p) {
-  // Return minimum distance between line segment vw and point p
-  Vec2 line = w - v;
-  const float l2 = line.length();  // i.e. |w-v|^2 -  avoid a sqrt
-  if (std::fabs(l2) <= std::numeric_limits<float>::epsilon())
-    return getDistance(p, v);  // v == w case
-  // Consider the line extending the segment, parameterized as v + t (w - v).
-  // We find projection of point p onto the line.
-  // It falls where t = [(p-v) . (w-v)] / |w-v|^2
-  // We clamp t from [0,1] to handle points outside the segment vw.
-  const float t = std::max(0.0f, std::min(1.0f, dot(p - v, w - v) / l2));
-  const Vec2 projection = v + line * t;  // Projection falls on the segment
-  return getDistance(p, projection);
+template <XYRange R>
+void normalize(R&& vectors, Precision precision = Precision::Exact) {
+  normalize(std::span<std::ranges::range_value_t<R>>(vectors), precision);
 }
 
+}  // namespace vec2
+
 #endif  // IMGUI_SFML_STARTER_VEC2_H
@@ -0,0 +1,185 @@
+#ifndef IMGUI_SFML_STARTER_VIEW_CULLING_H
+#define IMGUI_SFML_STARTER_VIEW_CULLING_H
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include "SFML/Graphics.hpp"
+
+/***
+ * The area of the world that a view can see, as an axis aligned box. A rotated
+ * view sees a rotated rectangle, so the box is the one that just encloses it.
+ */
+inline sf::FloatRect view_bounds(const sf::View& view) {
+  sf::Vector2f half = view.getSize() / 2.0f;
+  float radians = view.getRotation() * 3.14159265f / 180.0f;
+  float c = std::abs(std::cos(radians));
+  float s = std::abs(std::sin(radians));
+  float ex = c * half.x + s * half.y;
+  float ey = s * half.x + c * half.y;
+  sf::Vector2f centre = view.getCenter();
+  return {centre.x - ex, centre.y - ey, 2 * ex, 2 * ey};
+}
+
+struct CullStats {
+  size_t visible = 0;
+  size_t culled = 0;
+};
+
+/***
+ * Keeps track of where everything in a scene is so that each view draws only what it can see.
+ *
+ * SFML draws whatever it is given and lets the graphics card throw away the
+ * parts outside the view. That still costs a draw call and all the vertices for every
+ * object, in every view. A minimap that shows a tiny corner of the world costs as much
+ * as the main view.
+ *
+ * Objects are added with their bounding box, and the ViewCuller files them in a grid of
+ * square cells covering the world. cull() looks only in the cells under the view,
+ * so its cost depends on what the view shows and not on how big the scene is. Objects
+ * that move must be given their new bounds with update().
+ *
+ *   ViewCuller culler({0, 0, 960, 960}, 120);
+ *   int robot_id = culler.add(robot.getGlobalBounds(), &robot);
+ *   ...
+ *   culler.update(robot_id, robot.getGlobalBounds());
+ *   CullStats main_stats = culler.draw(window, main_view);
+ *   CullStats mini_stats = culler.draw(window, mini_view);
+ *
+ * Visible objects come out in the order they were added, which is the order they are drawn,
+ * so add the background first. One index serves any number of views. Anything outside the
+ * world rectangle is filed in the nearest edge cell, so it still works, only slower.
+ */
+
+class ViewCuller {
+ public:
+  ViewCuller(const sf::FloatRect& world, float cell_size) : m_world(world), m_cell_size(std::max(1.0f, cell_size)) {
+    m_columns = std::max(1, (int)std::ceil(world.width / m_cell_size));
+    m_rows = std::max(1, (int)std::ceil(world.height / m_cell_size));
+    m_cells.resize(size_t(m_columns) * m_rows);
+  }
+
+  /// drawable may be null for objects the caller draws itself from the ids
+  int add(const sf::FloatRect& bounds, const sf::Drawable* drawable = nullptr) {
+    int id = (int)m_objects.size();
+    m_objects.push_back({bounds, drawable, cell_range(bounds), true});
+    insert(id);
+    m_alive++;
+    return id;
+  }
+
+  void update(int id, const sf::FloatRect& bounds) {
+    Object& object = m_objects[id];
+    object.bounds = bounds;
+    CellRange range = cell_range(bounds);
+    if (range == object.cells) {
+      return;
+    }
+    erase(id);
+    object.cells = range;
+    insert(id);
+  }
+
+  /// ids are not reused, so the drawing order of everything else stays the same
+  void remove(int id) {
+    if (!m_objects[id].alive) {
+      return;
+    }
+    erase(id);
+    m_objects[id].alive = false;
+    m_alive--;
+  }
+
+  /// the ids of everything that overlaps the area, in the order they were added
+  CullStats cull(const sf::FloatRect& area, std::vector<int>& visible) const {
+    visible.clear();
+    CellRange q = cell_range(area);
+    for (int cy = q.y0; cy <= q.y1; cy++) {
+      for (int cx = q.x0; cx <= q.x1; cx++) {
+        for (int id : m_cells[size_t(cy) * m_columns + cx]) {
+          const Object& object = m_objects[id];
+          /// an object in several cells is only reported from the first cell that the area shares with it
+          if (cx != std::max(q.x0, object.cells.x0) || cy != std::max(q.y0, object.cells.y0)) {
+            continue;
+          }
+          if (object.bounds.intersects(area)) {
+            visible.push_back(id);
+          }
+        }
+      }
+    }
+    std::sort(visible.begin(), visible.end());
+    return {visible.size(), m_alive - visible.size()};
+  }
+
+  CullStats cull(const sf::View& view, std::vector<int>& visible) const { return cull(view_bounds(view), visible); }
+
+  /// set the view and draw what it can see
+  CullStats draw(sf::RenderTarget& target, const sf::View& view, sf::RenderStates states = sf::RenderStates::Default) {
+    CullStats stats = cull(view, m_visible);
+    target.setView(view);
+    for (int id : m_visible) {
+      if (m_objects[id].drawable) {
+        target.draw(*m_objects[id].drawable, states);
+      }
+    }
+    return stats;
+  }
+
+  [[nodiscard]] size_t size() const { return m_alive; }
+  [[nodiscard]] const sf::FloatRect& bounds(int id) const { return m_objects[id].bounds; }
+
+ private:
+  struct CellRange {
+    int x0, y0, x1, y1;
+    bool operator==(const CellRange& other) const { return x0 == other.x0 && y0 == other.y0 && x1 == other.x1 && y1 == other.y1; }
+  };
+
+  struct Object {
+    sf::FloatRect bounds;
+    const sf::Drawable* drawable;
+    CellRange cells;
+    bool alive;
+  };
+
+  [[nodiscard]] int column(float x) const { return std::clamp((int)std::floor((x - m_world.left) / m_cell_size), 0, m_columns - 1); }
+  [[nodiscard]] int row(float y) const { return std::clamp((int)std::floor((y - m_world.top) / m_cell_size), 0, m_rows - 1); }
+
+  [[nodiscard]] CellRange cell_range(const sf::FloatRect& r) const {
+    return {column(r.left), row(r.top), column(r.left + r.width), row(r.top + r.height)};
+  }
+
+  void insert(int id) {
+    const CellRange& c = m_objects[id].cells;
+    for (int cy = c.y0; cy <= c.y1; cy++) {
+      for (int cx = c.x0; cx <= c.x1; cx++) {
+        m_cells[size_t(cy) * m_columns + cx].push_back(id);
+      }
+    }
+  }
+
+  void erase(int id) {
+    const CellRange& c = m_objects[id].cells;
+    for (int cy = c.y0; cy <= c.y1; cy++) {
+      for (int cx = c.x0; cx <= c.x1; cx++) {
+        auto& cell = m_cells[size_t(cy) * m_columns + cx];
+        auto it = std::find(cell.begin(), cell.end(), id);
+        if (it != cell.end()) {
+          *it = cell.back();
+          cell.pop_back();
+        }
+      }
+    }
+  }
+
+  sf::FloatRect m_world;
+  float m_cell_size;
+  int m_columns = 1;
+  int m_rows = 1;
+  std::vector<std::vector<int>> m_cells;
+  std::vector<Object> m_objects;
+  std::vector<int> m_visible;  // reused by draw()
+  size_t m_alive = 0;
+};
+
+#endif  // IMGUI_SFML_STARTER_VIEW_CULLING_H
@@ -1,16 +1,48 @@
 #include <SFML/Graphics.hpp>
+#include <algorithm>
+#include <chrono>
 #include <iomanip>
 #include <iostream>
 #include <sstream>
+#include "frame_pacer.h"
+#include "imgui-SFML.h"
+#include "imgui.h"
+#include "implot.h"
 
 /***
- * This program just  displays the window's frame rate.
+ * This program displays the window's frame rate, and how evenly the frames come.
  *
- * Experiment with the frame rate setting just after opening the window to see the effect.
+ * Choose how the frames are paced in the window and watch the frame times, their
+ * percentiles and the histogram. A bar moves across the window at a steady speed
+ * so that uneven frames can be seen as well as measured.
+ *
+ * Input to display is the time from reading the events to the end of display().
+ * It is the part of the input lag that the program controls.
+ *
+ * The simulation can be run at a rate of its own, in fixed steps, with the bar
+ * drawn part way between the last two steps so that it still moves smoothly.
  * @return
  */
+
+enum class Pacing { FramerateLimit, VSync, Sleep, SleepAndSpin };
+const char* PACING_NAMES[] = {"setFramerateLimit", "VSync", "FramePacer, sleep only", "FramePacer, sleep and spin"};
+
+/// the bar that the simulation moves back and forth
+struct Bar {
+  float x = 0;
+  float speed = 600;  // pixels per second
+};
+
+void step(Bar& bar, float dt, float width) {
+  bar.x += bar.speed * dt;
+  if (bar.x < 0 || bar.x > width) {
+    bar.speed = -bar.speed;
+    bar.x = std::clamp(bar.x, 0.0f, width);
+  }
+}
+
 int main() {
-  sf::RenderWindow window(sf::VideoMode(600, 100), "Frame Rate Example", sf::Style::Close);
+  sf::RenderWindow window(sf::VideoMode(1000, 760), "Frame Rate Example", sf::Style::Close);
 
   /**
    * The refresh can be set either as a fixed number of frames per second or
@@ -36,9 +68,25 @@ int main() {
    *    - the manually set frame rate
    *
    * It is not clear what happens if you have two monitors running at difference refresh rates.
+   *
+   * The FramePacer (see frame_pacer.h) does the waiting itself, before the events are read,
+   * so it needs both of these off.
    */
-  window.setFramerateLimit(100);
-  window.setVerticalSyncEnabled(true);
+  Pacing pacing = Pacing::SleepAndSpin;
+  int frame_rate = 120;
+  FramePacer pacer(frame_rate);
+  auto apply_pacing = [&]() {
+    window.setVerticalSyncEnabled(pacing == Pacing::VSync);
+    window.setFramerateLimit(pacing == Pacing::FramerateLimit ? frame_rate : 0);
+    pacer.set_rate(frame_rate);
+    pacer.set_spin(pacing == Pacing::SleepAndSpin);
+  };
+  apply_pacing();
+
+  if (!ImGui::SFML::Init(window)) {
+    return -1;
+  }
+  ImPlot::CreateContext();
 
   sf::Font font;
   /// This will generate an error message to stderr if it fails
@@ -50,32 +98,162 @@ int main() {
   text.setFillColor(sf::Color::White);
   text.setPosition(10, 10);
 
+  const float bar_width = 16;
+  const float track_width = (float)window.getSize().x - bar_width;
+  sf::RectangleShape bar_shape(sf::Vector2f(bar_width, 80));
+  bar_shape.setFillColor(sf::Color::Yellow);
+
+  /// the simulation runs in fixed steps at its own rate when decoupled, else one step a frame
+  bool decoupled = false;
+  bool interpolate = true;
+  int sim_rate = 50;
+  float time_accumulator = 0;
+  Bar bar;
+  Bar previous_bar;
+
+  FrameStats frame_times;
+  FrameStats latencies;
+  using steady_clock = std::chrono::steady_clock;
+  auto last_frame = steady_clock::now();
+
   sf::Clock clock;
   int frame_count = 0;
-  int frame_interval = 20;
 
   while (window.isOpen()) {
+    if (pacing == Pacing::Sleep || pacing == Pacing::SleepAndSpin) {
+      pacer.wait();
+    }
+    const auto frame_start = steady_clock::now();
+    const float frame_ms = std::chrono::duration<float, std::milli>(frame_start - last_frame).count();
+    last_frame = frame_start;
+    frame_times.add(frame_ms);
+
     sf::Event event{};
     while (window.pollEvent(event)) {
+      ImGui::SFML::ProcessEvent(window, event);
       if (event.type == sf::Event::Closed)
         window.close();
     }
+    const auto input_time = steady_clock::now();
+
+    const float dt = frame_ms / 1000.0f;
+    ImGui::SFML::Update(window, sf::seconds(dt));
+
+    float bar_x;
+    if (decoupled) {
+      const float sim_step = 1.0f / (float)sim_rate;
+      time_accumulator = std::min(time_accumulator + dt, 0.1f);
+      while (time_accumulator >= sim_step) {
+        previous_bar = bar;
+        step(bar, sim_step, track_width);
+        time_accumulator -= sim_step;
+      }
+      /// how far through the next step we are. Without this the bar only moves at the simulation rate
+      const float t = interpolate ? time_accumulator / sim_step : 1.0f;
+      bar_x = previous_bar.x + (bar.x - previous_bar.x) * t;
+    } else {
+      step(bar, dt, track_width);
+      bar_x = bar.x;
+    }
+    bar_shape.setPosition(bar_x, 90);
 
     frame_count++;
     float elapsed = clock.getElapsedTime().asSeconds();
     if (elapsed > 0.5f) {
       std::ostringstream ss;
-      float frame_rate = static_cast<float>(frame_count) / elapsed;
-      ss << "Frame Rate: " << std::fixed << std::setprecision(2) << frame_rate;
+      float measured_rate = static_cast<float>(frame_count) / elapsed;
+      ss << "Frame Rate: " << std::fixed << std::setprecision(2) << measured_rate;
       text.setString(ss.str());
       frame_count = 0;
       clock.restart();
     }
 
+    ImGui::SetNextWindowPos(ImVec2(10, 190), ImGuiCond_Once);
+    ImGui::SetNextWindowSize(ImVec2(980, 560), ImGuiCond_Once);
+    ImGui::Begin("Frame pacing");
+    bool changed = false;
+    int choice = (int)pacing;
+    for (int i = 0; i < 4; i++) {
+      changed |= ImGui::RadioButton(PACING_NAMES[i], &choice, i);
+      ImGui::SameLine();
+    }
+    pacing = (Pacing)choice;
+    ImGui::NewLine();
+    changed |= ImGui::SliderInt("frame rate", &frame_rate, 30, 240);
+    for (int rate : {60, 120, 144, 240}) {
+      ImGui::SameLine();
+      if (ImGui::Button(std::to_string(rate).c_str())) {
+        frame_rate = rate;
+        changed = true;
+      }
+    }
+    if (changed) {
+      apply_pacing();
+      frame_times.clear();
+      latencies.clear();
+    }
+    ImGui::Checkbox("Decouple the simulation", &decoupled);
+    if (decoupled) {
+      ImGui::SameLine();
+      ImGui::SetNextItemWidth(200);
+      ImGui::SliderInt("simulation rate", &sim_rate, 10, 500);
+      ImGui::SameLine();
+      ImGui::Checkbox("interpolate", &interpolate);
+    }
+
+    const FrameStats::Summary frames = frame_times.summary();
+    const FrameStats::Summary latency = latencies.summary();
+    if (ImGui::BeginTable("percentiles", 6, ImGuiTableFlags_Borders | ImGuiTableFlags_SizingFixedFit)) {
+      for (const char* heading : {"ms", "p50", "p95", "p99", "max", "mean"}) {
+        ImGui::TableSetupColumn(heading);
+      }
+      ImGui::TableHeadersRow();
+      auto row = [](const char* name, const FrameStats::Summary& s) {
+        ImGui::TableNextRow();
+        ImGui::TableNextColumn();
+        ImGui::TextUnformatted(name);
+        for (float v : {s.p50, s.p95, s.p99, s.max, s.mean}) {
+          ImGui::TableNextColumn();
+          ImGui::Text("%6.2f", v);
+        }
+      };
+      row("frame time", frames);
+      row("input to display", latency);
+      ImGui::EndTable();
+    }
+    ImGui::SameLine();
+    if (pacing == Pacing::Sleep || pacing == Pacing::SleepAndSpin) {
+      ImGui::Text("oversleep %.3f ms\nwakes %.3f ms early\nspin %.3f ms a frame\nlate frames %llu", pacer.oversleep_ms(), pacer.sleep_margin_ms(),
+                  pacer.spin_ms(), (unsigned long long)pacer.late_frames());
+    }
+
+    const double target_ms = 1000.0 / frame_rate;
+    if (ImPlot::BeginPlot("Frame times", ImVec2(-1, 200))) {
+      ImPlot::SetupAxes("frame", "ms", ImPlotAxisFlags_AutoFit, 0);
+      ImPlot::SetupAxisLimits(ImAxis_Y1, 0, 3 * target_ms, ImPlotCond_Always);
+      ImPlot::PlotLine("frame time", frame_times.data(), frame_times.size(), 1, 0, 0, frame_times.offset());
+      ImPlot::PlotLine("input to display", latencies.data(), latencies.size(), 1, 0, 0, latencies.offset());
+      ImPlot::PlotInfLines("target", &target_ms, 1, ImPlotInfLinesFlags_Horizontal);
+      ImPlot::EndPlot();
+    }
+    if (ImPlot::BeginPlot("Frame time histogram", ImVec2(-1, -1))) {
+      ImPlot::SetupAxes("ms", "frames", 0, ImPlotAxisFlags_AutoFit);
+      ImPlot::SetupAxisLimits(ImAxis_X1, 0, 2 * target_ms, ImPlotCond_Always);
+      ImPlot::PlotHistogram("frame time", frame_times.data(), frame_times.size(), 100, 1.0, ImPlotRange(0, 2 * target_ms));
+      ImPlot::PlotInfLines("target", &target_ms, 1);
+      ImPlot::EndPlot();
+    }
+    ImGui::End();
+
     window.clear();
     window.draw(text);
+    window.draw(bar_shape);
+    ImGui::SFML::Render(window);
     window.display();
+    latencies.add(std::chrono::duration<float, std::milli>(steady_clock::now() - input_time).count());
   }
+  ImPlot::DestroyContext();
+  ImGui::SFML::Shutdown();
 
   return 0;
 }
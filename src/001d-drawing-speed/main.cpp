@@ -1,8 +1,13 @@
 #include <SFML/Graphics.hpp>
-#include <iomanip>
 #include <iostream>
-#include <sstream>
+#include <memory_resource>
 #include <vector>
+#ifndef NDEBUG
+#define ALLOC_TRACKER_IMPLEMENTATION  // counting costs time on every allocation, so debug builds only
+#endif
+#include "alloc_tracker.h"
+#include "frame_arena.h"
+#include "profiler.h"
 
 /**
  * In this experiment we draw a bunch of rectangles to the screen and time the operations.
@@ -43,14 +48,25 @@
  *
  * So, to draw 2000 sf::RectangleShapes, it is much faster to convert them into a single structure.
  * Even if we include the time needed to do the conversion, it might still be ten times faster overall.
+ *
+ * The vertices do not have to be in an sf::VertexArray. Any array of sf::Vertex can be drawn
+ * with window.draw(vertices, count, sf::Quads). Here they are built every frame in a FrameArena
+ * (see frame_arena.h) so the conversion never has to go to the heap for its 8000 vertices. The
+ * last line of the display counts the heap allocations in each frame.
+ *
+ * Each way of drawing is timed with a PROFILE_SCOPE (see profiler.h) and the display shows
+ * the times from the last complete frame.
  */
 
 const int ShapeCount = 2000;
 std::vector<sf::RectangleShape> shapes;
 std::vector<sf::Rect<float>> rectangles;
 
-sf::VertexArray createVertexArrayFromRects(const std::vector<sf::Rect<float>>& rects, const sf::Color& color = sf::Color::Magenta) {
-  sf::VertexArray vertexArray(sf::Quads, rects.size() * 4);
+using Vertices = std::pmr::vector<sf::Vertex>;
+
+Vertices createVertexArrayFromRects(const std::vector<sf::Rect<float>>& rects, std::pmr::memory_resource* memory,
+                                    const sf::Color& color = sf::Color::Magenta) {
+  Vertices vertexArray(rects.size() * 4, memory);
 
   for (std::size_t i = 0; i < rects.size(); ++i) {
     const sf::Rect<float>& rect = rects[i];
@@ -70,8 +86,8 @@ sf::VertexArray createVertexArrayFromRects(const std::vector<sf::Rect<float>>& r
   return vertexArray;
 }
 
-sf::VertexArray createVertexArrayFromRectangleShapes(const std::vector<sf::RectangleShape>& shapes) {
-  sf::VertexArray vertexArray(sf::Quads, shapes.size() * 4);
+Vertices createVertexArrayFromRectangleShapes(const std::vector<sf::RectangleShape>& shapes, std::pmr::memory_resource* memory) {
+  Vertices vertexArray(shapes.size() * 4, memory);
 
   for (std::size_t i = 0; i < shapes.size(); ++i) {
     const sf::RectangleShape& shape = shapes[i];
@@ -122,68 +138,90 @@ int main() {
   text.setPosition(10, 10);
 
   sf::Clock clock;
-  sf::Clock timer;
-  int frame_count = 0;
-  int frame_interval = 20;
-
-  sf::VertexArray v_shapes = createVertexArrayFromRectangleShapes(shapes);
-  sf::VertexArray v_rectangles = createVertexArrayFromRects(rectangles);
+  Profiler& profiler = Profiler::get();
+  auto us = [&](const char* block) { return uint32_t(profiler.block_time(block) / 1000); };
+  FrameArena arena(256 * 1024);
+  uint64_t heap_allocations = 0;
+  uint64_t allocations_before = alloc_tracker::allocations();
 
   clock.restart();
   while (window.isOpen()) {
+    PROFILE_FRAME();
+    /// last frame's vertices and text were freed at the end of the loop so start again at the beginning of the arena
+    arena.reset();
+    heap_allocations = alloc_tracker::allocations() - allocations_before;
+    allocations_before = alloc_tracker::allocations();
     sf::Event event{};
     while (window.pollEvent(event)) {
       if (event.type == sf::Event::Closed)
         window.close();
     }
 
-    std::ostringstream ss;
-    ss << "Rendering " << ShapeCount << " objects to the screen:\n";
-    uint32_t time;
+    std::pmr::string ss = arena.string();
+    ss.reserve(512);
+    appendf(ss, "Rendering %d objects to the screen:\n", ShapeCount);
+    appendf(ss, "    shapes: %5u us \n", us("shapes"));
+    appendf(ss, "     rects: %5u us \n", us("rects"));
+    appendf(ss, "   v_rects: %5u us ", us("v_rects"));
+    appendf(ss, "  draw only = %5u us\n", us("v_rects draw"));
+    appendf(ss, "  v_shapes: %5u us ", us("v_shapes"));
+    appendf(ss, "  draw only = %5u us\n", us("v_shapes draw"));
     window.clear();
 
     window.draw(text);
 
     /// Draw a vector of sf::RectangleSahpe objects
-    timer.restart();
-    for (auto& shape : shapes) {
-      window.draw(shape);
+    {
+      PROFILE_SCOPE("shapes");
+      for (auto& shape : shapes) {
+        window.draw(shape);
+      }
     }
-    time = timer.restart().asMicroseconds();
-    ss << "    shapes: " << std::setw(5) << time << "us \n";
 
     /// Create a shape from each rectangle and then draw it to the screen
-    sf::RectangleShape r;
-    for (auto& rect : rectangles) {
-      r.setSize(rect.getSize());
-      r.setFillColor(sf::Color::Blue);
-      r.setPosition(200, 400);
-      window.draw(r);
+    {
+      PROFILE_SCOPE("rects");
+      sf::RectangleShape r;
+      for (auto& rect : rectangles) {
+        r.setSize(rect.getSize());
+        r.setFillColor(sf::Color::Blue);
+        r.setPosition(200, 400);
+        window.draw(r);
+      }
+    }
+
+    Vertices v_rectangles(&arena);  // made in the arena, so that it takes over the arena vector below without copying
+    {
+      PROFILE_SCOPE("v_rects");
+      v_rectangles = createVertexArrayFromRects(rectangles, &arena);
+      window.draw(v_rectangles.data(), v_rectangles.size(), sf::Quads);
+    }
+    {
+      PROFILE_SCOPE("v_rects draw");
+      window.draw(v_rectangles.data(), v_rectangles.size(), sf::Quads);
     }
-    time = timer.restart().asMicroseconds();
-    ss << "     rects: " << std::setw(5) << time << "us \n";
-
-    sf::VertexArray v_rectangles = createVertexArrayFromRects(rectangles);
-    window.draw(v_rectangles);
-    time = timer.restart().asMicroseconds();
-    ss << "   v_rects: " << std::setw(5) << time << "us ";
-    window.draw(v_rectangles);
-    time = timer.restart().asMicroseconds();
-    ss << "  draw only = " << std::setw(5) << time << "us\n";
-
-    sf::VertexArray v_shapes = createVertexArrayFromRectangleShapes(shapes);
-    window.draw(v_shapes);
-    time = timer.restart().asMicroseconds();
-    ss << "  v_shapes: " << std::setw(5) << time << "us ";
-    window.draw(v_shapes);
-    time = timer.restart().asMicroseconds();
-    ss << "  draw only = " << std::setw(5) << time << "us\n";
-
-    time = clock.restart().asMicroseconds();
-    ss << "frame time: " << std::setw(5) << time << "us \n";
-    ss << "frame rate: " << std::setw(5) << (1000000 / time) << "fps \n";
-
-    text.setString(ss.str());
+
+    Vertices v_shapes(&arena);
+    {
+      PROFILE_SCOPE("v_shapes");
+      v_shapes = createVertexArrayFromRectangleShapes(shapes, &arena);
+      window.draw(v_shapes.data(), v_shapes.size(), sf::Quads);
+    }
+    {
+      PROFILE_SCOPE("v_shapes draw");
+      window.draw(v_shapes.data(), v_shapes.size(), sf::Quads);
+    }
+
+    const uint32_t time = clock.restart().asMicroseconds();
+    appendf(ss, "frame time: %5u us \n", time);
+    appendf(ss, "frame rate: %5u fps \n", 1000000 / time);
+    /// the text itself still allocates inside sf::String whenever it changes
+    if (alloc_tracker::installed()) {
+      appendf(ss, "heap allocations: %3llu last frame, ", (unsigned long long)heap_allocations);
+    }
+    appendf(ss, "arena %zu kB of %zu kB", arena.peak() / 1024, arena.capacity() / 1024);
+
+    text.setString(ss.c_str());
     text.setPosition(10, 50);
     window.draw(text);
     window.display();
@@ -3,6 +3,7 @@
 #include <SFML/System/Clock.hpp>
 #include <SFML/Window/Event.hpp>
 #include <iostream>
+#include "angle.h"
 
 /***
  * Create a simple SFML window with custom title text and a couple of shapes drawn in it
@@ -99,8 +100,9 @@ int main() {
     chick.rotate(90 * time.asSeconds());  /// 90 degrees per second
 
     float angle = chick.getRotation();
-    float dx = std::cos((angle - 90) * 3.14 / 180) * 200;
-    float dy = std::sin((angle - 90) * 3.14 / 180) * 200;
+    Angle heading = Angle::from_degrees(angle - 90);
+    float dx = heading.cos() * 200;
+    float dy = heading.sin() * 200;
     chick.move(sf::Vector2f(dx, dy) * time.asSeconds());
     /// calculate the next animation frame location
     chick.setTextureRect(sf::IntRect(32 * seq[state / 5], 0, 32, 32));
@@ -0,0 +1,200 @@
+#include <SFML/Graphics.hpp>
+#include <SFML/System/Clock.hpp>
+#include <SFML/Window/Event.hpp>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+#include "fast_random.h"
+#include "sprite_batch.h"
+#include "texture_atlas.h"
+#include "utils.h"
+
+/***
+ * Thousands of sprites, taken from a dozen different images, drawn with one draw call.
+ *
+ * At startup every small image in assets/images is packed into one texture
+ * atlas. Each sprite remembers which image it came from and where that image
+ * ended up in the atlas, and a SpriteBatch draws them all in one go.
+ *
+ *   B     - switch between the batch and ordinary sf::Sprites, each with the texture of
+ *           its own image. The sprites are mixed up so the texture changes on
+ *           almost every draw, which is the worst case.
+ *   A     - show the atlas itself
+ *   Up    - double the number of sprites
+ *   Down  - halve the number of sprites
+ */
+
+const int WINDOW_WIDTH = 1280;
+const int WINDOW_HEIGHT = 800;
+
+/// the images to use and, for sprite sheets, the part of the image to show
+struct SpriteSource {
+  std::string name;
+  sf::IntRect frame;
+};
+
+struct Mover {
+  int source;
+  sf::Vector2f position;
+  sf::Vector2f velocity;
+  float rotation;
+  float spin;
+};
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void populate(std::vector<Mover>& movers, int count, int source_count) {
+  Xoshiro128 rng(1234);
+  movers.resize(count);
+  for (int i = 0; i < count; i++) {
+    Mover& m = movers[i];
+    m.source = i % source_count;
+    m.position = {rng.uniform(0, WINDOW_WIDTH), rng.uniform(0, WINDOW_HEIGHT)};
+    m.velocity = {rng.uniform(-100, 100), rng.uniform(-100, 100)};
+    m.rotation = rng.uniform(0, 360);
+    m.spin = rng.uniform(-90, 90);
+  }
+}
+
+void update(std::vector<Mover>& movers, float dt) {
+  for (Mover& m : movers) {
+    m.position += m.velocity * dt;
+    m.rotation += m.spin * dt;
+    if (m.position.x < 0 || m.position.x > WINDOW_WIDTH) {
+      m.velocity.x = -m.velocity.x;
+    }
+    if (m.position.y < 0 || m.position.y > WINDOW_HEIGHT) {
+      m.velocity.y = -m.velocity.y;
+    }
+  }
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+int main() {
+  sf::RenderWindow window{sf::VideoMode(WINDOW_WIDTH, WINDOW_HEIGHT), WINDOW_TITLE, sf::Style::Titlebar + sf::Style::Close};
+  window.setVerticalSyncEnabled(false);
+
+  sf::Font font;
+  if (!font.loadFromFile("./assets/fonts/consolas.ttf")) {
+    exit(1);
+  }
+  sf::Text text("", font, 18);
+  text.setFillColor(sf::Color::Yellow);
+  text.setOutlineColor(sf::Color::Black);
+  text.setOutlineThickness(2);
+  text.setPosition(10, 10);
+
+  TextureAtlas atlas;
+  sf::Clock pack_clock;
+  int image_count = atlas.add_directory("./assets/images", 1024);
+  if (!atlas.pack()) {
+    std::cout << "The images do not fit in one texture\n";
+    exit(1);
+  }
+  float pack_ms = (float)pack_clock.getElapsedTime().asMicroseconds() / 1000.0f;
+  std::cout << "Packed " << image_count << " images into " << atlas.size().x << "x" << atlas.size().y << " in " << pack_ms << " ms, "
+            << (int)(100 * atlas.occupancy()) << "% full\n";
+
+  /// whole images, and single frames from the sprite sheets
+  std::vector<SpriteSource> sources = {
+      {"car", {}},          {"chicken", {}},    {"wooden-chest-45x40", {}},     {"mouse-b", {}},
+      {"mouse-c", {}},      {"mouse-d", {}},    {"spaceship", {}},              {"mouse-76x100", {0, 0, 76, 100}},
+      {"mouse-39x50", {0, 0, 39, 50}}, {"tiles-64x64", {0, 64, 64, 64}}, {"floortileset-32x32", {32, 0, 32, 32}},
+  };
+  std::vector<sf::IntRect> atlas_rects;
+  std::vector<sf::Texture> textures;  // one per source for the unbatched version
+  std::vector<sf::IntRect> texture_rects;
+  for (auto it = sources.begin(); it != sources.end();) {
+    if (!atlas.contains(it->name)) {
+      it = sources.erase(it);
+      continue;
+    }
+    sf::IntRect whole = atlas.rect(it->name);
+    if (it->frame.width == 0) {
+      it->frame = {0, 0, whole.width, whole.height};
+    }
+    ++it;
+  }
+  textures.resize(sources.size());
+  for (size_t i = 0; i < sources.size(); i++) {
+    atlas_rects.push_back(atlas.rect(sources[i].name, sources[i].frame));
+    texture_rects.push_back(sources[i].frame);
+    textures[i].loadFromFile("./assets/images/" + sources[i].name + ".png");
+  }
+  if (sources.empty()) {
+    exit(1);
+  }
+
+  std::vector<Mover> movers;
+  populate(movers, 5000, (int)sources.size());
+  SpriteBatch batch(&atlas.texture());
+  sf::Sprite sprite;
+  sf::Sprite atlas_sprite(atlas.texture());
+  float scale = std::min(1.0f, std::min((float)WINDOW_HEIGHT / (float)atlas.size().y, (float)WINDOW_WIDTH / (float)atlas.size().x));
+  atlas_sprite.setScale(scale, scale);
+
+  bool batched = true;
+  bool show_atlas = false;
+  float frame_ms = 0;
+  sf::Clock deltaClock{};
+  while (window.isOpen()) {
+    sf::Event event{};
+    while (window.pollEvent(event)) {
+      if (event.type == sf::Event::Closed) {
+        window.close();
+      } else if (event.type == sf::Event::KeyPressed) {
+        if (event.key.code == sf::Keyboard::B) {
+          batched = !batched;
+        } else if (event.key.code == sf::Keyboard::A) {
+          show_atlas = !show_atlas;
+        } else if (event.key.code == sf::Keyboard::Up) {
+          populate(movers, (int)movers.size() * 2, (int)sources.size());
+        } else if (event.key.code == sf::Keyboard::Down && movers.size() > 1) {
+          populate(movers, (int)movers.size() / 2, (int)sources.size());
+        }
+      }
+    }
+    sf::Time time = deltaClock.restart();
+    frame_ms = exponential_filter(frame_ms, (float)time.asMicroseconds() / 1000.0f, 0.95f);
+    update(movers, time.asSeconds());
+
+    window.clear(sf::Color(40, 40, 60));
+    int draw_calls = 0;
+    if (show_atlas) {
+      window.draw(atlas_sprite);
+      draw_calls = 1;
+    } else if (batched) {
+      batch.clear();
+      for (const Mover& m : movers) {
+        const sf::IntRect& r = atlas_rects[m.source];
+        batch.add(r, m.position, {(float)r.width / 2, (float)r.height / 2}, m.rotation);
+      }
+      window.draw(batch);
+      draw_calls = 1;
+    } else {
+      for (const Mover& m : movers) {
+        const sf::IntRect& r = texture_rects[m.source];
+        sprite.setTexture(textures[m.source]);
+        sprite.setTextureRect(r);
+        sprite.setOrigin((float)r.width / 2, (float)r.height / 2);
+        sprite.setPosition(m.position);
+        sprite.setRotation(m.rotation);
+        window.draw(sprite);
+      }
+      draw_calls = (int)movers.size();
+    }
+
+    std::string txt = "Sprites: " + std::to_string(movers.size()) + " from " + std::to_string(sources.size()) + " images\n";
+    txt += std::string(batched ? "SpriteBatch with the atlas" : "One sf::Sprite each") + " (B)\n";
+    txt += "Draw calls: " + std::to_string(draw_calls) + "\n";
+    txt += "Frame: " + std::to_string(frame_ms).substr(0, 5) + " ms\n";
+    text.setString(txt);
+    window.draw(text);
+    window.display();
+  }
+  return 0;
+}
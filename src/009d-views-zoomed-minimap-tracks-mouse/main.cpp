@@ -1,9 +1,14 @@
 #include <SFML/Graphics.hpp>
 #include <cmath>
 #include <iostream>
+#include "asset_manager.h"
 
 /***
- * Load a large  (3000x3000) map as an image into a
+ * Load a large  (3000x3000) map as an image into a texture and show it in two views,
+ * the whole map and a minimap that follows the mouse.
+ *
+ * The map and the font are loaded in the background by an AssetManager so the
+ * window opens at once. Each is used as soon as it arrives.
  */
 
 float element_space = 10.0;
@@ -57,19 +62,11 @@ int main() {
   // Create the SFML window
   sf::RenderWindow window(sf::VideoMode(window_width, window_height), WINDOW_TITLE);
 
-  sf::Font font;
-  if (!font.loadFromFile("./assets/fonts/national-park.otf")) {
-    exit(1);
-  }
-
-  // Load the map image and put it on a RectangleShape
-  sf::Texture map_texture;
-  if (!map_texture.loadFromFile("assets/images/map-3000x3000.png")) {
-    return -1;
-  }
-
-  sf::RectangleShape map(sf::Vector2f(map_texture.getSize().x, map_texture.getSize().y));
-  map.setTexture(&map_texture);
+  // Start loading the font and the map. The map goes on a RectangleShape when it arrives
+  AssetManager assets;
+  FontHandle font = assets.font("./assets/fonts/national-park.otf");
+  TextureHandle map_texture = assets.texture("assets/images/map-3000x3000.png");
+  sf::RectangleShape map;
 
   /// Define the main regions for elements in the window
   /// This rectangle is the location of the main map in the window
@@ -92,7 +89,7 @@ int main() {
 
   sf::FloatRect visibleArea(0, 0, (float)window.getSize().x, (float)window.getSize().y);
   /// view the entire map
-  sf::View main_map_view(sf::FloatRect(0, 0, map_texture.getSize().x, map_texture.getSize().y));
+  sf::View main_map_view(sf::FloatRect(0, 0, 3000, 3000));
   main_map_view.setViewport(calculate_viewport(main_map_view_port_rect, visibleArea));
 
   /// make the mini map view the same size as its viewport area to get 1:1 pixels to coordinates
@@ -108,7 +105,9 @@ int main() {
   rect.setFillColor(ui_colour);
 
   /// A simple label for the minimap
-  sf::Text text("Minimap", font, ui_title_font_height);
+  sf::Text text;
+  text.setString("Minimap");
+  text.setCharacterSize(ui_title_font_height);
   text.setPosition(mini_map_view_port_rect.getPosition().x,                   //
                    mini_map_view_port_rect.getPosition().y - ui_title_height  //
   );
@@ -130,6 +129,21 @@ int main() {
       }
     }
 
+    assets.update();
+    if (font->failed() || map_texture->failed()) {
+      return -1;
+    }
+    if (font->ready() && text.getFont() == nullptr) {
+      text.setFont(font->font);
+    }
+    if (map_texture->ready() && map.getTexture() == nullptr) {
+      sf::Vector2f map_size(map_texture->texture.getSize().x, map_texture->texture.getSize().y);
+      map.setSize(map_size);
+      map.setTexture(&map_texture->texture);
+      main_map_view.reset(sf::FloatRect(0, 0, map_size.x, map_size.y));
+      main_map_view.setViewport(calculate_viewport(main_map_view_port_rect, visibleArea));
+    }
+
     /// constrain the mouse coordinates to the map
     float mx = sf::Mouse::getPosition(window).x;
     float my = sf::Mouse::getPosition(window).y;
@@ -143,7 +157,9 @@ int main() {
     /// each view must be drawn separately? Not sure why.
     window.setView(main_view);
     window.draw(rect);
-    window.draw(text);
+    if (text.getFont()) {
+      window.draw(text);
+    }
 
     window.setView(main_map_view);
     window.draw(map);
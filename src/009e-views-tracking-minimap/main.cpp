@@ -4,7 +4,9 @@
 #include <SFML/Window/Event.hpp>
 #include <cmath>
 #include <iostream>
+#include "angle.h"
 #include "map.h"
+#include "view_culling.h"
 
 /*********************************************************************************************************************/
 
@@ -96,6 +98,14 @@ int main() {
 
   sf::View main_view(visibleArea);  // the viewport is the whole window by default
 
+  /// Both views draw from the same culler. Each draws only the chunks of map it can see.
+  /// The map goes in first so that it is drawn under the robot
+  ViewCuller culler(sf::FloatRect(0, 0, 32 * 30, 32 * 30), 120);
+  for (const TileChunk& chunk : map.chunks()) {
+    culler.add(chunk.getGlobalBounds(), &chunk);
+  }
+  int robot_id = culler.add(robot.getGlobalBounds(), &robot);
+
   sf::Text txt_robot_pose("m;sjfs", font, 24);
   txt_robot_pose.setFillColor(sf::Color::White);
   txt_robot_pose.setPosition(mini_map_view_port_rect.left, mini_map_view_port_rect.top - 30);
@@ -148,8 +158,9 @@ int main() {
     sf::Time time = deltaClock.restart();
     float angle = robot.getRotation();
     float ds = v * time.asSeconds();
-    float dx = std::cos((angle - 90) * 3.14 / 180) * v;
-    float dy = std::sin((angle - 90) * 3.14 / 180) * v;
+    Angle heading = Angle::from_degrees(angle - 90);
+    float dx = heading.cos() * v;
+    float dy = heading.sin() * v;
     if (robot.getPosition().x + dx < 1024 && robot.getPosition().x + dx > 0) {
       robot.move(sf::Vector2f(dx, dy) * time.asSeconds());
     }
@@ -165,23 +176,26 @@ int main() {
     txt_robot_pose.setString(buf);
 
     mini_map_view.setCenter(robot.getPosition().x, robot.getPosition().y);
+    culler.update(robot_id, robot.getGlobalBounds());
 
     /// and redraw the window
     window.clear();
 
-    window.setView(main_view);
-    window.draw(txt_robot_pose);
-
     // drawing is done into a view
-    window.setView(main_map_view);
-    window.draw(map);
-    window.draw(robot);
+    CullStats main_stats = culler.draw(window, main_map_view);
 
     // mini_map_view.setRotation(robot.getRotation());
-    /// Stuff must be drawn on both views. Still do not know why
-    window.setView(mini_map_view);
-    window.draw(map);
-    window.draw(robot);
+    /// Stuff must be drawn on both views. A view is only a way of looking at the scene, it does not
+    /// remember what was drawn. The culler means each view only draws what it can see.
+    CullStats mini_stats = culler.draw(window, mini_map_view);
+
+    window.setView(main_view);
+    std::string txt = buf;
+    txt += "\nMain: " + std::to_string(main_stats.visible) + " drawn, " + std::to_string(main_stats.culled) + " culled";
+    txt += "\nMini: " + std::to_string(mini_stats.visible) + " drawn, " + std::to_string(mini_stats.culled) + " culled";
+    txt_robot_pose.setString(txt);
+    txt_robot_pose.setPosition(mini_map_view_port_rect.left, mini_map_view_port_rect.top - txt_robot_pose.getLocalBounds().height - 10);
+    window.draw(txt_robot_pose);
 
     window.display();
   }
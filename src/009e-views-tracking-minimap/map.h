@@ -1,5 +1,7 @@
 #pragma once
 #include <SFML/Graphics.hpp>
+#include <algorithm>
+#include <vector>
 // define the level_map with an array of tile indices
 // clang-format off
     const int level_map[32*32] =
@@ -45,21 +47,57 @@
 
 /// hhttps://www.sfml-dev.org/tutorials/2.6/graphics-view.php
 
+/***
+ * The map is split into square chunks of tiles, each a vertex array of its own.
+ * Drawing the whole map draws every chunk, but each chunk can also be handed to
+ * a ViewCuller so that a view only draws the chunks it can see.
+ */
+class TileMap;
+
+class TileChunk : public sf::Drawable {
+ public:
+  TileChunk(const TileMap& map, sf::FloatRect bounds) : m_map(map), m_bounds(bounds), m_vertices(sf::Triangles) {}
+
+  /// where the chunk is in the world, allowing for the map's own transform
+  [[nodiscard]] sf::FloatRect getGlobalBounds() const;
+
+  sf::VertexArray& vertices() { return m_vertices; }
+
+ private:
+  void draw(sf::RenderTarget& target, sf::RenderStates states) const override;
+
+  const TileMap& m_map;
+  sf::FloatRect m_bounds;
+  sf::VertexArray m_vertices;
+};
+
 class TileMap : public sf::Drawable, public sf::Transformable {
  public:
+  static constexpr unsigned CHUNK_TILES = 8;  // chunks are this many tiles square
+
   bool load(const std::string& tileset, sf::Vector2u tileSize, const int* tiles, unsigned int width, unsigned int height) {
     // load the tileset texture
     if (!m_tileset_texture.loadFromFile(tileset)) {
       return false;
     }
 
-    // resize the vertex array to fit the level_map size
-    m_vertices.setPrimitiveType(sf::Triangles);
-    m_vertices.resize(width * height * 6);
+    // one vertex array per chunk
+    unsigned chunks_across = (width + CHUNK_TILES - 1) / CHUNK_TILES;
+    unsigned chunks_down = (height + CHUNK_TILES - 1) / CHUNK_TILES;
+    m_chunks.clear();
+    m_chunks.reserve(chunks_across * chunks_down);
+    for (unsigned cj = 0; cj < chunks_down; ++cj) {
+      for (unsigned ci = 0; ci < chunks_across; ++ci) {
+        float left = float(ci * CHUNK_TILES * tileSize.x);
+        float top = float(cj * CHUNK_TILES * tileSize.y);
+        unsigned across = std::min(CHUNK_TILES, width - ci * CHUNK_TILES);
+        unsigned down = std::min(CHUNK_TILES, height - cj * CHUNK_TILES);
+        m_chunks.emplace_back(*this, sf::FloatRect(left, top, float(across * tileSize.x), float(down * tileSize.y)));
+      }
+    }
     int texture_tile_width = (m_tileset_texture.getSize().x / tileSize.x);
-    int texture_tile_height = (m_tileset_texture.getSize().y / tileSize.y);
 
-    // populate the vertex array, with two triangles per tile
+    // populate the vertex arrays, with two triangles per tile
     for (unsigned int i = 0; i < width; ++i)
       for (unsigned int j = 0; j < height; ++j) {
         // get the current tile number
@@ -70,8 +108,9 @@ class TileMap : public sf::Drawable, public sf::Transformable {
         int tu = tileNumber % texture_tile_width;
         int tv = tileNumber / texture_tile_width;
 
-        // get a pointer to the triangles' vertices of the current tile
-        sf::Vertex* triangles = &m_vertices[(i + j * width) * 6];
+        // the chunk it belongs to
+        sf::VertexArray& vertices = m_chunks[(j / CHUNK_TILES) * chunks_across + i / CHUNK_TILES].vertices();
+        sf::Vertex triangles[6];
 
         // define the 6 corners of the two triangles
         triangles[0].position = sf::Vector2f(i * tileSize.x, j * tileSize.y);
@@ -88,23 +127,40 @@ class TileMap : public sf::Drawable, public sf::Transformable {
         triangles[3].texCoords = sf::Vector2f(tu * tileSize.x, (tv + 1) * tileSize.y);
         triangles[4].texCoords = sf::Vector2f((tu + 1) * tileSize.x, tv * tileSize.y);
         triangles[5].texCoords = sf::Vector2f((tu + 1) * tileSize.x, (tv + 1) * tileSize.y);
+        for (const sf::Vertex& v : triangles) {
+          vertices.append(v);
+        }
       }
 
     return true;
   }
 
+  /// the chunks do not move once the map is loaded so it is safe to keep pointers to them
+  [[nodiscard]] const std::vector<TileChunk>& chunks() const { return m_chunks; }
+  [[nodiscard]] const sf::Texture& texture() const { return m_tileset_texture; }
+
  private:
   virtual void draw(sf::RenderTarget& target, sf::RenderStates states) const {
-    // apply the transform
-    states.transform *= getTransform();
-
-    // apply the tileset texture
-    states.texture = &m_tileset_texture;
-
-    // draw the vertex array
-    target.draw(m_vertices, states);
+    for (const TileChunk& chunk : m_chunks) {
+      target.draw(chunk, states);
+    }
   }
 
-  sf::VertexArray m_vertices;
+  std::vector<TileChunk> m_chunks;
   sf::Texture m_tileset_texture;
-};
\ No newline at end of file
+};
+
+inline sf::FloatRect TileChunk::getGlobalBounds() const {
+  return m_map.getTransform().transformRect(m_bounds);
+}
+
+inline void TileChunk::draw(sf::RenderTarget& target, sf::RenderStates states) const {
+  // apply the map's transform
+  states.transform *= m_map.getTransform();
+
+  // apply the tileset texture
+  states.texture = &m_map.texture();
+
+  // draw the vertex array
+  target.draw(m_vertices, states);
+}
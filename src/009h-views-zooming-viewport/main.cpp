@@ -1,6 +1,7 @@
 #include <SFML/Graphics.hpp>
 #include <cmath>
 #include <iostream>
+#include "asset_manager.h"
 
 /***
  *  - Load a large  (3000x3000) map as an image into a texture
@@ -10,6 +11,8 @@
  *  - create a viewport that is the size of the view and positioned in the top left
  *  - draw the map using that view - it will just fill the viewport, scaling as needed
  *
+ * The map is loaded in the background by an AssetManager so the window opens at
+ * once. Until it arrives, the frame shows how much of it has been uploaded.
  */
 
 float element_space = 10.0;
@@ -39,15 +42,11 @@ int main() {
   // Create the SFML window
   sf::RenderWindow window(sf::VideoMode(window_width, window_height), WINDOW_TITLE);
 
-  // Load the map image and put it on a RectangleShape
+  // Start loading the map image. It will be put on a RectangleShape when it arrives
   // we could use a sprite instead
-  sf::Texture map_texture;
-  if (!map_texture.loadFromFile("assets/images/map-3000x3000.png")) {
-    return -1;
-  }
-
-  sf::RectangleShape map(sf::Vector2f(map_texture.getSize().x, map_texture.getSize().y));
-  map.setTexture(&map_texture);
+  AssetManager assets;
+  TextureHandle map_texture = assets.texture("assets/images/map-3000x3000.png");
+  sf::RectangleShape map;
 
   /// There apears no single call that fetches the window as a rectangle
   sf::FloatRect windowRect(0, 0, (float)window.getSize().x, (float)window.getSize().y);
@@ -98,6 +97,15 @@ int main() {
       }
     }
 
+    assets.update();
+    if (map_texture->failed()) {
+      return -1;
+    }
+    if (map_texture->ready() && map.getTexture() == nullptr) {
+      map.setSize(sf::Vector2f(map_texture->texture.getSize().x, map_texture->texture.getSize().y));
+      map.setTexture(&map_texture->texture);
+    }
+
     /// now we get to draw everything - first Clear the window
     window.clear();
 
@@ -107,6 +115,13 @@ int main() {
     frame.setFillColor(sf::Color::Green);
     frame.setPosition(map_viewport_rect.left - 5.0f, map_viewport_rect.top - 5.0f);
     window.draw(frame);
+    if (!map_texture->ready()) {
+      /// a bar across the frame for the part of the map that has been uploaded
+      sf::RectangleShape bar(sf::Vector2f(map_viewport_size * map_texture->progress(), 10));
+      bar.setFillColor(sf::Color::Black);
+      bar.setPosition(map_viewport_rect.left, map_viewport_rect.top + map_viewport_size / 2 - 5);
+      window.draw(bar);
+    }
 
     /// each view must be drawn separately? Not sure why.
     window.setView(map_view);
@@ -4,6 +4,7 @@
 #include <SFML/Window/Event.hpp>
 #include <cmath>
 #include <iostream>
+#include "angle.h"
 #include "map.h"
 
 /*********************************************************************************************************************/
@@ -168,8 +169,9 @@ int main() {
     sf::Time time = deltaClock.restart();
     float angle = robot.getRotation();
     float ds = v * time.asSeconds();
-    float dx = std::cos((angle - 90) * 3.14 / 180) * v;
-    float dy = std::sin((angle - 90) * 3.14 / 180) * v;
+    Angle heading = Angle::from_degrees(angle - 90);
+    float dx = heading.cos() * v;
+    float dy = heading.sin() * v;
     if (robot.getPosition().x + dx < 1024 && robot.getPosition().x + dx > 0) {
       robot.move(sf::Vector2f(dx, dy) * time.asSeconds());
     }
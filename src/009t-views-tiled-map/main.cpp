@@ -0,0 +1,160 @@
+#include <SFML/Graphics.hpp>
+#include <SFML/System/Clock.hpp>
+#include <SFML/Window/Event.hpp>
+#include <cmath>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+#include "idle_loop.h"
+#include "tile_map.h"
+#include "utils.h"
+
+/***
+ * Pan and zoom around maps that are too big to be one texture.
+ *
+ * Each map is cut into 256x256 tiles at several levels of detail the first
+ * time it is used (see TilePyramid). The tiles are kept in a folder next to
+ * the program so later runs start at once. A TiledMapRenderer then draws only the
+ * tiles under the view, at the level that suits the zoom, so a frame costs
+ * much the same whether the view shows a corner of the map or all of it.
+ *
+ * Nothing moves unless the view does, so the window is only redrawn after input
+ * or while tiles are still loading (see IdleLoop).
+ *
+ * dungeon.png is 6931x6464, bigger than the largest texture some graphics cards allow.
+ *
+ *   Mouse wheel - zoom about the mouse
+ *   Left drag   - pan
+ *   Arrow keys  - pan
+ *   R / E       - rotate the view
+ *   Tab         - change map
+ */
+
+const int WINDOW_WIDTH = 1200;
+const int WINDOW_HEIGHT = 900;
+
+struct MapSource {
+  std::string image;
+  std::string tiles;
+};
+
+int main() {
+  sf::RenderWindow window{sf::VideoMode(WINDOW_WIDTH, WINDOW_HEIGHT), WINDOW_TITLE};
+  window.setFramerateLimit(60);
+
+  sf::Font font;
+  if (!font.loadFromFile("./assets/fonts/consolas.ttf")) {
+    std::cerr << "Unable to load font\n";
+    exit(1);
+  }
+  sf::Text text("", font, 18);
+  text.setFillColor(sf::Color::Yellow);
+  text.setOutlineColor(sf::Color::Black);
+  text.setOutlineThickness(2);
+  text.setPosition(10, 10);
+
+  std::vector<MapSource> sources = {
+      {"./assets/images/map-3000x3000.png", "./map-3000x3000.tiles"},
+      {"./assets/images/dungeon.png", "./dungeon.tiles"},
+  };
+  std::vector<TilePyramid> pyramids(sources.size());
+  for (size_t i = 0; i < sources.size(); i++) {
+    sf::Clock clock;
+    if (!pyramids[i].open(sources[i].image, sources[i].tiles)) {
+      std::cerr << "Unable to make tiles for " << sources[i].image << "\n";
+      exit(1);
+    }
+    std::cout << sources[i].image << ": " << pyramids[i].levels() << " levels ready in " << clock.getElapsedTime().asMilliseconds() << " ms\n";
+  }
+  /// the TiledMapRenderers keep a reference to their pyramid so the vector must not change from here on
+  std::vector<std::unique_ptr<TiledMapRenderer>> maps;
+  for (const auto& pyramid : pyramids) {
+    maps.push_back(std::make_unique<TiledMapRenderer>(pyramid));
+  }
+
+  size_t current = 0;
+  sf::View view = window.getDefaultView();
+  auto show_all = [&]() {
+    sf::Vector2f size(pyramids[current].size());
+    float zoom = std::max(size.x / WINDOW_WIDTH, size.y / WINDOW_HEIGHT);
+    view.setSize(WINDOW_WIDTH * zoom, WINDOW_HEIGHT * zoom);
+    view.setCenter(size / 2.0f);
+    view.setRotation(0);
+  };
+  show_all();
+
+  bool dragging = false;
+  sf::Vector2i drag_start;
+  float frame_ms = 0;
+  float update_ms = 0;
+  IdleLoop loop(window);
+  while (window.isOpen()) {
+    sf::Event event{};
+    while (loop.poll_event(event)) {
+      if (event.type == sf::Event::Closed) {
+        window.close();
+      } else if (event.type == sf::Event::MouseWheelScrolled) {
+        /// keep the point under the mouse where it is
+        sf::Vector2i mouse(event.mouseWheelScroll.x, event.mouseWheelScroll.y);
+        sf::Vector2f before = window.mapPixelToCoords(mouse, view);
+        view.zoom(event.mouseWheelScroll.delta > 0 ? 0.8f : 1.25f);
+        sf::Vector2f after = window.mapPixelToCoords(mouse, view);
+        view.move(before - after);
+      } else if (event.type == sf::Event::MouseButtonPressed && event.mouseButton.button == sf::Mouse::Left) {
+        dragging = true;
+        drag_start = {event.mouseButton.x, event.mouseButton.y};
+      } else if (event.type == sf::Event::MouseButtonReleased && event.mouseButton.button == sf::Mouse::Left) {
+        dragging = false;
+      } else if (event.type == sf::Event::MouseMoved && dragging) {
+        sf::Vector2i mouse(event.mouseMove.x, event.mouseMove.y);
+        view.move(window.mapPixelToCoords(drag_start, view) - window.mapPixelToCoords(mouse, view));
+        drag_start = mouse;
+      } else if (event.type == sf::Event::KeyPressed) {
+        float step = view.getSize().x / 10;
+        if (event.key.code == sf::Keyboard::Left) {
+          view.move(-step, 0);
+        } else if (event.key.code == sf::Keyboard::Right) {
+          view.move(step, 0);
+        } else if (event.key.code == sf::Keyboard::Up) {
+          view.move(0, -step);
+        } else if (event.key.code == sf::Keyboard::Down) {
+          view.move(0, step);
+        } else if (event.key.code == sf::Keyboard::R) {
+          view.rotate(10);
+        } else if (event.key.code == sf::Keyboard::E) {
+          view.rotate(-10);
+        } else if (event.key.code == sf::Keyboard::Tab) {
+          current = (current + 1) % maps.size();
+          show_all();
+        }
+      }
+    }
+
+    TiledMapRenderer& map = *maps[current];
+    sf::Clock update_clock;
+    map.update(view, window.getSize());
+    update_ms = exponential_filter(update_ms, (float)update_clock.getElapsedTime().asMicroseconds() / 1000.0f, 0.95f);
+    if (map.pending() > 0 || map.fallbacks() > 0) {
+      loop.request_redraw();  // keep drawing until the right tiles have arrived
+    }
+
+    window.clear(sf::Color(40, 40, 40));
+    window.setView(view);
+    window.draw(map);
+    window.setView(window.getDefaultView());
+
+    const TilePyramid& pyramid = pyramids[current];
+    std::string txt = sources[current].image + " " + std::to_string(pyramid.size().x) + "x" + std::to_string(pyramid.size().y) + " (Tab)\n";
+    txt += "Level: " + std::to_string(map.level()) + " of " + std::to_string(pyramid.levels()) + "\n";
+    txt += "Tiles in view: " + std::to_string(map.visible()) + " drawn: " + std::to_string(map.drawn()) + " stand-ins: " + std::to_string(map.fallbacks()) + "\n";
+    txt += "Textures: " + std::to_string(map.cached()) + "/" + std::to_string(map.capacity()) + " loading: " + std::to_string(map.pending()) + "\n";
+    txt += "Update: " + std::to_string(update_ms).substr(0, 5) + " ms  Frame: " + std::to_string(frame_ms).substr(0, 5) + " ms\n";
+    txt += "Frames drawn: " + std::to_string(loop.frames_drawn()) + " skipped: " + std::to_string(loop.frames_skipped()) + "\n";
+    text.setString(txt);
+    window.draw(text);
+    window.display();
+    frame_ms = exponential_filter(frame_ms, (float)loop.elapsed().asMicroseconds() / 1000.0f, 0.95f);
+  }
+  return 0;
+}
@@ -2,6 +2,7 @@
 #include <cmath>
 #include <iostream>
 #include <string>
+#include "angle.h"
 #include "raycaster.h"
 #include "sensor.h"
 #include "utils.h"
@@ -222,8 +223,9 @@ int main() {
     robot.rotate(theta);
     float angle = robot.getRotation();
     float ds = v * time.asSeconds();
-    float dx = std::cos((angle - 90) * 3.14 / 180) * ds;
-    float dy = std::sin((angle - 90) * 3.14 / 180) * ds;
+    Angle heading = Angle::from_degrees(angle - 90);
+    float dx = heading.cos() * ds;
+    float dy = heading.sin() * ds;
     if (robot.getPosition().x + dx < 1024 && robot.getPosition().x + dx > 0) {
       robot.move(sf::Vector2f(dx, dy));
     }
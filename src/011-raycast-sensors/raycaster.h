@@ -7,6 +7,7 @@
 
 #include <SFML/Graphics.hpp>
 #include <cmath>
+#include "angle.h"
 #include "utils.h"
 /***
  * A Bresenham style raycast. There may be no performance benefit compared to a
@@ -22,9 +23,9 @@
  * @return - the distance at which it hits the wall colour or runs out of range
  */
 inline sf::Vector2f castRay(const sf::Image& image, sf::Color wall_colour, const sf::Vector2f& origin, float angle) {
-  angle = angle * (3.14159 / 180);  // Convert angle to radians
-  float range = 254;                // the maximum distance we will cast out
-  sf::Vector2f rayDirection(cos(angle), sin(angle));
+  Angle direction = Angle::from_degrees(angle);
+  float range = 254;  // the maximum distance we will cast out
+  sf::Vector2f rayDirection(direction.cos(), direction.sin());
   sf::Vector2f dest = origin + range * rayDirection;
   sf::Color color = getColorAtPixel(image, static_cast<int>(origin.x), static_cast<int>(origin.y));
 
@@ -7,6 +7,7 @@
 
 #include <SFML/Graphics.hpp>
 #include <cmath>
+#include "angle.h"
 
 // Returns distance between points
 inline float distance(const sf::Vector2f& a, const sf::Vector2f& b) {
@@ -31,7 +32,7 @@ inline sf::Color getColorAtPixel(const sf::Image& image, sf::Vector2f point) {
 
 inline sf::Vector2f rotatePoint(const sf::Vector2f& point, const sf::Vector2f& center, float angle) {
   // Convert angle from degrees to radians
-  float radian = angle * (3.14159265 / 180.0);
+  float radian = trig::radians(angle);
 
   // Calculate the new x and y positions using the rotation matrix
   float newX = std::cos(radian) * (point.x - center.x) - std::sin(radian) * (point.y - center.y) + center.x;
@@ -1,12 +1,10 @@
 #include <SFML/Graphics.hpp>
 #include <cmath>
 #include <string>
+#include "angle.h"
 #include "maze.h"
 #include "object.h"
 
-#ifndef M_PI
-#define M_PI (3.14159265358979323846)
-#endif
 /***
  * This app tests the ability to do collision detection by geometry. The robot will have its
  * geometry defined by a number of shapes. In this case a single circle and a rectangle which
@@ -143,8 +141,9 @@ int main() {
     float old_angle = collision_geometry.angle();
     if (move) {
       float angle = collision_geometry.angle() + d_theta;
-      float dx = std::cos((angle - 90.0f) * 3.14f / 180.0f) * d_s;
-      float dy = std::sin((angle - 90.0f) * 3.14f / 180.0f) * d_s;
+      Angle heading = Angle::from_degrees(angle - 90);
+      float dx = heading.cos() * d_s;
+      float dy = heading.sin() * d_s;
       sf::Vector2f movement(dx, dy);
       collision_geometry.rotate(d_theta);
       collision_geometry.setPosition(collision_geometry.position() + movement);
@@ -3,13 +3,11 @@
 #include <cmath>
 #include <iostream>
 #include <string>
+#include "angle.h"
 #include "expfilter.h"
 #include "robot.h"
 #include "robotview.h"
 
-#ifndef M_PI
-#define M_PI (3.14159265358979323846)
-#endif
 
 // Returns distance between points
 inline float distance(const sf::Vector2f& a, const sf::Vector2f& b) {
@@ -46,9 +44,9 @@ sf::Color getColorAtPixel(const sf::Image& image, sf::Vector2f point) {
  * @return - the distance at which it hits the wall colour or runs out of range
  */
 sf::Vector2f castRay(const sf::Image& image, sf::Color wall_colour, const sf::Vector2f& origin, float angle) {
-  angle = angle * (3.14159 / 180);  // Convert angle to radians
-  float range = 254;                // the maximum distance we will cast out
-  sf::Vector2f rayDirection(cos(angle), sin(angle));
+  Angle direction = Angle::from_degrees(angle);
+  float range = 254;  // the maximum distance we will cast out
+  sf::Vector2f rayDirection(direction.cos(), direction.sin());
   sf::Vector2f dest = origin + range * rayDirection;
   sf::Color color = getColorAtPixel(image, static_cast<int>(origin.x), static_cast<int>(origin.y));
 
@@ -93,10 +91,10 @@ void create_collision_shield(sf::Image& image, float cx, float cy, int steps) {
   base_shield_points.resize(steps);
   float radius = 60.0f;
   for (int i = 0; i < steps; i++) {
-    float angle = (2 * M_PI * i) / steps;
+    float angle = trig::TWO_PI * float(i) / float(steps);
     float x = radius * sin(angle);
     float y = radius * cos(angle);
-    sf::Vector2f point = castRay(image, sf::Color::Transparent, {cx, cy}, 57.29f * angle);
+    sf::Vector2f point = castRay(image, sf::Color::Transparent, {cx, cy}, trig::degrees(angle));
     base_shield_points.emplace_back(point - sf::Vector2f(cx, cy));
   }
 }
@@ -171,7 +169,7 @@ sf::Vector2f rotatePoint(const sf::Vector2f& point, float angleRad) {
 // Function to rotate all points in a vector around the origin by a given angle (in degrees)
 void rotatePoints(std::vector<sf::Vector2f>& points, float angleDeg) {
   // Convert angle from degrees to radians
-  float angleRad = angleDeg * (3.14159f / 180.f);
+  float angleRad = trig::radians(angleDeg);
 
   for (auto& point : points) {
     point = rotatePoint(point, angleRad);
@@ -291,8 +289,9 @@ int main() {
     bool can_move = true;
     if (d_theta != 0 || d_s != 0) {
       float angle = mouse.getRotation() + d_theta;
-      float dx = std::cos((angle - 90.0f) * 3.14f / 180.0f) * d_s;
-      float dy = std::sin((angle - 90.0f) * 3.14f / 180.0f) * d_s;
+      Angle heading = Angle::from_degrees(angle - 90);
+      float dx = heading.cos() * d_s;
+      float dy = heading.sin() * d_s;
       sf::Vector2f movement(dx, dy);
       /// get the entire new position, including rotation.
       /// test that for collision and then set the flag
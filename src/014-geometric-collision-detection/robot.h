@@ -6,6 +6,7 @@
 #define ROBOT_H
 
 #include <cmath>
+#include "angle.h"
 class Robot {
  public:
   Robot(float width, float height, float origin_x, float origin_y) : m_width(width), m_height(height), m_origin_x(origin_x), m_origin_y(origin_y) {
@@ -14,8 +15,9 @@ class Robot {
 
   void update(float deltaTime) {
     float ds = m_speed * deltaTime;
-    float dx = std::cos((m_angle - 90) * 3.14 / 180) * ds;
-    float dy = std::sin((m_angle - 90) * 3.14 / 180) * ds;
+    Angle heading = Angle::from_degrees(m_angle - 90);
+    float dx = heading.cos() * ds;
+    float dy = heading.sin() * ds;
     m_x += dx;
     m_y += dy;
   }
@@ -44,7 +46,7 @@ class Robot {
   float m_origin_y = 0;
   float m_x = 0.0f;
   float m_y = 0.0f;      // Position
-  float m_angle = 0.0f;  // Angle in radians
+  float m_angle = 0.0f;  // Angle in degrees
   float m_speed = 0.0f;
   float m_omega = 0.f;
 };
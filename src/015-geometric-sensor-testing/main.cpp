@@ -1,15 +1,27 @@
 #include <imgui-SFML.h>
 #include <imgui.h>
 #include <SFML/Graphics.hpp>
+#include <algorithm>
+#include <chrono>
 #include <cmath>
+#include <cstdio>
+#include <cstring>
 #include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+#ifndef NDEBUG
+#define ALLOC_TRACKER_IMPLEMENTATION  // counting costs time on every allocation, so debug builds only
+#endif
+#include "alloc_tracker.h"
+#include "angle.h"
+#include "frame_arena.h"
 #include "maze.h"
 #include "object.h"
+#include "profiler_view.h"
+#include "robot.h"
 #include "sensor.h"
 
-#ifndef M_PI
-#define M_PI (3.14159265358979323846)
-#endif
 /***
  * This app tests the ability to do collision detection by geometry. The robot will have its
  * geometry defined by a number of shapes. In this case a single circle and a rectangle which
@@ -41,6 +53,15 @@
  *
  * The most appropriate response might be to halt the robot for log checking.
  *
+ * Run with --bench to skip the window and time the different ways to get the sines and
+ * cosines for the sensor rays and robot headings (see angle.h), then the sensor model
+ * and robot kinematics in float, double and fixed point (see fixed_point.h).
+ *
+ * Run with --alloc-check [budget] to run the simulation without a window and count the
+ * heap allocations in each frame (see alloc_tracker.h). It exits with 1 if any frame
+ * makes more than the budget, which is 0 if not given. The profiler window shows the
+ * same counts live, with the budget set to 0. The tracker is only installed in debug
+ * builds, so a release build exits with 2 and says so.
  *
  */
 
@@ -69,6 +90,7 @@ struct RobotState {
   sf::Vector2f lds_offs = sf::Vector2f(-10, -50);
   sf::Vector2f rds_offs = sf::Vector2f(+10, -50);
   sf::Vector2f rfs_offs = sf::Vector2f(+30, -40);
+  SensorModelConfig sensor_model;
 };
 
 RobotState g_robot_state;
@@ -88,6 +110,10 @@ void configure_sensor_geometry(CollisionGeometry& robot) {
   sensor_rds.set_half_angle((float)g_robot_state.sensor_half_angle);
   sensor_rfs.set_angle(robot.angle());
   sensor_rfs.set_half_angle((float)g_robot_state.sensor_half_angle);
+  sensor_lfs.set_model_config(g_robot_state.sensor_model);
+  sensor_lds.set_model_config(g_robot_state.sensor_model);
+  sensor_rds.set_model_config(g_robot_state.sensor_model);
+  sensor_rfs.set_model_config(g_robot_state.sensor_model);
 
   /// Update the sensor geometry. This is done after we have
   /// decided if we have collided or not so the angles and positions are correct
@@ -110,29 +136,8 @@ void configure_sensor_geometry(CollisionGeometry& robot) {
   sensor_rds.set_angle(robot.angle() + rds_ang);
   sensor_rfs.set_angle(robot.angle() + rfs_ang);
 }
-/// there seems to be little penalty for having a large number of rays.
-
-int main() {
-  // Create the window
-  /// Any antialiasing has to be set globally when creating the window:
-  sf::ContextSettings settings;
-  settings.antialiasingLevel = 8;  // the number of multi-samplings to use. 4 is probably fine
-  sf::RenderWindow window(sf::VideoMode(1200, 800), WINDOW_TITLE, sf::Style::Default, settings);
-
-  window.setFramerateLimit(60);
-  sf::Font font;
-  if (!font.loadFromFile("./assets/fonts/consolas.ttf")) {
-    exit(1);
-  }
-  if (!ImGui::SFML::Init(window)) {
-    std::cerr << "failed to initialose ImGui\n";
-    exit(1);
-  };
-  sf::Text text;
-  text.setFont(font);
-  text.setCharacterSize(20);                     // in pixels, not points!
-  text.setFillColor(sf::Color(255, 0, 0, 255));  // it can be any colour//  text.setStyle(sf::Text::Bold | sf::Text::Underlined);  // and have the usual styles
 
+void build_robot() {
   /// Create a collision object representing the mouse geometry
   /// The components of the collision shape are added in order from bottom to top
   /// THe first one added will be the under he rest and is first checked
@@ -147,6 +152,9 @@ int main() {
 
   g_robot.setPosition(96, 96);
   g_robot.setRotation(180);
+}
+
+std::unique_ptr<Maze> build_maze() {
   std::unique_ptr<Maze> maze = std::make_unique<Maze>();
   maze->add_posts(5, 5);
   /// note that  this is a simple demo, nothing stops duplicate walls
@@ -163,13 +171,349 @@ int main() {
   maze->add_wall(2, 0, SOUTH);
   maze->add_wall(1, 1, EAST);
   maze->add_wall(0, 2, EAST);
+  return maze;
+}
+
+/// move the robot unless that would take it into a wall, then put the sensors where it ended up. True if it hit something
+bool move_robot(Maze& maze, float d_s, float d_theta) {
+  sf::Vector2f old_cg = g_robot.position();
+  float old_angle = g_robot.angle();
+  float angle = g_robot.angle() + d_theta;
+  Angle heading = Angle::from_degrees(angle - 90);
+  float dx = heading.cos() * d_s;
+  float dy = heading.sin() * d_s;
+  sf::Vector2f movement(dx, dy);
+  g_robot.rotate(d_theta);
+  g_robot.setPosition(g_robot.position() + movement);
+  bool collided = false;
+  /// set the object colours to highlight collisions
+  for (auto& wall : maze.walls) {
+    wall.setFillColor(sf::Color::Red);
+    if (g_robot.collides_with(wall)) {
+      collided = true;
+      wall.setFillColor(sf::Color::Yellow);
+      break;
+    }
+  }
+  g_robot.set_colour(sf::Color::White);
+  if (collided) {
+    g_robot.set_colour(sf::Color::Red);
+    g_robot.setPosition(old_cg);
+    g_robot.setRotation(old_angle);
+  }
+  /////
+  /// Robot is now in place
+  /// so we update the sensor geometry
+
+  g_robot_state.angle = (int)g_robot.angle();
+
+  configure_sensor_geometry(g_robot);
+  return collided;
+}
+
+void write_hud(std::pmr::string& string, float dt, uint64_t heap_allocations) {
+  string += " WASD keys move robot\n\n";
+  appendf(string, "           FPS: %d\n", (int)(1.0f / dt));
+  appendf(string, "     mouse pos: %d,%d\n", (int)g_robot.position().x, (int)g_robot.position().y);
+  appendf(string, "     mouse ang: %f\n", g_robot.angle());
+  appendf(string, "    sensor_lfs: %d -> %d mm\n", int(sensor_lfs.power()), int(sensor_lfs.distance()));
+  appendf(string, "    sensor_lds: %d -> %d mm\n", int(sensor_lds.power()), int(sensor_lds.distance()));
+  appendf(string, "    sensor_rds: %d -> %d mm\n", int(sensor_rds.power()), int(sensor_rds.distance()));
+  appendf(string, "    sensor_rfs: %d -> %d mm\n", int(sensor_rfs.power()), int(sensor_rfs.distance()));
+  if (alloc_tracker::installed()) {
+    appendf(string, "          heap: %llu allocations\n", (unsigned long long)heap_allocations);
+  }
+}
+
+/***
+ * Run the simulation part of a frame - moving the robot, checking for collisions,
+ * reading the sensors and writing the HUD text - without a window, and count the heap
+ * allocations in each frame once it has settled. Returns 1 if any frame makes more
+ * than the budget, so that a CI job can run `--alloc-check 0` and fail when something
+ * starts allocating on the hot path. Needs the allocation tracker, which this file installs in debug builds.
+ */
+int allocation_check(int budget) {
+  if (!alloc_tracker::installed()) {
+    std::fprintf(stderr, "--alloc-check needs the allocation tracker, which is only installed in debug builds\n");
+    return 2;
+  }
+  const int warm_up = 10;
+  const int frames = 480;  // less than the profiler keeps
+  build_robot();
+  std::unique_ptr<Maze> maze = build_maze();
+  FrameArena arena;
+  Profiler& profiler = Profiler::get();
+  uint64_t worst = 0;
+  uint64_t total = 0;
+  int over = 0;
+  /// the frame that has just finished
+  auto record = [&]() {
+    const uint64_t allocations = profiler.frame_allocations(1).allocations;
+    worst = std::max(worst, allocations);
+    total += allocations;
+    over += allocations > uint64_t(budget) ? 1 : 0;
+  };
+  for (int frame = 0; frame < warm_up + frames; frame++) {
+    PROFILE_FRAME();
+    arena.reset();
+    if (frame > warm_up) {
+      record();
+    }
+    {
+      PROFILE_SCOPE("update");
+      /// drive round in circles so that the robot keeps meeting walls
+      move_robot(*maze, 2.0f, frame % 200 < 100 ? 3.0f : -1.0f);
+    }
+    {
+      PROFILE_SCOPE("sensors");
+      sensor_lfs.update(maze->walls);
+      sensor_lds.update(maze->walls);
+      sensor_rds.update(maze->walls);
+      sensor_rfs.update(maze->walls);
+    }
+    {
+      PROFILE_SCOPE("hud");
+      std::pmr::string hud = arena.string();
+      write_hud(hud, 1.0f / 60.0f, worst);
+    }
+  }
+  PROFILE_FRAME();
+  record();
+
+  /// the allocations in each phase, from the profiler's record of the run
+  std::vector<ProfileEvent> events;
+  profiler.thread().copy(profiler.frame_start(frames), profiler.frame_start(0), events);
+  for (const char* phase : {"update", "sensors", "hud"}) {
+    uint64_t count = 0;
+    for (const ProfileEvent& e : events) {
+      count += std::strcmp(e.name, phase) == 0 ? e.allocations : 0;
+    }
+    std::printf("%10s %8.2f allocations per frame\n", phase, double(count) / frames);
+  }
+  std::printf("%10s %8.2f allocations per frame, worst %llu, budget %d, %d frames over\n", "frame", double(total) / frames,
+              (unsigned long long)worst, budget, over);
+  return over > 0 ? 1 : 0;
+}
+
+/// how fast and how accurate each way of getting a sine and cosine is, on a few thousand angles that stay in the cache
+void trig_benchmark() {
+  const size_t n = simd::padded(4096);
+  std::vector<float> radians(n), s(n), c(n), x(n), y(n), out(n);
+  std::vector<Angle> angles(n);
+  for (size_t i = 0; i < n; i++) {
+    radians[i] = -50.0f + 100.0f * float(i) / float(n);
+    angles[i] = Angle::from_radians(radians[i]);
+    x[i] = std::cos(radians[i]) * (1.0f + float(i % 7));
+    y[i] = std::sin(radians[i]) * (1.0f + float(i % 7));
+  }
+  auto time_ns = [n](auto&& kernel) {
+    kernel();  // warm up
+    const int repeats = 2000;
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < repeats; r++) {
+      kernel();
+    }
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(end - start).count() / repeats / double(n);
+  };
+  auto sincos_error = [&]() {
+    double worst = 0;
+    for (size_t i = 0; i < n; i++) {
+      worst = std::max({worst, std::abs(s[i] - std::sin((double)radians[i])), std::abs(c[i] - std::cos((double)radians[i]))});
+    }
+    return worst;
+  };
+  auto report = [](const char* name, double ns, double error) { std::printf("%-22s %8.2f ns %12.2g\n", name, ns, error); };
+
+  std::printf("%-22s %11s %12s\n", "", "per angle", "max error");
+  double ns = time_ns([&] {
+    for (size_t i = 0; i < n; i++) {
+      s[i] = std::sin(radians[i]);
+      c[i] = std::cos(radians[i]);
+    }
+  });
+  report("std::sin + std::cos", ns, sincos_error());
+  for (trig::Accuracy accuracy : {trig::Accuracy::High, trig::Accuracy::Low}) {
+    const bool high = accuracy == trig::Accuracy::High;
+    ns = time_ns([&] {
+      for (size_t i = 0; i < n; i++) {
+        trig::sincos(radians[i], s[i], c[i], accuracy);
+      }
+    });
+    report(high ? "High" : "Low", ns, sincos_error());
+    ns = time_ns([&] { trig::sincos(radians.data(), s.data(), c.data(), n, accuracy); });
+    report(high ? "High, batch" : "Low, batch", ns, sincos_error());
+  }
+  ns = time_ns([&] { trig::sincos(angles.data(), s.data(), c.data(), n); });
+  report("Angle table", ns, sincos_error());
+
+  ns = time_ns([&] {
+    for (size_t i = 0; i < n; i++) {
+      out[i] = std::atan2(y[i], x[i]);
+    }
+  });
+  report("std::atan2", ns, 0);
+  for (trig::Accuracy accuracy : {trig::Accuracy::High, trig::Accuracy::Low}) {
+    ns = time_ns([&] { trig::atan2(y.data(), x.data(), out.data(), n, accuracy); });
+    double worst = 0;
+    for (size_t i = 0; i < n; i++) {
+      worst = std::max(worst, std::abs(out[i] - std::atan2((double)y[i], (double)x[i])));
+    }
+    report(accuracy == trig::Accuracy::High ? "atan2 High, batch" : "atan2 Low, batch", ns, worst);
+  }
+}
+
+/***
+ * The same sensor readings and robot journey in float, double and fixed point. The
+ * readings are compared with double, in ADC counts. The journey is ten seconds at
+ * a 1kHz tick, turning all the time, and the drift is how far the robot ends up
+ * from where the double version does. Most of the fixed point drift is because
+ * 1ms is 66/65536 of a second in Q16.16, which is 0.7% too long. Firmware
+ * that ticks at 1024Hz does not have that problem.
+ */
+struct NumericReference {
+  std::vector<float> distance;
+  std::vector<float> cos_incidence;
+  int rays = 16;
+  std::vector<float> readings;
+  double x = 0;
+  double y = 0;
+};
+
+/// the time for one sensor update and the worst difference from the reference readings
+template <typename T>
+std::pair<double, float> sensor_run(NumericReference& reference) {
+  const int rays = reference.rays;
+  const int updates = int(reference.distance.size()) / rays;
+  std::vector<float> readings(updates);
+  BasicSensorModel<T> model;
+  auto start = std::chrono::steady_clock::now();
+  for (int u = 0; u < updates; u++) {
+    readings[u] = model.update(reference.distance.data() + u * rays, reference.cos_incidence.data() + u * rays, rays);
+  }
+  auto end = std::chrono::steady_clock::now();
+  double sensor_ns = std::chrono::duration<double, std::nano>(end - start).count() / updates;
+  if (reference.readings.empty()) {
+    reference.readings = readings;
+  }
+  float worst = 0;
+  for (int u = 0; u < updates; u++) {
+    worst = std::max(worst, std::abs(readings[u] - reference.readings[u]));
+  }
+  return {sensor_ns, worst};
+}
+
+template <typename T>
+void numeric_run(const char* name, NumericReference& reference) {
+  auto [sensor_ns, worst] = sensor_run<T>(reference);
+
+  const int ticks = 10000;
+  BasicRobot<T> robot(76, 100, 38, 62);
+  robot.setSpeed(T(500));
+  const T dt = Numeric<T>::from(0.001f);
+  const Angle turn = Angle::from_degrees(0.05f);
+  auto start = std::chrono::steady_clock::now();
+  for (int tick = 0; tick < ticks; tick++) {
+    robot.update(dt);
+    robot.rotate(turn);
+  }
+  auto end = std::chrono::steady_clock::now();
+  double robot_ns = std::chrono::duration<double, std::nano>(end - start).count() / ticks;
+  if (std::is_same_v<T, double>) {
+    reference.x = double(robot.m_x);
+    reference.y = double(robot.m_y);
+  }
+  double drift = std::hypot(double(robot.m_x) - reference.x, double(robot.m_y) - reference.y);
+  std::printf("%-8s %10.1f ns %12.3g %10.1f ns %12.3g\n", name, sensor_ns, worst, robot_ns, drift);
+}
+
+void numeric_benchmark() {
+  NumericReference reference;
+  const int updates = 100000;
+  reference.distance.resize(reference.rays * updates);
+  reference.cos_incidence.resize(reference.rays * updates);
+  Xoshiro128 rng(42);
+  for (size_t i = 0; i < reference.distance.size(); i++) {
+    reference.distance[i] = rng.uniform(20.0f, 300.0f);
+    reference.cos_incidence[i] = rng.uniform(0.5f, 1.0f);
+  }
+  std::printf("\n%-8s %13s %12s %13s %12s\n", "", "sensor", "max counts", "robot", "drift");
+  numeric_run<double>("double", reference);  // first, as the reference for the others
+  numeric_run<float>("float", reference);
+  numeric_run<Q16_16>("Q16.16", reference);
+
+  /// a wide fan close to the wall, where the Q16.16 sums are nearest the top of their range
+  NumericReference close;
+  close.rays = 64;
+  close.distance.resize(close.rays * updates);
+  close.cos_incidence.resize(close.rays * updates);
+  const float ranges[] = {2, 5, 20, 30, 35, 45};
+  for (size_t i = 0; i < close.distance.size(); i++) {
+    const float near = ranges[(i / close.rays) % std::size(ranges)];
+    close.distance[i] = rng.uniform(near, near + 10.0f);
+    close.cos_incidence[i] = rng.uniform(0.5f, 1.0f);
+  }
+  std::printf("\n%-8s %13s %12s   (%d rays, 2 to 55 from the wall)\n", "", "sensor", "max counts", close.rays);
+  auto report = [](const char* name, std::pair<double, float> result) { std::printf("%-8s %10.1f ns %12.3g\n", name, result.first, result.second); };
+  report("double", sensor_run<double>(close));
+  report("float", sensor_run<float>(close));
+  report("Q16.16", sensor_run<Q16_16>(close));
+}
+
+/// there seems to be little penalty for having a large number of rays.
+
+int main(int argc, char** argv) {
+  if (argc > 1 && std::strcmp(argv[1], "--bench") == 0) {
+    trig_benchmark();
+    numeric_benchmark();
+    return 0;
+  }
+  if (argc > 1 && std::strcmp(argv[1], "--alloc-check") == 0) {
+    return allocation_check(argc > 2 ? std::atoi(argv[2]) : 0);
+  }
+  // Create the window
+  /// Any antialiasing has to be set globally when creating the window:
+  sf::ContextSettings settings;
+  settings.antialiasingLevel = 8;  // the number of multi-samplings to use. 4 is probably fine
+  sf::RenderWindow window(sf::VideoMode(1200, 800), WINDOW_TITLE, sf::Style::Default, settings);
+
+  window.setFramerateLimit(60);
+  sf::Font font;
+  if (!font.loadFromFile("./assets/fonts/consolas.ttf")) {
+    exit(1);
+  }
+  if (!ImGui::SFML::Init(window)) {
+    std::cerr << "failed to initialose ImGui\n";
+    exit(1);
+  };
+  ImPlot::CreateContext();
+  ProfilerView profiler_view;
+  profiler_view.allocation_budget = 0;
+  sf::Text text;
+  text.setFont(font);
+  text.setCharacterSize(20);                     // in pixels, not points!
+  text.setFillColor(sf::Color(255, 0, 0, 255));  // it can be any colour//  text.setStyle(sf::Text::Bold | sf::Text::Underlined);  // and have the usual styles
+
+  build_robot();
+  std::unique_ptr<Maze> maze = build_maze();
 
   float v = 180;
   float omega = 180;
 
+  /// the HUD text is built in the arena and only handed to SFML when it changes
+  FrameArena arena;
+  std::string hud_text;
+  hud_text.reserve(512);
+  uint64_t heap_allocations = 0;
+  uint64_t allocations_before = alloc_tracker::allocations();
+
   sf::Clock frame_clock;
   // Main loop
   while (window.isOpen()) {
+    PROFILE_FRAME();
+    arena.reset();
+    heap_allocations = alloc_tracker::allocations() - allocations_before;
+    allocations_before = alloc_tracker::allocations();
     // Event handling
     sf::Time frame_time = frame_clock.restart();
     float dt = frame_time.asSeconds();
@@ -177,128 +521,113 @@ int main() {
     float d_s = 0;
     bool move = false;
     sf::Event event{};
-    while (window.pollEvent(event)) {
-      ImGui::SFML::ProcessEvent(window, event);
-      if (event.type == sf::Event::Closed) {
-        window.close();
-      }
-      if (sf::Keyboard::isKeyPressed(sf::Keyboard::Escape)) {
-        window.close();
-      }
-      if (event.type == sf::Event::Resized) {
-        sf::FloatRect visibleArea(0, 0, (float)event.size.width, (float)event.size.height);
-        window.setView(sf::View(visibleArea));  // or everything distorts
-      }
-    }
-    ImGui::SFML::Update(window, frame_time);
-    ImGui::Begin("Sensors");
-    /// TODO: figure out how to use ImGui rotate/move the robot, overriding the current
-    ///       motion
-    /// ImGui::SliderInt("Robot Angle", &g_robot_state.angle, 0, 360);
-    ImGui::SliderInt("Sensor Half Angle", &g_robot_state.sensor_half_angle, 1.0f, 30.0f);
-    ImGui::SliderInt("Side Sensor Angle", &g_robot_state.side_sensor_angle, 1.0f, 60.0f);
-    ImGui::SliderInt("Front Sensor Angle", &g_robot_state.front_sensor_angle, 1.0f, 30.0f);
-    ImGui::End();
-
-    if (window.hasFocus()) {
-      if (sf::Keyboard::isKeyPressed(sf::Keyboard::A)) {
-        d_theta = -omega * dt;
-        // rotate = true;
-        move = true;
-      }
-      if (sf::Keyboard::isKeyPressed(sf::Keyboard::D)) {
-        d_theta = omega * dt;
-        move = true;
-        // rotate = true;
-      }
-      if (sf::Keyboard::isKeyPressed(sf::Keyboard::W)) {
-        d_s = v * dt;
-        move = true;
-      }
-      if (sf::Keyboard::isKeyPressed(sf::Keyboard::S)) {
-        d_s = -v * dt;
-        move = true;
-      }
-      if (sf::Keyboard::isKeyPressed(sf::Keyboard::LShift) || sf::Keyboard::isKeyPressed(sf::Keyboard::RShift)) {
-        d_s /= 10;
-        d_theta /= 10;
+    {
+      PROFILE_SCOPE("events");
+      while (window.pollEvent(event)) {
+        ImGui::SFML::ProcessEvent(window, event);
+        if (event.type == sf::Event::Closed) {
+          window.close();
+        }
+        if (sf::Keyboard::isKeyPressed(sf::Keyboard::Escape)) {
+          window.close();
+        }
+        if (event.type == sf::Event::Resized) {
+          sf::FloatRect visibleArea(0, 0, (float)event.size.width, (float)event.size.height);
+          window.setView(sf::View(visibleArea));  // or everything distorts
+        }
       }
     }
-
-    sf::Clock clock;
-
-    sf::Vector2f old_cg = g_robot.position();
-    float old_angle = g_robot.angle();
-    if (move) {
-      float angle = g_robot.angle() + d_theta;
-      float dx = std::cos((angle - 90.0f) * 3.14f / 180.0f) * d_s;
-      float dy = std::sin((angle - 90.0f) * 3.14f / 180.0f) * d_s;
-      sf::Vector2f movement(dx, dy);
-      g_robot.rotate(d_theta);
-      g_robot.setPosition(g_robot.position() + movement);
-    }
     bool collided = false;
-    /// set the object colours to highlight collisions
-    for (auto& wall : maze->walls) {
-      wall.setFillColor(sf::Color::Red);
-      if (g_robot.collides_with(wall)) {
-        collided = true;
-        wall.setFillColor(sf::Color::Yellow);
-        break;
-      }
-    }
-    g_robot.set_colour(sf::Color::White);
-    if (collided) {
-      g_robot.set_colour(sf::Color::Red);
-      g_robot.setPosition(old_cg);
-      g_robot.setRotation(old_angle);
-    }
-    /////
-    /// Robot is now in place
-    /// so we update the sensor geometry
+    {
+      PROFILE_SCOPE("update");
+      ImGui::SFML::Update(window, frame_time);
+      ImGui::Begin("Sensors");
+      /// TODO: figure out how to use ImGui rotate/move the robot, overriding the current
+      ///       motion
+      /// ImGui::SliderInt("Robot Angle", &g_robot_state.angle, 0, 360);
+      ImGui::SliderInt("Sensor Half Angle", &g_robot_state.sensor_half_angle, 1.0f, 30.0f);
+      ImGui::SliderInt("Side Sensor Angle", &g_robot_state.side_sensor_angle, 1.0f, 60.0f);
+      ImGui::SliderInt("Front Sensor Angle", &g_robot_state.front_sensor_angle, 1.0f, 30.0f);
+      ImGui::Separator();
+      ImGui::SliderFloat("Reflectance Angle", &g_robot_state.sensor_model.reflectance_weight, 0.0f, 1.0f);
+      ImGui::SliderFloat("Noise (counts)", &g_robot_state.sensor_model.noise_sigma, 0.0f, 50.0f);
+      ImGui::SliderInt("ADC Bits", &g_robot_state.sensor_model.adc_bits, 6, 12);
+      ImGui::SliderInt("Sample Hold", &g_robot_state.sensor_model.hold, 1, 10);
+      ImGui::SliderInt("Latency", &g_robot_state.sensor_model.latency, 0, SensorModel::MAX_LATENCY);
+      ImGui::End();
 
-    g_robot_state.angle = (int)g_robot.angle();
+      if (window.hasFocus()) {
+        if (sf::Keyboard::isKeyPressed(sf::Keyboard::A)) {
+          d_theta = -omega * dt;
+          // rotate = true;
+          move = true;
+        }
+        if (sf::Keyboard::isKeyPressed(sf::Keyboard::D)) {
+          d_theta = omega * dt;
+          move = true;
+          // rotate = true;
+        }
+        if (sf::Keyboard::isKeyPressed(sf::Keyboard::W)) {
+          d_s = v * dt;
+          move = true;
+        }
+        if (sf::Keyboard::isKeyPressed(sf::Keyboard::S)) {
+          d_s = -v * dt;
+          move = true;
+        }
+        if (sf::Keyboard::isKeyPressed(sf::Keyboard::LShift) || sf::Keyboard::isKeyPressed(sf::Keyboard::RShift)) {
+          d_s /= 10;
+          d_theta /= 10;
+        }
+      }
 
-    configure_sensor_geometry(g_robot);
+      collided = move_robot(*maze, move ? d_s : 0.0f, move ? d_theta : 0.0f);
+    }
 
-    sf::Int64 phase1 = clock.restart().asMicroseconds();
-    sensor_lfs.update(maze->walls);
-    sensor_lds.update(maze->walls);
-    sensor_rds.update(maze->walls);
-    sensor_rfs.update(maze->walls);
+    {
+      PROFILE_SCOPE("sensors");
+      sensor_lfs.update(maze->walls);
+      sensor_lds.update(maze->walls);
+      sensor_rds.update(maze->walls);
+      sensor_rfs.update(maze->walls);
+    }
 
     /////////////////////////////////////////////////////////
     /////////////////////////////////////////////////////////
-    window.clear(sf::Color::Black);
-    maze->draw(window);
-    g_robot.draw(window);
-    sensor_lfs.draw(window);
-    sensor_lds.draw(window);
-    sensor_rds.draw(window);
-    sensor_rfs.draw(window);
-
-    std::string string;
-    string += " WASD keys move robot\n\n";
-    string += "           FPS: " + std::to_string((int)(1.0f / dt)) + "\n";
-    string += "     mouse pos: " + std::to_string((int)g_robot.position().x) + "," + std::to_string((int)g_robot.position().y) + "\n";
-    string += "     mouse ang: " + std::to_string(g_robot.angle()) + "\n";
-    string += "check and move: " + std::to_string(phase1) + " us\n";
-    string += "    sensor_lfs: " + std::to_string(int(sensor_lfs.power())) + " -> " + std::to_string(int(sensor_lfs.distance())) + " mm\n";
-    string += "    sensor_lds: " + std::to_string(int(sensor_lds.power())) + " -> " + std::to_string(int(sensor_lds.distance())) + " mm\n";
-    string += "    sensor_rds: " + std::to_string(int(sensor_rds.power())) + " -> " + std::to_string(int(sensor_rds.distance())) + " mm\n";
-    string += "    sensor_rfs: " + std::to_string(int(sensor_rfs.power())) + " -> " + std::to_string(int(sensor_rfs.distance())) + " mm\n";
-    if (collided) {
-      text.setFillColor(sf::Color::Yellow);
-    } else {
-      text.setFillColor(sf::Color::Red);
+    {
+      PROFILE_SCOPE("render");
+      window.clear(sf::Color::Black);
+      maze->draw(window);
+      g_robot.draw(window);
+      sensor_lfs.draw(window);
+      sensor_lds.draw(window);
+      sensor_rds.draw(window);
+      sensor_rfs.draw(window);
+
+      std::pmr::string string = arena.string();
+      string.reserve(512);
+      write_hud(string, dt, heap_allocations);
+      if (collided) {
+        text.setFillColor(sf::Color::Yellow);
+      } else {
+        text.setFillColor(sf::Color::Red);
+      }
+      if (std::string_view(hud_text) != std::string_view(string)) {
+        hud_text.assign(string.data(), string.size());
+        text.setString(hud_text);
+      }
+      text.setPosition(800, 10);
+      window.draw(text);
+      profiler_view.draw();
+      ImGui::SFML::Render(window);
+    }
+    {
+      PROFILE_SCOPE("display");
+      window.display();
     }
-    text.setString(string);
-    text.setPosition(800, 10);
-    window.draw(text);
-    ImGui::SFML::Render(window);
-    window.display();
   }
 
+  ImPlot::DestroyContext();
   ImGui::SFML::Shutdown();
 
   return 0;
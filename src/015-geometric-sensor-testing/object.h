@@ -6,6 +6,7 @@
 #include <iostream>
 #include <memory>
 #include <vector>
+#include "angle.h"
 #include "collisions.h"
 
 class CollisionGeometry {
@@ -48,9 +49,9 @@ class CollisionGeometry {
 
   void setRotation(float angle) {
     m_angle = angle;
-    float radAngle = m_angle * (3.14159265359f / 180.f);
-    float cosAngle = std::cos(radAngle);
-    float sinAngle = std::sin(radAngle);
+    float cosAngle;
+    float sinAngle;
+    trig::sincos(trig::radians(m_angle), sinAngle, cosAngle);
 
     for (auto& shape_data : shapedata) {
       auto& shape = shape_data.shape;
@@ -5,35 +5,54 @@
 #ifndef ROBOT_H
 #define ROBOT_H
 
+#include <SFML/System/Vector2.hpp>
 #include <cmath>
-class Robot {
+#include "angle.h"
+#include "fixed_point.h"
+
+/***
+ * The robot kinematics. T is the number type for the position, speed and time
+ * so that the robot can be moved with the same fixed point sums as the firmware
+ * (see fixed_point.h). The heading is a binary Angle, which is how the firmware
+ * keeps it, and is set and read in degrees like an sf::Transformable.
+ *
+ * Robot is the float version that the views use.
+ */
+template <typename T = float>
+class BasicRobot {
  public:
-  Robot(float width, float height, float origin_x, float origin_y) : m_width(width), m_height(height), m_origin_x(origin_x), m_origin_y(origin_y) {
-    setPosition(100, 100);
+  using Num = Numeric<T>;
+
+  BasicRobot(float width, float height, float origin_x, float origin_y) : m_width(width), m_height(height), m_origin_x(origin_x), m_origin_y(origin_y) {
+    setPosition(T(100), T(100));
   };
 
-  void update(float deltaTime) {
-    float ds = m_speed * deltaTime;
-    float dx = std::cos((m_angle - 90) * 3.14 / 180) * ds;
-    float dy = std::sin((m_angle - 90) * 3.14 / 180) * ds;
-    m_x += dx;
-    m_y += dy;
+  void update(T deltaTime) {
+    T ds = m_speed * deltaTime;
+    /// an angle of zero points up the screen
+    Angle heading = m_heading - Angle::from_bits(1u << 30);
+    m_x += Num::cos(heading) * ds;
+    m_y += Num::sin(heading) * ds;
   }
 
-  void setSpeed(float speed) { m_speed = speed; }
-  void setOmega(float omega) { m_omega = omega; }
-  void setDirection(float angle) { m_angle = angle; }
+  void setSpeed(T speed) { m_speed = speed; }
+  void setOmega(T omega) { m_omega = omega; }
+  void setDirection(float angle) { m_heading = Angle::from_degrees(angle); }
   void move(sf::Vector2f direction) {
-    m_x += direction.x;
-    m_y += direction.y;
+    m_x += Num::from(direction.x);
+    m_y += Num::from(direction.y);
   }
-  void setPosition(float x, float y) {
+  void setPosition(T x, T y) {
     m_x = x;
     m_y = y;
   }
-  void rotate(float angle) { m_angle += angle; }
+  void rotate(float angle) { m_heading += Angle::from_degrees(angle); }
+  void rotate(Angle angle) { m_heading += angle; }
   void set_state(int state) { m_state = state; }
 
+  /// in degrees, -180 to 180
+  [[nodiscard]] float angle() const { return m_heading.degrees(); }
+
   // Add more methods as needed for behaviour and dynamics
 
   // private:
@@ -42,11 +61,13 @@ class Robot {
   float m_height = 0;
   float m_origin_x = 0;
   float m_origin_y = 0;
-  float m_x = 0.0f;
-  float m_y = 0.0f;      // Position
-  float m_angle = 0.0f;  // Angle in radians
-  float m_speed = 0.0f;
-  float m_omega = 0.f;
+  T m_x{};
+  T m_y{};  // Position
+  Angle m_heading;
+  T m_speed{};
+  T m_omega{};
 };
 
+using Robot = BasicRobot<float>;
+
 #endif  // ROBOT_H
@@ -37,12 +37,12 @@ class RobotView {
   }
 
   void update() {
-    m_shape.rotate(m_robot.m_angle);
+    m_shape.rotate(m_robot.angle());
     m_shape.setPosition(m_robot.m_x, m_robot.m_y);
-    m_sprite.setRotation(m_robot.m_angle);
+    m_sprite.setRotation(m_robot.angle());
     m_sprite.setPosition(m_robot.m_x, m_robot.m_y);
     // setTextureRect(sf::IntRect(m_robot.m_state * m_robot.m_width, 0, m_robot.m_width, m_robot.m_height));
-    //    setRotation(m_robot.m_angle);
+    //    setRotation(m_robot.angle());
     //    setPosition(m_robot.m_x, m_robot.m_y);
   }
   void draw(sf::RenderTarget& target) {
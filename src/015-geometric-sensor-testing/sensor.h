@@ -3,10 +3,10 @@
 
 #include <SFML/Graphics.hpp>
 #include <vector>
+#include "angle.h"
+#include "sensor_model.h"
 #include "utils.h"
 
-const float DEG_TO_RAD = 3.14159265359f / 180.0f;
-
 class Sensor {
  public:
   Sensor(sf::Vector2f origin, float angle, float half_angle = 5.0f, int ray_count = 16)
@@ -19,6 +19,9 @@ class Sensor {
     m_max_range = 500.0f;
     m_power = 0.0f;
     m_distance = 0.0f;
+    /// every sensor gets its own noise sequence
+    static uint32_t instance_count = 0;
+    m_model.set_seed(0x9E3779B9u * ++instance_count);
   }
 
   void set_origin(const sf::Vector2f& origin) {
@@ -33,6 +36,11 @@ class Sensor {
 
   void set_ray_count(int ray_count) { m_rays = ray_count; }
 
+  /// change the way that ray distances are turned into a sensor reading
+  void set_model_config(const SensorModelConfig& config) { m_model.set_config(config); }
+
+  [[nodiscard]] const SensorModelConfig& model_config() const { return m_model.config(); }
+
   [[nodiscard]] float power() const { return m_power; }
   [[nodiscard]] float distance() const { return m_distance; }
 
@@ -46,22 +54,28 @@ class Sensor {
    */
   void update(const std::vector<sf::RectangleShape>& obstacles) {
     // Calculate angular increment for rays
-    float startAngle = (m_angle - m_half_angle) * DEG_TO_RAD;
-    float endAngle = (m_angle + m_half_angle) * DEG_TO_RAD;
+    float startAngle = trig::radians(m_angle - m_half_angle);
+    float endAngle = trig::radians(m_angle + m_half_angle);
     float angleIncrement = (endAngle - startAngle) / float(m_rays - 1);
 
-    float total_power = 0;
     float total_distance = 0;
+    int ray_count = m_rays - 1;
+    m_ray_distance.resize(ray_count);
+    m_ray_cos.resize(ray_count);
+    m_ray_dir.resize(ray_count);
+    vec2::directions(std::span(m_ray_dir), startAngle, angleIncrement);  // one sin and cos for the whole fan
 
     for (int i = 1; i < m_rays; ++i) {  // Remember to skip origin (index 0)
-      float angle = startAngle + float(i - 1) * angleIncrement;
-      sf::Vector2f dir = {std::cos(angle), std::sin(angle)};
+      const sf::Vector2f& dir = m_ray_dir[i - 1];
 
       float closestHit = m_max_range;
+      int hit_axis = 0;
       for (const auto& rect : obstacles) {
-        float distance = test_to_rect(rect, dir);
+        int axis = 0;
+        float distance = test_to_rect(rect, dir, axis);
         if (distance < closestHit) {
           closestHit = distance;
+          hit_axis = axis;
         }
       }
       // Update the ray endpoint
@@ -69,20 +83,17 @@ class Sensor {
       m_vertices[i].position = hitPosition;
       m_vertices[i].color = sf::Color(128, 0, 128, 255 * (1.0f - closestHit / m_max_range));
 
-      /// Accumulate distance and power for averaging
-      /// you cannot do te power afterwards form the average distance
-      /// because power is not linear with distance.
-      /// perhaps we should only record power and always calculate
-      /// distance - as in the real mouse
-      /// TODO: implement a proper function that calculates power
-      float power = 855.0f / closestHit;
-      power = power * power;
-      total_power += power;
+      /// You cannot do the power afterwards from the average distance
+      /// because power is not linear with distance. The sensor model
+      /// needs every ray along with the angle at which it meets the wall.
+      /// The walls are axis aligned so that is just one component of the ray.
+      m_ray_distance[i - 1] = closestHit;
+      m_ray_cos[i - 1] = std::abs(hit_axis == 0 ? dir.x : dir.y);
       total_distance += closestHit;
     }
 
-    m_distance = std::min(total_distance / float(m_rays - 1), m_max_range);
-    m_power = std::min(total_power / float(m_rays - 1), 1024.0f);
+    m_distance = std::min(total_distance / float(ray_count), m_max_range);
+    m_power = m_model.update(m_ray_distance.data(), m_ray_cos.data(), ray_count);
   }
 
   /// The sensor will be drawn as a triangle fan. This is really
@@ -99,16 +110,19 @@ class Sensor {
    * TODO: I do not fully understand this function.
    * @param rectangle
    * @param ray_dir - as a normalised vector
+   * @param hit_axis - set to 0 if the ray hits a vertical face, 1 for a horizontal face
    * @return the distance to the closest intersection or the maze range if
    * there is no intersection
    */
-  float test_to_rect(const sf::RectangleShape& rectangle, const sf::Vector2f& ray_dir) {
+  float test_to_rect(const sf::RectangleShape& rectangle, const sf::Vector2f& ray_dir, int& hit_axis) {
     sf::FloatRect bounds = rectangle.getGlobalBounds();
     sf::Vector2f rectMin(bounds.left, bounds.top);
     sf::Vector2f rectMax(bounds.left + bounds.width, bounds.top + bounds.height);
 
     float tmin = -std::numeric_limits<float>::infinity();
     float tmax = std::numeric_limits<float>::infinity();
+    int tmin_axis = 0;
+    int tmax_axis = 0;
 
     for (int i = 0; i < 2; ++i) {
       float origin = (i == 0) ? m_origin.x : m_origin.y;
@@ -127,8 +141,14 @@ class Sensor {
 
         if (t1 > t2)
           std::swap(t1, t2);
-        tmin = std::max(tmin, t1);
-        tmax = std::min(tmax, t2);
+        if (t1 > tmin) {
+          tmin = t1;
+          tmin_axis = i;
+        }
+        if (t2 < tmax) {
+          tmax = t2;
+          tmax_axis = i;
+        }
 
         if (tmin > tmax) {
           // No intersection
@@ -140,6 +160,7 @@ class Sensor {
       // Intersection behind the ray origin. Are we INSIDE the box?
       return m_max_range;
     }
+    hit_axis = tmin >= 0 ? tmin_axis : tmax_axis;
     return std::min(tmin >= 0 ? tmin : tmax, m_max_range);  // Intersection behind the ray origin
   }
 
@@ -151,6 +172,10 @@ class Sensor {
   float m_power;
   float m_distance;
 
+  SensorModel m_model;
+  std::vector<float> m_ray_distance;
+  std::vector<float> m_ray_cos;
+  std::vector<sf::Vector2f> m_ray_dir;
   sf::VertexArray m_vertices;
 };
 
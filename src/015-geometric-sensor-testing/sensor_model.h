@@ -0,0 +1,169 @@
+#ifndef SENSOR_MODEL_H
+#define SENSOR_MODEL_H
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+#include "fast_random.h"
+#include "fixed_point.h"
+
+/***
+ * A model of a reflective IR wall sensor. The sensor fan supplies, for every ray, the
+ * distance to the wall and the cosine of the angle at which the ray meets the wall.
+ * The model turns those into the reading that the robot firmware would see:
+ *
+ *   1. optical power   - inverse square with distance, scaled by the wall reflectance
+ *                        which falls off with the angle of incidence
+ *   2. average         - the fan is averaged to give a single power for the emitter
+ *   3. noise           - additive gaussian noise from a small per-sensor generator
+ *   4. quantisation    - the result is clamped and rounded to whole ADC counts
+ *   5. sample and hold - a new conversion is only taken every few updates
+ *   6. latency         - the reading is delayed by a number of updates
+ *
+ * All of the configuration is plain data so the model can be copied about
+ * freely and changed on the fly from the UI. There are no virtual calls or
+ * std::function objects in the per-ray path. The per-ray loop works on flat
+ * arrays so the compiler is free to vectorise it.
+ *
+ * With the default configuration the model gives the same response as the
+ * original hard-coded calculation, apart from rounding to whole counts and the
+ * top of the scale. That was clamped at 1024, and a 10 bit ADC stops at 1023.
+ *
+ * The sums after the ray fan can be done in float, double or fixed point (see
+ * fixed_point.h). BasicSensorModel<Q16_16> does them as the robot firmware would,
+ * so its readings match the robot count for count. The distances and angles come
+ * from the geometry, which is always float, and the reading goes back out as a float.
+ * SensorModel is the float version.
+ */
+
+struct SensorModelConfig {
+  float gain = 855.0f;              // power is (gain/distance)^2 so this is the distance that reads 1.0
+  float min_distance = 1.0f;        // stops the reading exploding when the emitter touches a wall
+  float reflectance_weight = 0.0f;  // 0 => angle has no effect, 1 => pure cosine (Lambertian) wall
+  float noise_sigma = 0.0f;         // standard deviation of the noise in ADC counts
+  int adc_bits = 10;                // the reading is clamped to 0 .. 2^adc_bits - 1
+  int hold = 1;                     // take a new conversion every 'hold' updates
+  int latency = 0;                  // how many updates the reading lags behind the world
+};
+
+template <typename T = float>
+class BasicSensorModel {
+ public:
+  using Num = Numeric<T>;
+  static constexpr int MAX_LATENCY = 31;
+
+  explicit BasicSensorModel(uint64_t seed = 0x2545F491u) {
+    set_seed(seed);
+    set_config(m_config);
+  }
+
+  void set_config(const SensorModelConfig& config) {
+    m_config = config;
+    m_config.hold = std::max(1, m_config.hold);
+    m_config.latency = std::clamp(m_config.latency, 0, MAX_LATENCY);
+    m_config.adc_bits = std::clamp(m_config.adc_bits, 1, 16);
+    m_gain = Num::from(m_config.gain);
+    m_min_distance = Num::from(m_config.min_distance);
+    m_reflectance_weight = Num::from(m_config.reflectance_weight);
+    m_noise_sigma = Num::from(m_config.noise_sigma);
+    m_adc_max = T((1 << m_config.adc_bits) - 1);
+  }
+
+  [[nodiscard]] const SensorModelConfig& config() const { return m_config; }
+
+  void set_seed(uint64_t seed) { m_rng.set_seed(seed); }
+
+  /// forget any held or delayed readings
+  void reset(float value = 0.0f) {
+    m_history.fill(Num::from(value));
+    m_held = Num::from(value);
+    m_head = 0;
+    m_tick = 0;
+  }
+
+  /***
+   * Each ray's share of the average optical power in a fan, so the shares add up
+   * to the average. The arrays must all hold count elements. This is deliberately a
+   * simple loop over flat arrays with no branches so that it will vectorise.
+   *
+   * The share is p * (p * reflectance / count) rather than p * p * reflectance / count.
+   * In Q16.16 p * p alone tops out at 32767 once a ray is closer than about gain / 181,
+   * and a total of 64 rays would do the same at an average of 512. Dividing first keeps
+   * every share and the total no larger than the average, and anything that still
+   * saturates is past the top of the ADC anyway.
+   */
+  void ray_power(const float* distance, const float* cos_incidence, T* power, int count) const {
+    const T gain = m_gain;
+    const T min_d = m_min_distance;
+    const T w = m_reflectance_weight;
+    const T n = T(std::max(count, 1));
+    for (int i = 0; i < count; i++) {
+      T p = gain / std::max(Num::from(distance[i]), min_d);
+      T reflectance = (T(1) - w) + w * Num::from(cos_incidence[i]);
+      power[i] = p * (p * reflectance / n);
+    }
+  }
+
+  /***
+   * Run the whole pipeline for one update of the sensor.
+   * @param distance - distance to the wall for each ray
+   * @param cos_incidence - cosine of the angle between the ray and the wall normal
+   * @param count - the number of rays
+   * @return the reading in ADC counts as the robot would see it
+   */
+  float update(const float* distance, const float* cos_incidence, int count) {
+    m_ray_power.resize(count);
+    ray_power(distance, cos_incidence, m_ray_power.data(), count);
+    T average = T(0);
+    for (int i = 0; i < count; i++) {
+      average += m_ray_power[i];
+    }
+    return sample(average);
+  }
+
+  /// everything after the optics: noise, ADC, sample and hold and the latency
+  float sample(T power) {
+    if (++m_tick >= m_config.hold) {
+      m_tick = 0;
+      m_held = quantise(power + m_noise_sigma * Num::from(gaussian()));
+    }
+    m_head = (m_head + 1) % HISTORY_SIZE;
+    m_history[m_head] = m_held;
+    int tail = (m_head + HISTORY_SIZE - m_config.latency) % HISTORY_SIZE;
+    return Num::to_float(m_history[tail]);
+  }
+
+  [[nodiscard]] float adc_max() const { return float((1 << m_config.adc_bits) - 1); }
+
+ private:
+  static constexpr int HISTORY_SIZE = MAX_LATENCY + 1;
+
+  T quantise(T value) const { return Num::round(std::clamp(value, T(0), m_adc_max)); }
+
+  /// every sensor has its own generator so the noise does not depend on the update order
+  float gaussian() {
+    if (m_config.noise_sigma <= 0.0f) {
+      return 0.0f;
+    }
+    return m_rng.normal();
+  }
+
+  SensorModelConfig m_config;
+  T m_gain{};
+  T m_min_distance{};
+  T m_reflectance_weight{};
+  T m_noise_sigma{};
+  T m_adc_max{};
+  std::vector<T> m_ray_power;
+  std::array<T, HISTORY_SIZE> m_history{};
+  T m_held{};
+  int m_head = 0;
+  int m_tick = 0;
+  Xoshiro128 m_rng;
+};
+
+using SensorModel = BasicSensorModel<float>;
+
+#endif  // SENSOR_MODEL_H
@@ -2,10 +2,14 @@
 #include <SFML/Graphics.hpp>
 #include <SFML/System/Clock.hpp>
 #include <SFML/Window/Event.hpp>
+#include <cmath>
 #include <iostream>
+#include <random>
+#include "idle_loop.h"
 #include "imgui-SFML.h"
 #include "imgui.h"
 #include "implot.h"
+#include "plot_downsample.h"
 
 ///
 const int NUM_POINTS = 314;
@@ -19,6 +23,27 @@ void generate_data(float fx, float fy) {
   }
 }
 
+/// a fake 1kHz log of a controller trying to follow a square wave, with noise and the odd glitch
+void generate_telemetry(DownsampledSeries& series, int count) {
+  std::mt19937 rng(42);
+  std::normal_distribution<float> noise(0.0f, 0.02f);
+  series.clear();
+  series.reserve(count);
+  float position = 0;
+  float speed = 0;
+  for (int i = 0; i < count; i++) {
+    double t = i * 0.001;
+    float target = std::fmod(t, 4.0) < 2.0 ? 1.0f : -1.0f;
+    speed += (8.0f * (target - position) - 0.6f * speed) * 0.01f;
+    position += speed * 0.001f;
+    float value = position + noise(rng);
+    if (i % 98765 == 0) {
+      value += 0.5f;
+    }
+    series.push_back(t, value);
+  }
+}
+
 float fa = 3.0;
 float fb = 4.0;
 int main() {
@@ -35,13 +60,20 @@ int main() {
   generate_data(fa, fb);
   ImPlot::CreateContext();
 
-  sf::Clock deltaClock{};
+  const int TELEMETRY_SIZES[] = {10000, 1000000, 10000000};
+  int telemetry_size = 1;
+  int method = (int)Downsample::MinMax;
+  DownsampledSeries telemetry;
+  generate_telemetry(telemetry, TELEMETRY_SIZES[telemetry_size]);
+
+  /// nothing here moves on its own, so only draw when there is input. See idle_loop.h
+  IdleLoop loop(window);
 
   /// this is the 'game loop'
   while (window.isOpen()) {
     /// process all the inputs
     sf::Event event{};
-    while (window.pollEvent(event)) {
+    while (loop.poll_event(event)) {
       ImGui::SFML::ProcessEvent(window, event);
       if (event.type == sf::Event::Closed) {
         window.close();
@@ -54,12 +86,18 @@ int main() {
     //
     //    /// update the objects
     //    /// ImGui MUST get updated every cycle
-    sf::Time time = deltaClock.restart();
+    sf::Time time = loop.elapsed();
     ImGui::SFML::Update(window, time);
 
     ImGui::Begin("Hello, ImPLot");
     static bool show_demo = false;
     bool cb_changed = ImGui::Checkbox("Show ImPlot Demo", &show_demo);
+    static bool redraw_when_needed = true;
+    if (ImGui::Checkbox("Only redraw when needed", &redraw_when_needed)) {
+      loop.set_enabled(redraw_when_needed);
+    }
+    ImGui::Text("Frames drawn: %llu skipped: %llu", (unsigned long long)loop.frames_drawn(), (unsigned long long)loop.frames_skipped());
+    ImGui::Text("Idle: %.0f%%", 100.0f * loop.idle_fraction());
     ImGui::End();
 
     ImGui::Begin("A Simple Plot");
@@ -68,10 +106,33 @@ int main() {
       ImPlot::EndPlot();
     }
     ImGui::End();
+
+    ImGui::Begin("Telemetry");
+    bool resized = ImGui::RadioButton("10k points", &telemetry_size, 0);
+    ImGui::SameLine();
+    resized |= ImGui::RadioButton("1M points", &telemetry_size, 1);
+    ImGui::SameLine();
+    resized |= ImGui::RadioButton("10M points", &telemetry_size, 2);
+    if (resized) {
+      generate_telemetry(telemetry, TELEMETRY_SIZES[telemetry_size]);
+    }
+    ImGui::RadioButton("Every point", &method, (int)Downsample::None);
+    ImGui::SameLine();
+    ImGui::RadioButton("Min-max", &method, (int)Downsample::MinMax);
+    ImGui::SameLine();
+    ImGui::RadioButton("LTTB", &method, (int)Downsample::LTTB);
+    ImGui::Text("%d of %d points plotted", (int)telemetry.plotted(), (int)telemetry.size());
+    if (ImPlot::BeginPlot("Position", ImVec2(-1, -1))) {
+      ImPlot::SetupAxes("time (s)", "position");
+      telemetry.plot("position", (Downsample)method);
+      ImPlot::EndPlot();
+    }
+    ImGui::End();
     //
     //    ImGui::ShowDemoWindow();
     if (show_demo) {
       ImPlot::ShowDemoWindow();
+      loop.request_redraw();  // the demo has plots that scroll by themselves
     }
     if (cb_changed) {
       std::cout << "Yeh!" << std::endl;
@@ -1,12 +1,15 @@
 #include <atomic>
 #include <iostream>
 #include <mutex>
+#include <string>
 #include <thread>
 #include <vector>
 #include "SFML/Graphics.hpp"
 #include "SFML/System/Clock.hpp"
 #include "SFML/Window/Event.hpp"
 #include "button.h"
+#include "sprite_batch.h"
+#include "texture_atlas.h"
 
 /**
  * Threads are a way to allocate many tasks in a process to their own execution unit.
@@ -160,14 +163,25 @@ int main() {
   if (!texture.loadFromFile("./assets/images/wooden-chest-45x40.png")) {
     exit(1);
   }
-  sf::Texture props;
+  /// only the chests are wanted from the big sheet of props, so just they go in an atlas and all of them are drawn in one batch
+  sf::Image props;
   if (!props.loadFromFile("./assets/images/props-1x1.png")) {
     exit(1);
   }
-
-  sf::Sprite chest(props);
-  chest.setTextureRect(sf::IntRect(5 * 160, 6 * 160, 160, 160));
-  chest.setScale(0.5, 0.5);
+  TextureAtlas atlas;
+  const int first_chest = 2;
+  const int last_chest = 8;
+  for (int t = first_chest; t <= last_chest; t++) {
+    atlas.add("chest " + std::to_string(t), props, sf::IntRect(t * 160, 6 * 160, 160, 160));
+  }
+  if (!atlas.pack()) {
+    exit(1);
+  }
+  sf::IntRect chest_rects[last_chest + 1];
+  for (int t = first_chest; t <= last_chest; t++) {
+    chest_rects[t] = atlas.rect("chest " + std::to_string(t));
+  }
+  SpriteBatch chests(&atlas.texture());
 
   sf::Font font;
   if (!font.loadFromFile("./assets/fonts/national-park.otf")) {
@@ -198,7 +212,7 @@ int main() {
 
   int type[100];
   for (int i = 0; i < 100; i++) {
-    type[i] = rand() % 7 + 2;
+    type[i] = rand() % (last_chest - first_chest + 1) + first_chest;
   }
   /// now we can do the main loop
   while (window.isOpen()) {
@@ -250,25 +264,21 @@ int main() {
     text.setFillColor(sf::Color(0, 96, 0));
     window.draw(text);
 
-    chest.setColor(sf::Color::White);  // actually the natural colour
     if (worker_boxes >= 60) {
       keep_making_boxes = false;
     }
+    chests.clear();
     for (int i = 0; i < worker_boxes; i++) {
       float x = 50.0f * (1.0f + i % 6);
       float y = 50.0f * (1.0f + i / 6);
-      chest.setPosition(x, y);
-      chest.setTextureRect(sf::IntRect(type[i] * 160, 6 * 160, 160, 160));
-      window.draw(chest);
+      chests.add(chest_rects[type[i]], {x, y}, {0, 0}, 0, {0.5f, 0.5f}, sf::Color::White);  // white is actually the natural colour
     }
-    chest.setColor(sf::Color::Green);
     for (int i = 0; i < shared_counter; i++) {
       float x = 50.0f * (1.0f + i % 6) + 300;
       float y = 50.0f * (1.0f + i / 6);
-      chest.setPosition(x, y);
-      chest.setTextureRect(sf::IntRect(type[i] * 160, 6 * 160, 160, 160));
-      window.draw(chest);
+      chests.add(chest_rects[type[i]], {x, y}, {0, 0}, 0, {0.5f, 0.5f}, sf::Color::Green);
     }
+    window.draw(chests);
     window.display();
     //////////////////////////////////////////////////////////////////////////////////////
   }
@@ -21,6 +21,9 @@
  *  - a task queue that is thread-safe to store tasks waiting to execute
  *  - a means of synchronisation - mutexes and condition variables.
  *
+ * The pool is written out here to show how it works. libs/utils/thread_pool.h is
+ * the same pool made reusable, with a std::future for each task, and that is the
+ * one to use in other programs, as the AssetManager does.
  */
 
 /// A class implements the thread pool
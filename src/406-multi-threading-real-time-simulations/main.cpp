@@ -10,6 +10,10 @@
 #include "SFML/System/Clock.hpp"
 #include "SFML/Window/Event.hpp"
 #include "button.h"
+#include "fast_random.h"
+#include "filter_bank.h"
+#include "render_commands.h"
+#include "thread_pool.h"
 #include "utils.h"
 
 /***
@@ -34,13 +38,25 @@ struct SystemState {
   float controlOutput;  // Simulated control output
 };
 
-// Simulate sensor updates
+/***
+ * Simulate sensor updates. A robot has many sensor channels - encoders, line
+ * sensors, wall sensors, battery and motor currents - and they are all filtered
+ * together by a FilterBank. The filtering is done before the lock is taken, so the
+ * other threads only wait for the one value that is shared to be copied.
+ */
+const int SENSOR_CHANNELS = 16;
+
 void sensorUpdate(SystemState& state, std::atomic<bool>& running) {
+  FilterBank filters = FilterBank::exponential(SENSOR_CHANNELS, 0.9f);
+  std::vector<float> readings(SENSOR_CHANNELS);
   while (running) {
+    for (float& reading : readings) {
+      reading = thread_rng().uniform();  // Random data. rand() is not safe to call from a thread
+    }
+    std::span<const float> filtered = filters.update(readings);
     {
-      float new_value = static_cast<float>(rand()) / RAND_MAX;  // Random data
       std::lock_guard<std::mutex> lock(stateMutex);
-      state.sensorData = exponential_filter(state.sensorData, new_value, 0.9);
+      state.sensorData = filtered[0];  // the one the control logic uses
     }
     std::this_thread::sleep_for(std::chrono::milliseconds(100));  // 10 Hz update rate
   }
@@ -73,8 +89,68 @@ void controlLogic(SystemState& state, std::atomic<bool>& running) {
  * so everything would have to move to the UI thread.
  * Mostly though, it is simpler to just do the UI presentation stuff in the main
  * program thread.
+ *
+ * What can move is the work of deciding what to draw. Here the gauges, a fan that
+ * shows the recent sensor history and the labels are recorded into CommandBuffers
+ * by a thread pool (see render_commands.h). The main thread only draws the finished
+ * vertices, and it draws the previous frame while the next one is being recorded.
  */
 
+const int HISTORY_LENGTH = 720;
+
+/// The state that the recorders work from. They get a copy so the main thread can carry on
+struct Snapshot {
+  float sensor;
+  float control;
+  std::vector<float> history;  // oldest first
+};
+
+void record_gauges(CommandBuffer& buffer, const Snapshot& snapshot) {
+  const float indicator_size = 8.0f;
+  for (float x : {110.0f, 210.0f}) {
+    buffer.rectangle({x, 50, 16, 100}, sf::Color(255, 255, 255, 64));
+  }
+  auto indicator = [&](float x, float y, sf::Color colour) {
+    buffer.triangle(sf::Vertex({x + indicator_size, y}, colour), sf::Vertex({x, y + indicator_size}, colour), sf::Vertex({x, y - indicator_size}, colour));
+  };
+  indicator(100.0f, 150 - 100 * snapshot.sensor, sf::Color::Green);
+  indicator(200.0f, 150 - 100 * snapshot.control / 2.0f, sf::Color::Blue);
+  for (float x : {110.0f, 210.0f}) {
+    buffer.frame({x, 50, 16, 100}, sf::Color::Yellow);
+  }
+}
+
+/// a radar style fan. Each segment is one sample, newest at the top, with its length set by the value
+void record_history_fan(CommandBuffer& buffer, const Snapshot& snapshot) {
+  const sf::Vector2f centre(550, 300);
+  const float radius = 200;
+  const size_t n = snapshot.history.size();
+  const float step = 2 * 3.14159265f / float(n);
+  sf::Transform transform;
+  transform.translate(centre);
+  buffer.set_transform(transform);
+  for (size_t i = 0; i + 1 < n; i++) {
+    float a0 = -3.14159265f / 2 + step * float(i);
+    float a1 = a0 + step;
+    float r0 = radius * std::clamp(snapshot.history[i], 0.0f, 1.0f);
+    float r1 = radius * std::clamp(snapshot.history[i + 1], 0.0f, 1.0f);
+    auto age = sf::Uint8(255 * i / n);
+    sf::Color colour(0, age, 255 - age, 160);
+    buffer.triangle(sf::Vertex({0, 0}, colour), sf::Vertex({r0 * std::cos(a0), r0 * std::sin(a0)}, colour),
+                    sf::Vertex({r1 * std::cos(a1), r1 * std::sin(a1)}, colour));
+  }
+  buffer.set_transform(sf::Transform::Identity);
+}
+
+void record_labels(CommandBuffer& buffer, const Snapshot& snapshot, const GlyphTable& glyphs) {
+  const sf::Color brown(140, 91, 54);
+  char buf[32];
+  buffer.text(glyphs, std::to_string(int(snapshot.sensor * 100.0f)), {108, 150}, brown);
+  snprintf(buf, sizeof(buf), "%3d", int(snapshot.control * 100.0f));
+  buffer.text(glyphs, buf, {203, 150}, brown);
+  buffer.text(glyphs, "Sensor history", {490, 520}, brown);
+}
+
 int main() {
   sf::ContextSettings settings;
   settings.antialiasingLevel = 8;  // the number of multisamplings to use. 4 is probably fine
@@ -96,40 +172,22 @@ int main() {
     exit(1);
   }
 
-  sf::Text text;
-  text.setFont(font);
-  text.setCharacterSize(16);
-  text.setFillColor(sf::Color(140, 91, 54));
-  text.setPosition(50, 5);
+  /// the characters have to be added to the font texture here, on the main thread
+  GlyphTable glyphs;
+  glyphs.prepare(font, 16);
 
   SystemState state{0, 0};
   std::atomic<bool> running(true);
 
-  // Create triangles
-  const float indicator_size = 8.0f;
-  sf::ConvexShape sensorTriangle(3);                                // Triangle for sensor data
-  sensorTriangle.setPoint(0, sf::Vector2f(indicator_size, 0.0f));   // Tip
-  sensorTriangle.setPoint(1, sf::Vector2f(0.0f, indicator_size));   // Bottom-left
-  sensorTriangle.setPoint(2, sf::Vector2f(0.0f, -indicator_size));  // Top-left
-  sensorTriangle.setFillColor(sf::Color::Green);
-
-  sf::ConvexShape controlTriangle(3);                                // Triangle for control output
-  controlTriangle.setPoint(0, sf::Vector2f(indicator_size, 0.0f));   // Tip
-  controlTriangle.setPoint(1, sf::Vector2f(0.0f, indicator_size));   // Bottom-left
-  controlTriangle.setPoint(2, sf::Vector2f(0.0f, -indicator_size));  // Top-left
-  controlTriangle.setFillColor(sf::Color::Blue);
-
-  sf::RectangleShape gauge_bar;
-  gauge_bar.setSize({16, 100});
-  gauge_bar.setOutlineThickness(1.0);
-  gauge_bar.setOutlineColor(sf::Color::Yellow);
-  gauge_bar.setFillColor((sf::Color(255, 255, 255, 64)));
+  /// three layers, recorded in parallel and drawn in this order
+  ThreadPool pool(3);
+  RenderPipeline pipeline(3, pool);
+  std::vector<float> history(HISTORY_LENGTH, 0.0f);
 
   // Start threads
   std::thread sensorThread(sensorUpdate, std::ref(state), std::ref(running));
   std::thread controlThread(controlLogic, std::ref(state), std::ref(running));
 
-  float x = 0;
   /// now we can do the main loop
   while (window.isOpen()) {
     ////  EVENTS    //////////////////////////////////////////////////////////////////////
@@ -162,26 +220,20 @@ int main() {
       sensorValue = state.sensorData;
       controlValue = state.controlOutput;
     }
-    char buf[32];
+    history.erase(history.begin());
+    history.push_back(sensorValue);
+
+    /// the recorders get their own copy of the state and run while the main thread draws
+    auto snapshot = std::make_shared<const Snapshot>(Snapshot{sensorValue, controlValue, history});
+    pipeline.record({
+        [snapshot](CommandBuffer& buffer) { record_gauges(buffer, *snapshot); },
+        [snapshot](CommandBuffer& buffer) { record_history_fan(buffer, *snapshot); },
+        [snapshot, &glyphs](CommandBuffer& buffer) { record_labels(buffer, *snapshot, glyphs); },
+    });
 
-    sensorTriangle.setPosition(100.0f, 150 - 100 * sensorValue);
-    controlTriangle.setPosition(200.0f, 150 - 100 * controlValue / 2.0f);
-    text.setString(std::to_string(controlTriangle.getPosition().x));
     ////  DISPLAY   //////////////////////////////////////////////////////////////////////
     window.clear();
-    gauge_bar.setPosition(110, 50);
-    window.draw(gauge_bar);
-    gauge_bar.setPosition(210, 50);
-    window.draw(gauge_bar);
-    window.draw(sensorTriangle);
-    window.draw(controlTriangle);
-    text.setString(std::to_string(int(sensorValue * 100.0f)));
-    text.setPosition(108, 150);
-    window.draw(text);
-    sprintf(buf, "%3d", int(controlValue * 100.0f));
-    text.setString(buf);
-    text.setPosition(203, 150);
-    window.draw(text);
+    pipeline.submit(window);
     window.display();
     //////////////////////////////////////////////////////////////////////////////////////
   }
@@ -5,6 +5,7 @@
 #include "SFML/Graphics.hpp"
 #include "SFML/System/Clock.hpp"
 #include "SFML/Window/Event.hpp"
+#include "angle.h"
 #include "pvector.h"
 
 /// check out reynold's steering behaviours
@@ -79,7 +80,7 @@ void draw_vehicle(sf::RenderTarget& canvas, Vehicle& vehicle, int flags, sf::Col
   canvas.draw(blob);
   if (sprite) {
     sprite->setPosition(pos.x, pos.y);
-    sprite->setRotation(vel.angle() * 57.29 + 90);
+    sprite->setRotation(trig::degrees(vel.angle()) + 90);
     canvas.draw(*sprite);
   }
   if (flags == DRAW_NONE) {
@@ -5,18 +5,15 @@
 #ifndef IMGUI_SFML_STARTER_VEHICLE_H
 #define IMGUI_SFML_STARTER_VEHICLE_H
 
-#include <random>
+#include "angle.h"
+#include "fast_random.h"
 
 float map(float x, float in_min, float in_max, float out_min, float out_max) {
   return (x - in_min) * (out_max - out_min) / (in_max - in_min) + out_min;
 }
 
-float random(float a, float b) {
-  static std::random_device rd;  //  make this globally available
-  static std::mt19937 gen(rd());
-  std::uniform_real_distribution<float> dis(a, b);
-  return dis(gen);
-}
+/// each thread has its own generator so this is safe to call from anywhere
+float random(float a, float b) { return thread_rng().uniform(a, b); }
 
 struct Vehicle {
   const float v_max_limit = 1200;
@@ -106,13 +103,13 @@ struct Vehicle {
   void moveInCircle(float radius, float centerX, float centerY, float omega, float dt) {
     angle += omega * dt;
     angle = fmodf(angle, 360.0f);
-    float rad = angle * float(M_PI / 180.0f);
+    float rad = trig::radians(angle);
     float target_x = centerX + radius * cosf(rad);
     float target_y = centerY + radius * sinf(rad);
     PVector target(target_x, target_y);
     seek(target);
     m_position = target;
-    omega /= 57.29;
+    omega = trig::radians(omega);
     float vx = -radius * omega * sinf(rad);
     float vy = radius * omega * cosf(rad);
     m_velocity = PVector(vx, vy);
@@ -0,0 +1,193 @@
+#ifndef IMGUI_SFML_STARTER_FLOCKING_H
+#define IMGUI_SFML_STARTER_FLOCKING_H
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include "pvector.h"
+#include "spatial_hash.h"
+#include "vehicle.h"
+#include "vehicle_swarm.h"
+
+/***
+ * Reynolds' flocking rules - separation, alignment and cohesion.
+ *
+ * Each rule looks at the other agents within a radius:
+ *
+ *   separation - steer away from agents that are too close, closer ones count more
+ *   alignment  - steer towards the average heading of the neighbours
+ *   cohesion   - steer towards the average position of the neighbours
+ *
+ * Each one gives a desired velocity. As with the single target behaviours, the
+ * steering force is the difference between that and the current velocity,
+ * limited to the maximum force. The three forces are weighted and added together.
+ *
+ * Looking at every other agent makes this O(N^2) which gets out of hand after a
+ * few hundred agents. The neighbours are found with a SpatialHash instead, so
+ * only agents in nearby cells are looked at and the cost grows linearly
+ * with the number of agents. Set use_spatial_hash to false to see the
+ * difference.
+ *
+ * The positions and velocities are gathered into flat arrays first so that the
+ * same code can drive an array of Vehicle or a VehicleSwarm.
+ */
+
+struct FlockSettings {
+  float neighbour_radius = 50.0f;   // used for alignment and cohesion
+  float separation_radius = 25.0f;  // should be no more than neighbour_radius
+  float separation_weight = 1.5f;
+  float alignment_weight = 1.0f;
+  float cohesion_weight = 1.0f;
+  float max_speed = 400.0f;
+  float max_force = 400.0f;
+  int max_neighbours = 32;  // stop looking after this many. 0 means no limit
+  bool use_spatial_hash = true;
+};
+
+class Flock {
+ public:
+  FlockSettings settings;
+
+  void apply(std::vector<Vehicle>& vehicles) {
+    size_t n = vehicles.size();
+    resize(n);
+    for (size_t i = 0; i < n; i++) {
+      m_x[i] = vehicles[i].m_position.x;
+      m_y[i] = vehicles[i].m_position.y;
+      m_vx[i] = vehicles[i].m_velocity.x;
+      m_vy[i] = vehicles[i].m_velocity.y;
+    }
+    compute(n);
+    for (size_t i = 0; i < n; i++) {
+      vehicles[i].apply_force(PVector(m_fx[i], m_fy[i]));
+    }
+  }
+
+  void apply(VehicleSwarm& swarm) {
+    size_t n = swarm.size();
+    resize(n);
+    std::copy_n(swarm.x.begin(), n, m_x.begin());
+    std::copy_n(swarm.y.begin(), n, m_y.begin());
+    std::copy_n(swarm.vx.begin(), n, m_vx.begin());
+    std::copy_n(swarm.vy.begin(), n, m_vy.begin());
+    compute(n);
+    for (size_t i = 0; i < n; i++) {
+      swarm.ax[i] += m_fx[i];
+      swarm.ay[i] += m_fy[i];
+      swarm.fx[i] = m_fx[i];
+      swarm.fy[i] = m_fy[i];
+    }
+  }
+
+  [[nodiscard]] const SpatialHash& grid() const { return m_grid; }
+
+  /// the average number of neighbours found per agent in the last update
+  [[nodiscard]] float average_neighbours() const { return m_average_neighbours; }
+
+ private:
+  void resize(size_t n) {
+    m_x.resize(n);
+    m_y.resize(n);
+    m_vx.resize(n);
+    m_vy.resize(n);
+    m_fx.resize(n);
+    m_fy.resize(n);
+  }
+
+  /// the usual steering calculation: desired velocity at full speed less the current velocity
+  void steer(float desired_x, float desired_y, size_t i, float& sx, float& sy) const {
+    float m = std::sqrt(desired_x * desired_x + desired_y * desired_y);
+    if (m < 1e-6f) {
+      sx = sy = 0;
+      return;
+    }
+    float k = settings.max_speed / m;
+    sx = desired_x * k - m_vx[i];
+    sy = desired_y * k - m_vy[i];
+    float f2 = sx * sx + sy * sy;
+    if (f2 > settings.max_force * settings.max_force) {
+      float scale = settings.max_force / std::sqrt(f2);
+      sx *= scale;
+      sy *= scale;
+    }
+  }
+
+  void compute(size_t n) {
+    const float radius = settings.neighbour_radius;
+    const float sep_r2 = settings.separation_radius * settings.separation_radius;
+    const size_t max_neighbours = settings.max_neighbours > 0 ? size_t(settings.max_neighbours) : n;
+    if (settings.use_spatial_hash) {
+      m_grid.set_cell_size(radius);
+      m_grid.build(m_x.data(), m_y.data(), n);
+    }
+    size_t total_neighbours = 0;
+    for (size_t i = 0; i < n; i++) {
+      float sep_x = 0, sep_y = 0;
+      float ali_x = 0, ali_y = 0;
+      float coh_x = 0, coh_y = 0;
+      size_t count = 0;
+      size_t sep_count = 0;
+      /// dx,dy is the offset from this agent to the neighbour
+      auto visit = [&](size_t j, float dx, float dy, float d2) {
+        if (j == i) {
+          return true;
+        }
+        ali_x += m_vx[j];
+        ali_y += m_vy[j];
+        coh_x += dx;
+        coh_y += dy;
+        if (d2 < sep_r2 && d2 > 0) {
+          /// a unit vector away from the neighbour, divided by the distance again
+          sep_x -= dx / d2;
+          sep_y -= dy / d2;
+          sep_count++;
+        }
+        return ++count < max_neighbours;
+      };
+      if (settings.use_spatial_hash) {
+        m_grid.for_each_neighbour(m_x[i], m_y[i], radius, visit);
+      } else {
+        const float r2 = radius * radius;
+        for (size_t j = 0; j < n; j++) {
+          float dx = m_x[j] - m_x[i];
+          float dy = m_y[j] - m_y[i];
+          float d2 = dx * dx + dy * dy;
+          if (d2 <= r2 && !visit(j, dx, dy, d2)) {
+            break;
+          }
+        }
+      }
+      total_neighbours += count;
+
+      float fx = 0, fy = 0;
+      float sx, sy;
+      if (sep_count > 0) {
+        steer(sep_x, sep_y, i, sx, sy);
+        fx += settings.separation_weight * sx;
+        fy += settings.separation_weight * sy;
+      }
+      if (count > 0) {
+        steer(ali_x, ali_y, i, sx, sy);  // the direction of the sum is the direction of the average
+        fx += settings.alignment_weight * sx;
+        fy += settings.alignment_weight * sy;
+        steer(coh_x, coh_y, i, sx, sy);  // seek the centre of the neighbours
+        fx += settings.cohesion_weight * sx;
+        fy += settings.cohesion_weight * sy;
+      }
+      m_fx[i] = fx;
+      m_fy[i] = fy;
+    }
+    m_average_neighbours = n > 0 ? float(total_neighbours) / float(n) : 0.0f;
+  }
+
+  SpatialHash m_grid;
+  std::vector<float> m_x;
+  std::vector<float> m_y;
+  std::vector<float> m_vx;
+  std::vector<float> m_vy;
+  std::vector<float> m_fx;
+  std::vector<float> m_fy;
+  float m_average_neighbours = 0;
+};
+
+#endif  // IMGUI_SFML_STARTER_FLOCKING_H
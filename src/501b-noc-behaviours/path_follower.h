@@ -0,0 +1,304 @@
+#ifndef IMGUI_SFML_STARTER_PATH_FOLLOWER_H
+#define IMGUI_SFML_STARTER_PATH_FOLLOWER_H
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include "pvector.h"
+#include "vehicle.h"
+
+/***
+ * Pure pursuit path following. See pure-pursuit.md for the background.
+ *
+ * Each step the follower finds where it is along the path and picks the
+ * lookahead point a distance L further on. The circle that touches the current
+ * heading and passes through that point has curvature
+ *
+ *   kappa = 2 * y / d^2
+ *
+ * where y is how far the point is to the side of the heading and d is the
+ * distance to it. Driving around that circle at speed v needs a sideways
+ * acceleration of v^2 * kappa, which is applied to the Vehicle as a force along
+ * with whatever is needed to hold the speed. The speed is lowered in the bends so
+ * that the sideways acceleration stays within a limit, and L grows with the speed
+ * so that fast followers look further ahead and cut the corners less sharply.
+ *
+ * A Path is a list of points with the distance along the path, the arc length, of
+ * each one worked out in advance. Any point on the path can then be found from its
+ * distance with a binary search.
+ *
+ * Each follower has a PathCursor that remembers which segment it was on last
+ * time. Followers only move a little each step, so finding the nearest point and
+ * the lookahead point means looking at the few segments just ahead of the cursor
+ * rather than every segment in the path. The cost of a step does not depend on the
+ * length of the path. The cursor only moves forward, so a follower does not get
+ * confused where the path passes close to itself. Set use_cursor to false to search
+ * the whole path every step and see the difference.
+ *
+ * One Path can be shared by any number of followers, each with its own cursor.
+ */
+
+class Path {
+ public:
+  Path() = default;
+
+  explicit Path(const std::vector<PVector>& points, bool closed = false) : m_closed(closed) {
+    for (const PVector& p : points) {
+      add_point(p);
+    }
+  }
+
+  /// points that are on top of the one before are left out
+  void add_point(const PVector& p) {
+    if (!m_points.empty() && (p - m_points.back()).mag() < Vehicle::EPSILON) {
+      return;
+    }
+    if (m_points.empty()) {
+      m_s.push_back(0);
+    } else {
+      m_s.push_back(m_s.back() + (p - m_points.back()).mag());
+    }
+    m_points.push_back(p);
+  }
+
+  [[nodiscard]] bool closed() const { return m_closed; }
+  [[nodiscard]] size_t size() const { return m_points.size(); }
+  [[nodiscard]] const PVector& point(size_t i) const { return m_points[i % m_points.size()]; }
+  [[nodiscard]] const std::vector<PVector>& points() const { return m_points; }
+
+  [[nodiscard]] size_t segments() const {
+    if (m_points.size() < 2) {
+      return 0;
+    }
+    return m_closed ? m_points.size() : m_points.size() - 1;
+  }
+
+  /// the distance along the path to the start of a segment
+  [[nodiscard]] float start_of(size_t segment) const { return m_s[segment]; }
+  [[nodiscard]] float end_of(size_t segment) const { return segment + 1 < m_s.size() ? m_s[segment + 1] : length(); }
+
+  [[nodiscard]] float length() const {
+    if (m_points.size() < 2) {
+      return 0;
+    }
+    return m_closed ? m_s.back() + (m_points.front() - m_points.back()).mag() : m_s.back();
+  }
+
+  /// bring a distance into the path: around the loop for a closed path, clamped to the ends for an open one
+  [[nodiscard]] float wrap(float s) const {
+    float len = length();
+    if (len <= 0) {
+      return 0;
+    }
+    if (!m_closed) {
+      return std::clamp(s, 0.0f, len);
+    }
+    s = std::fmod(s, len);
+    return s < 0 ? s + len : s;
+  }
+
+  /// the segment that contains a distance along the path, by binary search
+  [[nodiscard]] size_t segment_at(float s) const {
+    s = wrap(s);
+    size_t i = std::upper_bound(m_s.begin(), m_s.end(), s) - m_s.begin();
+    return std::min(i == 0 ? 0 : i - 1, segments() - 1);
+  }
+
+  [[nodiscard]] PVector point_at(float s) const {
+    s = wrap(s);
+    return point_on(segment_at(s), s);
+  }
+
+  /// a point on a given segment. s must be in that segment
+  [[nodiscard]] PVector point_on(size_t segment, float s) const {
+    const PVector& a = point(segment);
+    const PVector& b = point(segment + 1);
+    float span = end_of(segment) - start_of(segment);
+    float t = span > 0 ? std::clamp((s - start_of(segment)) / span, 0.0f, 1.0f) : 0.0f;
+    return a + (b - a) * t;
+  }
+
+  [[nodiscard]] PVector direction(size_t segment) const {
+    PVector d = point(segment + 1) - point(segment);
+    return d.normalize();
+  }
+
+  /// the distance along the path of the point on a segment nearest to p, and the squared distance to it
+  float project(size_t segment, const PVector& p, float& distance_sq) const {
+    const PVector& a = point(segment);
+    PVector ab = point(segment + 1) - a;
+    float span_sq = ab.dot(ab);
+    float t = span_sq > 0 ? std::clamp((p - a).dot(ab) / span_sq, 0.0f, 1.0f) : 0.0f;
+    PVector offset = a + ab * t - p;
+    distance_sq = offset.dot(offset);
+    return start_of(segment) + t * (end_of(segment) - start_of(segment));
+  }
+
+  /// how far ahead b is from a, going around the loop if the path is closed
+  [[nodiscard]] float distance(float a, float b) const { return m_closed ? wrap(b - a) : b - a; }
+
+  /***
+   * Move segment forward, around the loop if the path is closed, until it
+   * holds the distance s. Cheap when s is just ahead, which it usually is.
+   */
+  void advance(size_t& segment, float s) const {
+    s = wrap(s);
+    const size_t count = segments();
+    for (size_t steps = 0; steps < count; steps++) {
+      if (s >= start_of(segment) && s <= end_of(segment)) {
+        return;
+      }
+      if (!m_closed && segment + 1 == count) {
+        return;
+      }
+      segment = (segment + 1) % count;
+    }
+  }
+
+ private:
+  std::vector<PVector> m_points;
+  std::vector<float> m_s;  // the distance along the path to each point
+  bool m_closed = false;
+};
+
+/// where a follower is on the path. Each follower needs its own
+struct PathCursor {
+  size_t segment = 0;
+  float s = 0;          // distance along the path of the nearest point
+  size_t target_segment = 0;
+  PVector target;       // the lookahead point
+  float curvature = 0;  // of the arc to the lookahead point. Positive turns towards the left normal
+  bool finished = false;
+};
+
+struct PathFollowSettings {
+  float lookahead = 20.0f;               // the lookahead distance when stopped
+  float lookahead_time = 0.1f;           // seconds of travel added to the lookahead distance
+  float speed = 300.0f;                  // cruising speed
+  float max_lateral_acceleration = 3000.0f;
+  float max_force = 4000.0f;
+  float speed_time_constant = 0.25f;     // seconds to make up a difference in speed
+  float search_distance = 0.0f;          // how far ahead of the cursor to look for the nearest point. 0 means the lookahead
+  bool use_cursor = true;                // false searches every segment every step
+};
+
+class PathFollower {
+ public:
+  PathFollowSettings settings;
+
+  explicit PathFollower(const Path& path) : m_path(path) {}
+
+  [[nodiscard]] const Path& path() const { return m_path; }
+
+  /// a cursor at the nearest point on the whole path, for a follower just joining it
+  [[nodiscard]] PathCursor start(const Vehicle& vehicle) const {
+    PathCursor cursor;
+    nearest(vehicle.m_position, cursor, 0, m_path.segments());
+    cursor.target_segment = cursor.segment;
+    return cursor;
+  }
+
+  void apply(Vehicle& vehicle, PathCursor& cursor) const {
+    if (m_path.segments() == 0 || cursor.finished) {
+      return;
+    }
+    const float speed = vehicle.m_velocity.mag();
+    const float lookahead = settings.lookahead + settings.lookahead_time * speed;
+    if (settings.use_cursor) {
+      follow_nearest(vehicle.m_position, cursor, settings.search_distance > 0 ? settings.search_distance : lookahead);
+    } else {
+      nearest(vehicle.m_position, cursor, 0, m_path.segments());
+    }
+
+    float remaining = m_path.length() - cursor.s;
+    if (!m_path.closed() && remaining < 1.0f) {
+      cursor.finished = true;
+      vehicle.m_velocity = PVector();
+      return;
+    }
+    float target_s = m_path.wrap(cursor.s + lookahead);
+    if (settings.use_cursor) {
+      /// the lookahead point moves forward too, so carry on from where it was unless it has dropped back
+      if (m_path.distance(cursor.s, m_path.start_of(cursor.target_segment)) > lookahead) {
+        cursor.target_segment = cursor.segment;
+      }
+      m_path.advance(cursor.target_segment, target_s);
+    } else {
+      cursor.target_segment = m_path.segment_at(target_s);
+    }
+    cursor.target = m_path.point_on(cursor.target_segment, target_s);
+    vehicle.m_target = cursor.target;
+
+    PVector to_target = cursor.target - vehicle.m_position;
+    float distance_sq = to_target.dot(to_target);
+    PVector heading = speed > Vehicle::EPSILON ? vehicle.m_velocity / speed : m_path.direction(cursor.segment);
+    PVector normal(-heading.y, heading.x);
+    float side = to_target.dot(normal);
+    cursor.curvature = distance_sq > Vehicle::EPSILON ? 2.0f * side / distance_sq : 0.0f;
+    if (to_target.dot(heading) < 0) {
+      /// the point is behind, perhaps after being knocked off course. Turn as if for a point level with us
+      cursor.curvature = (side < 0 ? -2.0f : 2.0f) / std::sqrt(distance_sq);
+    }
+
+    /// slow down for bends and, on an open path, for the end
+    float target_speed = settings.speed;
+    if (std::abs(cursor.curvature) > Vehicle::EPSILON) {
+      target_speed = std::min(target_speed, std::sqrt(settings.max_lateral_acceleration / std::abs(cursor.curvature)));
+    }
+    if (!m_path.closed() && remaining < lookahead) {
+      target_speed *= remaining / lookahead;
+    }
+    vehicle.m_desired = heading * target_speed;
+
+    PVector force = normal * (speed * speed * cursor.curvature) + heading * ((target_speed - speed) / settings.speed_time_constant);
+    force.limit(settings.max_force);
+    vehicle.apply_force(force);
+  }
+
+  /// the same path for every follower
+  void apply(std::vector<Vehicle>& vehicles, std::vector<PathCursor>& cursors) const {
+    for (size_t i = 0; i < vehicles.size() && i < cursors.size(); i++) {
+      apply(vehicles[i], cursors[i]);
+    }
+  }
+
+ private:
+  /***
+   * The nearest point on the segments from the cursor to window further on. Stopping
+   * as soon as the segments start to get further away would be cheaper, but it gets
+   * stuck where the path doubles back on itself.
+   */
+  void follow_nearest(const PVector& p, PathCursor& cursor, float window) const {
+    size_t seg = cursor.segment;
+    size_t count = 1;
+    float ahead = m_path.end_of(seg) - cursor.s;
+    while (ahead < window && count < m_path.segments()) {
+      if (!m_path.closed() && seg + 1 == m_path.segments()) {
+        break;
+      }
+      seg = (seg + 1) % m_path.segments();
+      ahead += m_path.end_of(seg) - m_path.start_of(seg);
+      count++;
+    }
+    nearest(p, cursor, cursor.segment, count);
+  }
+
+  /// the nearest point on count segments starting at first
+  void nearest(const PVector& p, PathCursor& cursor, size_t first, size_t count) const {
+    float best_sq = INFINITY;
+    for (size_t i = 0; i < count; i++) {
+      size_t seg = (first + i) % m_path.segments();
+      float distance_sq;
+      float s = m_path.project(seg, p, distance_sq);
+      if (distance_sq < best_sq) {
+        best_sq = distance_sq;
+        cursor.segment = seg;
+        cursor.s = s;
+      }
+    }
+  }
+
+  const Path& m_path;
+};
+
+#endif  // IMGUI_SFML_STARTER_PATH_FOLLOWER_H
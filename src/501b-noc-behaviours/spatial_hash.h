@@ -0,0 +1,137 @@
+#ifndef IMGUI_SFML_STARTER_SPATIAL_HASH_H
+#define IMGUI_SFML_STARTER_SPATIAL_HASH_H
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+/***
+ * A uniform grid for finding everything near a point without testing every
+ * object in the world.
+ *
+ * The world is divided into square cells the same size as the search radius so
+ * that any neighbour must be in the cell containing the point or one of its eight
+ * neighbours. The cells are not stored as a 2D array. Instead the cell coordinates
+ * are hashed into a table a little larger than the number of objects, which means
+ * the world can be any size and there is no bounds checking.
+ *
+ * The grid is rebuilt from scratch every step with a counting sort:
+ *
+ *   1. count how many objects land in each bucket
+ *   2. a running sum of the counts gives the start of each bucket
+ *   3. scatter the objects into one array in bucket order
+ *
+ * That is two passes over the objects and one over the table, with no allocation
+ * once the vectors have grown, so it costs far less than a step of the
+ * behaviours that use it. The positions are copied in bucket order as well so a
+ * query reads memory that is close together.
+ *
+ * Different cells can hash to the same bucket, so a query can see objects that are
+ * not really nearby. The distance test in for_each_neighbour() takes care of that.
+ */
+
+class SpatialHash {
+ public:
+  explicit SpatialHash(float cell_size = 50.0f) { set_cell_size(cell_size); }
+
+  void set_cell_size(float cell_size) {
+    m_cell_size = cell_size;
+    m_inv_cell_size = 1.0f / cell_size;
+  }
+
+  [[nodiscard]] float cell_size() const { return m_cell_size; }
+  [[nodiscard]] size_t bucket_count() const { return m_table_size; }
+  [[nodiscard]] size_t size() const { return m_index.size(); }
+
+  void build(const float* x, const float* y, size_t count) {
+    m_table_size = 64;
+    while (m_table_size < 2 * count) {
+      m_table_size *= 2;
+    }
+    m_bucket_start.assign(m_table_size + 1, 0);
+    m_bucket_of.resize(count);
+    m_index.resize(count);
+    m_x.resize(count);
+    m_y.resize(count);
+
+    for (size_t i = 0; i < count; i++) {
+      uint32_t b = bucket(cell(x[i]), cell(y[i]));
+      m_bucket_of[i] = b;
+      m_bucket_start[b + 1]++;
+    }
+    for (size_t b = 0; b < m_table_size; b++) {
+      m_bucket_start[b + 1] += m_bucket_start[b];
+    }
+    m_cursor.assign(m_bucket_start.begin(), m_bucket_start.end() - 1);
+    for (size_t i = 0; i < count; i++) {
+      uint32_t slot = m_cursor[m_bucket_of[i]]++;
+      m_index[slot] = uint32_t(i);
+      m_x[slot] = x[i];
+      m_y[slot] = y[i];
+    }
+  }
+
+  /***
+   * Call fn(index, dx, dy, distance_squared) for every object within radius of the point,
+   * where (dx,dy) is the offset from the point to the object. The point itself is
+   * included if it is one of the objects. The radius should be no bigger than
+   * the cell size. Return false from fn to stop the search early.
+   */
+  template <class Fn>
+  void for_each_neighbour(float px, float py, float radius, Fn&& fn) const {
+    if (m_index.empty()) {
+      return;
+    }
+    const float r2 = radius * radius;
+    int32_t cx = cell(px);
+    int32_t cy = cell(py);
+    /// two of the nine cells could share a bucket and we must only look in it once
+    std::array<uint32_t, 9> visited{};
+    int visited_count = 0;
+    for (int32_t j = -1; j <= 1; j++) {
+      for (int32_t i = -1; i <= 1; i++) {
+        uint32_t b = bucket(cx + i, cy + j);
+        bool seen = false;
+        for (int k = 0; k < visited_count; k++) {
+          seen = seen || visited[k] == b;
+        }
+        if (seen) {
+          continue;
+        }
+        visited[visited_count++] = b;
+        for (uint32_t s = m_bucket_start[b]; s < m_bucket_start[b + 1]; s++) {
+          float dx = m_x[s] - px;
+          float dy = m_y[s] - py;
+          float d2 = dx * dx + dy * dy;
+          if (d2 <= r2) {
+            if (!fn(m_index[s], dx, dy, d2)) {
+              return;
+            }
+          }
+        }
+      }
+    }
+  }
+
+ private:
+  int32_t cell(float v) const { return int32_t(std::floor(v * m_inv_cell_size)); }
+
+  /// the usual pair of large primes. The table size is a power of two so the mask is cheap
+  uint32_t bucket(int32_t cx, int32_t cy) const {
+    uint32_t h = (uint32_t(cx) * 73856093u) ^ (uint32_t(cy) * 19349663u);
+    return h & uint32_t(m_table_size - 1);
+  }
+
+  float m_cell_size = 50.0f;
+  float m_inv_cell_size = 1.0f / 50.0f;
+  size_t m_table_size = 0;
+  std::vector<uint32_t> m_bucket_start;  // m_table_size + 1 entries
+  std::vector<uint32_t> m_cursor;
+  std::vector<uint32_t> m_bucket_of;
+  std::vector<uint32_t> m_index;  // object indices in bucket order
+  std::vector<float> m_x;         // and their positions, in the same order
+  std::vector<float> m_y;
+};
+
+#endif  // IMGUI_SFML_STARTER_SPATIAL_HASH_H
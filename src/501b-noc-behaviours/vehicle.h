@@ -5,7 +5,7 @@
 #ifndef IMGUI_SFML_STARTER_VEHICLE_H
 #define IMGUI_SFML_STARTER_VEHICLE_H
 
-#include <random>
+#include "fast_random.h"
 
 #ifndef M_PI
 #define M_PI 3.14159265358979323846
@@ -14,12 +14,8 @@ float map(float x, float in_min, float in_max, float out_min, float out_max) {
   return (x - in_min) * (out_max - out_min) / (in_max - in_min) + out_min;
 }
 
-float random(float a, float b) {
-  static std::random_device rd;  //  make this globally available
-  static std::mt19937 gen(rd());
-  std::uniform_real_distribution<float> dis(a, b);
-  return dis(gen);
-}
+/// each thread has its own generator so this is safe to call from anywhere
+float random(float a, float b) { return thread_rng().uniform(a, b); }
 
 struct Vehicle {
   const float v_max_limit = 1200;
@@ -0,0 +1,309 @@
+#ifndef IMGUI_SFML_STARTER_VEHICLE_SWARM_H
+#define IMGUI_SFML_STARTER_VEHICLE_SWARM_H
+
+#include <cmath>
+#include <cstdint>
+#include <span>
+#include <vector>
+#include "fast_random.h"
+#include "simd.h"
+
+/***
+ * A whole crowd of vehicles stored as a structure of arrays.
+ *
+ * The Vehicle struct in vehicle.h is easy to read but each one is a bundle of a dozen
+ * PVectors and every behaviour is a run of calls to mag(), limit() and set_magnitude(),
+ * each with its own sqrt. That is fine for a handful of agents. For many thousands
+ * it is much better to keep all the x positions together, all the y positions
+ * together and so on, then run each behaviour as a single loop over all the agents,
+ * several at a time, using the SIMD registers.
+ *
+ * The behaviours here do the same arithmetic as the ones in Vehicle so that Vehicle
+ * can be used as a reference when checking the results. The only things not kept
+ * are the values that Vehicle stores just for drawing (desired, target and so on).
+ *
+ * Every behaviour can be given a single target for the whole swarm or one target
+ * per agent. As with Vehicle, the behaviours accumulate a force and update()
+ * then integrates everything and clears the forces for the next step.
+ *
+ * The arrays are padded to a whole number of SIMD lanes. The spare lanes are
+ * simulated along with the rest but are never reported.
+ */
+
+struct VehicleSwarm {
+  float v_max_limit = 1200;
+  float panic_distance = 400;
+  float f_max = 400.0f;
+  float wanderR = 75;
+  float wanderD = 20;
+  float change = 1.5;
+
+  std::vector<float> x;
+  std::vector<float> y;
+  std::vector<float> vx;
+  std::vector<float> vy;
+  std::vector<float> ax;  // accumulated acceleration, cleared by update()
+  std::vector<float> ay;
+  std::vector<float> fx;  // the last force applied, for display
+  std::vector<float> fy;
+  std::vector<float> v_max;  // arrive() slows agents down by lowering this
+
+  [[nodiscard]] size_t size() const { return m_count; }
+
+  void reserve(size_t n) {
+    for (auto* array : arrays()) {
+      array->reserve(simd::padded(n));
+    }
+  }
+
+  void clear() {
+    m_count = 0;
+    for (auto* array : arrays()) {
+      array->clear();
+    }
+  }
+
+  /// add one vehicle at rest and return its index
+  size_t add(float px, float py) {
+    size_t i = m_count++;
+    size_t n = simd::padded(m_count);
+    for (auto* array : arrays()) {
+      array->resize(n, 0.0f);
+    }
+    for (size_t j = i; j < n; j++) {
+      v_max[j] = v_max_limit;
+    }
+    x[i] = px;
+    y[i] = py;
+    return i;
+  }
+
+  /// The behaviours. The single target versions apply the same target to every agent.
+  void seek(float tx, float ty) {
+    seek_kernel([=](size_t) { return simd::splat(tx); }, [=](size_t) { return simd::splat(ty); });
+  }
+  void seek(const float* tx, const float* ty) {
+    seek_kernel([=](size_t i) { return simd::load(tx + i); }, [=](size_t i) { return simd::load(ty + i); });
+  }
+
+  void flee(float tx, float ty) {
+    flee_kernel([=](size_t) { return simd::splat(tx); }, [=](size_t) { return simd::splat(ty); });
+  }
+  void flee(const float* tx, const float* ty) {
+    flee_kernel([=](size_t i) { return simd::load(tx + i); }, [=](size_t i) { return simd::load(ty + i); });
+  }
+
+  void arrive(float tx, float ty, float range = 100) {
+    arrive_kernel([=](size_t) { return simd::splat(tx); }, [=](size_t) { return simd::splat(ty); }, range);
+  }
+  void arrive(const float* tx, const float* ty, float range = 100) {
+    arrive_kernel([=](size_t i) { return simd::load(tx + i); }, [=](size_t i) { return simd::load(ty + i); }, range);
+  }
+
+  /***
+   * Wander needs a random angle for every agent. Those are filled in one batch by
+   * the swarm's own generator, then a scalar pass does the trig. The rest of the behaviour
+   * is a rotation of the heading and a seek, all done in the SIMD kernel.
+   */
+  void wander() {
+    size_t n = x.size();
+    m_wander_x.resize(n);
+    m_wander_y.resize(n);
+    m_rng.fill_uniform(std::span<float>(m_wander_x.data(), n), -change, change);
+    for (size_t i = 0; i < n; i++) {
+      float theta = m_wander_x[i];
+      m_wander_x[i] = std::cos(theta);
+      m_wander_y[i] = std::sin(theta);
+    }
+    const simd::f32 zero = simd::splat(0.0f);
+    const simd::f32 one = simd::splat(1.0f);
+    const simd::f32 eps = simd::splat(EPSILON);
+    const simd::f32 wander_d = simd::splat(wanderD);
+    const simd::f32 wander_r = simd::splat(wanderR);
+    for (size_t i = 0; i < n; i += simd::WIDTH) {
+      simd::f32 px = simd::load(&x[i]);
+      simd::f32 py = simd::load(&y[i]);
+      simd::f32 ux = simd::load(&vx[i]);
+      simd::f32 uy = simd::load(&vy[i]);
+      simd::f32 m = simd::sqrt(ux * ux + uy * uy);
+      simd::mask moving = m > eps;
+      simd::f32 inv = simd::select(moving, one / m, zero);
+      ux = ux * inv;
+      uy = uy * inv;
+      /// the circle sits ahead of the vehicle. A stationary vehicle has no heading so use +x
+      simd::f32 cx = px + ux * wander_d;
+      simd::f32 cy = py + uy * wander_d;
+      simd::f32 hx = simd::select(moving, ux, one);
+      simd::f32 hy = simd::select(moving, uy, zero);
+      simd::f32 c = simd::load(&m_wander_x[i]);
+      simd::f32 s = simd::load(&m_wander_y[i]);
+      simd::store(&m_wander_x[i], cx + wander_r * (c * hx - s * hy));
+      simd::store(&m_wander_y[i], cy + wander_r * (s * hx + c * hy));
+    }
+    seek(m_wander_x.data(), m_wander_y.data());
+  }
+
+  /// steer back in from the edges of the region just like Vehicle::check_boundaries
+  void check_boundaries(float x_min, float y_min, float x_max, float y_max) {
+    const simd::f32 zero = simd::splat(0.0f);
+    const simd::f32 margin = simd::splat(120.0f);
+    const simd::f32 tenth = simd::splat(0.1f);
+    const simd::f32 left = simd::splat(x_min);
+    const simd::f32 right = simd::splat(x_max);
+    const simd::f32 top = simd::splat(y_min);
+    const simd::f32 bottom = simd::splat(y_max);
+    for (size_t i = 0; i < x.size(); i += simd::WIDTH) {
+      simd::f32 px = simd::load(&x[i]);
+      simd::f32 py = simd::load(&y[i]);
+      simd::f32 ux = simd::load(&vx[i]);
+      simd::f32 uy = simd::load(&vy[i]);
+      simd::f32 vm = simd::load(&v_max[i]);
+      simd::f32 d = simd::sqrt(ux * ux + uy * uy) * tenth;
+      simd::mask outside = px < left + d || px > right - d || py < top + d || py > bottom - d;
+      if (!simd::any(outside)) {
+        continue;
+      }
+      simd::mask near_left = px < left + margin;
+      simd::mask near_right = px > right - margin;
+      simd::mask near_top = py < top + margin;
+      simd::mask near_bottom = py > bottom - margin;
+      simd::mask near_x = near_left || near_right;
+      simd::mask near_y = near_top || near_bottom;
+      /// the y test takes priority in Vehicle so it overwrites the desired x component as well
+      simd::f32 dx = simd::select(near_left, vm, simd::select(near_right, -vm, zero));
+      simd::f32 dy = simd::select(near_x, uy, zero);
+      dx = simd::select(near_y, ux, dx);
+      dy = simd::select(near_top, vm, simd::select(near_bottom, -vm, dy));
+      simd::f32 dm = simd::sqrt(dx * dx + dy * dy);
+      simd::mask active = outside && (dm > zero);
+      simd::f32 scale = vm / simd::select(active, dm, simd::splat(1.0f));
+      simd::f32 sx = dx * scale - ux;
+      simd::f32 sy = dy * scale - uy;
+      limit(sx, sy, simd::splat(f_max));
+      apply_force(i, active, sx, sy);
+    }
+  }
+
+  /// integrate one time step then clear the forces, as Vehicle::update
+  void update(float delta_t) {
+    const simd::f32 dt = simd::splat(delta_t);
+    const simd::f32 zero = simd::splat(0.0f);
+    const simd::f32 limit_speed = simd::splat(v_max_limit);
+    for (size_t i = 0; i < x.size(); i += simd::WIDTH) {
+      simd::f32 ux = simd::load(&vx[i]) + simd::load(&ax[i]) * dt;
+      simd::f32 uy = simd::load(&vy[i]) + simd::load(&ay[i]) * dt;
+      limit(ux, uy, simd::load(&v_max[i]));
+      simd::store(&vx[i], ux);
+      simd::store(&vy[i], uy);
+      simd::store(&x[i], simd::load(&x[i]) + ux * dt);
+      simd::store(&y[i], simd::load(&y[i]) + uy * dt);
+      simd::store(&ax[i], zero);
+      simd::store(&ay[i], zero);
+      simd::store(&v_max[i], limit_speed);
+    }
+  }
+
+  void seed(uint64_t s) { m_rng.set_seed(s); }
+
+ private:
+  static constexpr float EPSILON = 1e-6;
+
+  std::vector<std::vector<float>*> arrays() { return {&x, &y, &vx, &vy, &ax, &ay, &fx, &fy, &v_max}; }
+
+  /// PVector::limit - scale the vector down if it is longer than lim
+  static void limit(simd::f32& vx_, simd::f32& vy_, simd::f32 lim) {
+    simd::f32 m2 = vx_ * vx_ + vy_ * vy_;
+    simd::mask too_long = m2 > lim * lim;
+    simd::f32 scale = simd::select(too_long, lim / simd::sqrt(m2), simd::splat(1.0f));
+    vx_ *= scale;
+    vy_ *= scale;
+  }
+
+  /// PVector::set_magnitude - vectors too short to normalise are just scaled
+  static void set_magnitude(simd::f32& vx_, simd::f32& vy_, simd::f32 m) {
+    simd::f32 len = simd::sqrt(vx_ * vx_ + vy_ * vy_);
+    simd::f32 scale = simd::select(len > simd::splat(EPSILON), m / len, m);
+    vx_ *= scale;
+    vy_ *= scale;
+  }
+
+  /// only the lanes in the mask get the force
+  void apply_force(size_t i, simd::mask active, simd::f32 sx, simd::f32 sy) {
+    const simd::f32 zero = simd::splat(0.0f);
+    sx = simd::select(active, sx, zero);
+    sy = simd::select(active, sy, zero);
+    simd::store(&ax[i], simd::load(&ax[i]) + sx);
+    simd::store(&ay[i], simd::load(&ay[i]) + sy);
+    simd::store(&fx[i], simd::select(active, sx, simd::load(&fx[i])));
+    simd::store(&fy[i], simd::select(active, sy, simd::load(&fy[i])));
+  }
+
+  template <class TX, class TY>
+  void seek_kernel(TX target_x, TY target_y) {
+    const simd::f32 one = simd::splat(1.0f);
+    const simd::f32 speed = simd::splat(v_max_limit);
+    const simd::f32 force = simd::splat(f_max);
+    for (size_t i = 0; i < x.size(); i += simd::WIDTH) {
+      simd::f32 dx = target_x(i) - simd::load(&x[i]);
+      simd::f32 dy = target_y(i) - simd::load(&y[i]);
+      /// Vehicle::seek gives up when it is within 1 unit of the target
+      simd::mask active = dx * dx + dy * dy >= one;
+      set_magnitude(dx, dy, speed);
+      simd::f32 sx = dx - simd::load(&vx[i]);
+      simd::f32 sy = dy - simd::load(&vy[i]);
+      limit(sx, sy, force);
+      apply_force(i, active, sx, sy);
+    }
+  }
+
+  template <class TX, class TY>
+  void flee_kernel(TX target_x, TY target_y) {
+    const simd::f32 panic = simd::splat(panic_distance);
+    const simd::f32 force = simd::splat(f_max);
+    for (size_t i = 0; i < x.size(); i += simd::WIDTH) {
+      simd::f32 dx = target_x(i) - simd::load(&x[i]);
+      simd::f32 dy = target_y(i) - simd::load(&y[i]);
+      simd::mask active = dx * dx + dy * dy <= panic * panic;
+      set_magnitude(dx, dy, simd::load(&v_max[i]));
+      simd::f32 sx = dx - simd::load(&vx[i]);
+      simd::f32 sy = dy - simd::load(&vy[i]);
+      limit(sx, sy, force);
+      apply_force(i, active, -sx, -sy);
+    }
+  }
+
+  template <class TX, class TY>
+  void arrive_kernel(TX target_x, TY target_y, float range) {
+    const simd::f32 one = simd::splat(1.0f);
+    const simd::f32 creep = simd::splat(0.001f);
+    const simd::f32 r = simd::splat(range);
+    const simd::f32 speed = simd::splat(v_max_limit);
+    const simd::f32 force = simd::splat(f_max);
+    for (size_t i = 0; i < x.size(); i += simd::WIDTH) {
+      simd::f32 dx = target_x(i) - simd::load(&x[i]);
+      simd::f32 dy = target_y(i) - simd::load(&y[i]);
+      simd::f32 d = simd::sqrt(dx * dx + dy * dy);
+      /// close enough - just creep towards the target with no force
+      simd::mask arrived = d < one;
+      simd::f32 creep_scale = creep / simd::max(d, simd::splat(EPSILON));
+      simd::store(&vx[i], simd::select(arrived, dx * creep_scale, simd::load(&vx[i])));
+      simd::store(&vy[i], simd::select(arrived, dy * creep_scale, simd::load(&vy[i])));
+      /// slow down inside the range
+      simd::f32 vm = simd::select(d < r, speed * d / r, simd::load(&v_max[i]));
+      vm = simd::select(arrived, simd::load(&v_max[i]), vm);
+      simd::store(&v_max[i], vm);
+      set_magnitude(dx, dy, vm);
+      simd::f32 sx = dx - simd::load(&vx[i]);
+      simd::f32 sy = dy - simd::load(&vy[i]);
+      limit(sx, sy, force);
+      apply_force(i, !arrived, sx, sy);
+    }
+  }
+
+  size_t m_count = 0;
+  Xoshiro128 m_rng;
+  std::vector<float> m_wander_x;  // scratch space for the wander targets
+  std::vector<float> m_wander_y;
+};
+
+#endif  // IMGUI_SFML_STARTER_VEHICLE_SWARM_H
@@ -0,0 +1,206 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "SFML/Graphics.hpp"
+#include "SFML/System/Clock.hpp"
+#include "SFML/Window/Event.hpp"
+#include "pvector.h"
+#include "utils.h"
+#include "../501b-noc-behaviours/vehicle.h"
+#include "../501b-noc-behaviours/vehicle_swarm.h"
+
+/***
+ * The steering behaviours from 501b applied to a very large number of vehicles.
+ *
+ * Instead of an array of Vehicle objects, the VehicleSwarm keeps every property
+ * in its own array and runs each behaviour as one SIMD loop over the whole crowd.
+ *
+ * The vehicles wander about on their own. Hold the left mouse button to make
+ * them seek the mouse, the right button to make them flee from it and the
+ * middle button to make them arrive at it.
+ *
+ * Before the window opens, a small swarm is run side by side with ordinary
+ * Vehicle objects to check that the two give the same answers.
+ *
+ * Run with --bench to skip the window and just time the physics step for
+ * the swarm against the same number of Vehicle objects.
+ */
+
+const int WINDOW_WIDTH = 1000;
+const int WINDOW_HEIGHT = 1000;
+const float time_step = 0.001;  // the physics runs at 1kHz
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/// put both kinds of vehicle through the same set of behaviours and report the worst difference
+void compare_with_reference(int count, int steps) {
+  std::vector<Vehicle> vehicles;
+  VehicleSwarm swarm;
+  for (int i = 0; i < count; i++) {
+    float x = random(0, WINDOW_WIDTH);
+    float y = random(0, WINDOW_HEIGHT);
+    vehicles.emplace_back(x, y);
+    swarm.add(x, y);
+  }
+  PVector target(WINDOW_WIDTH / 2, WINDOW_HEIGHT / 2);
+  float worst = 0;
+  for (int step = 0; step < steps; step++) {
+    int phase = 3 * step / steps;
+    for (auto& vehicle : vehicles) {
+      vehicle.check_boundaries(0, 0, WINDOW_WIDTH, WINDOW_HEIGHT);
+      if (phase == 0) {
+        vehicle.seek(target);
+      } else if (phase == 1) {
+        vehicle.flee(target);
+      } else {
+        vehicle.arrive(target);
+      }
+      vehicle.update(time_step);
+    }
+    swarm.check_boundaries(0, 0, WINDOW_WIDTH, WINDOW_HEIGHT);
+    if (phase == 0) {
+      swarm.seek(target.x, target.y);
+    } else if (phase == 1) {
+      swarm.flee(target.x, target.y);
+    } else {
+      swarm.arrive(target.x, target.y);
+    }
+    swarm.update(time_step);
+    for (int i = 0; i < count; i++) {
+      float dx = vehicles[i].m_position.x - swarm.x[i];
+      float dy = vehicles[i].m_position.y - swarm.y[i];
+      worst = std::max(worst, std::sqrt(dx * dx + dy * dy));
+    }
+  }
+  std::cout << "Swarm vs Vehicle: " << count << " agents, " << steps << " steps, worst position error " << worst << "\n";
+}
+
+/// time a number of physics steps for a crowd of agents seeking a fixed point
+void benchmark(int count, int steps) {
+  std::vector<Vehicle> vehicles;
+  VehicleSwarm swarm;
+  swarm.reserve(count);
+  for (int i = 0; i < count; i++) {
+    float x = random(0, WINDOW_WIDTH);
+    float y = random(0, WINDOW_HEIGHT);
+    vehicles.emplace_back(x, y);
+    swarm.add(x, y);
+  }
+  PVector target(WINDOW_WIDTH / 2, WINDOW_HEIGHT / 2);
+
+  auto start = std::chrono::steady_clock::now();
+  for (int step = 0; step < steps; step++) {
+    for (auto& vehicle : vehicles) {
+      vehicle.seek(target);
+      vehicle.update(time_step);
+    }
+  }
+  auto middle = std::chrono::steady_clock::now();
+  for (int step = 0; step < steps; step++) {
+    swarm.seek(target.x, target.y);
+    swarm.update(time_step);
+  }
+  auto end = std::chrono::steady_clock::now();
+
+  double vehicle_us = std::chrono::duration<double, std::micro>(middle - start).count() / steps;
+  double swarm_us = std::chrono::duration<double, std::micro>(end - middle).count() / steps;
+  std::cout << count << " agents, seek + update, " << simd::WIDTH << " lanes\n";
+  std::cout << "  Vehicle:      " << vehicle_us << " us/step\n";
+  std::cout << "  VehicleSwarm: " << swarm_us << " us/step (" << vehicle_us / swarm_us << "x)\n";
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+int main(int argc, char** argv) {
+  int agent_count = 20000;
+  for (int i = 1; i < argc; i++) {
+    if (std::strcmp(argv[i], "--bench") == 0) {
+      compare_with_reference(256, 3000);
+      benchmark(100000, 1000);
+      return 0;
+    }
+    agent_count = std::max(1, std::atoi(argv[i]));
+  }
+  compare_with_reference(256, 3000);
+
+  sf::RenderWindow window{sf::VideoMode(WINDOW_WIDTH, WINDOW_HEIGHT), WINDOW_TITLE, sf::Style::Titlebar + sf::Style::Close};
+  window.setFramerateLimit(60);
+
+  sf::Font font;
+  if (!font.loadFromFile("./assets/fonts/consolas.ttf")) {
+    exit(1);
+  }
+  sf::Text text("", font, 18);
+  text.setFillColor(sf::Color::Yellow);
+  text.setPosition(10, 10);
+
+  VehicleSwarm swarm;
+  swarm.reserve(agent_count);
+  for (int i = 0; i < agent_count; i++) {
+    swarm.add(random(0, WINDOW_WIDTH), random(0, WINDOW_HEIGHT));
+  }
+  sf::VertexArray dots(sf::Points, agent_count);
+
+  float time_accumulator = 0;
+  float physics_us = 0;
+  sf::Clock deltaClock{};
+  while (window.isOpen()) {
+    sf::Time time = deltaClock.restart();
+    /// do not let the simulation fall ever further behind if it cannot keep up
+    time_accumulator = std::min(time_accumulator + time.asSeconds(), 0.1f);
+    sf::Event event{};
+    while (window.pollEvent(event)) {
+      if (event.type == sf::Event::Closed) {
+        window.close();
+      }
+    }
+    sf::Vector2i mouse = sf::Mouse::getPosition(window);
+    float mx = (float)mouse.x;
+    float my = (float)mouse.y;
+    bool seek = window.hasFocus() && sf::Mouse::isButtonPressed(sf::Mouse::Left);
+    bool flee = window.hasFocus() && sf::Mouse::isButtonPressed(sf::Mouse::Right);
+    bool arrive = window.hasFocus() && sf::Mouse::isButtonPressed(sf::Mouse::Middle);
+
+    //-------------------------------------------
+    sf::Clock physics_clock;
+    int steps = 0;
+    while (time_accumulator > time_step) {
+      swarm.check_boundaries(0, 0, WINDOW_WIDTH, WINDOW_HEIGHT);
+      if (seek) {
+        swarm.seek(mx, my);
+      } else if (flee) {
+        swarm.flee(mx, my);
+      } else if (arrive) {
+        swarm.arrive(mx, my);
+      } else {
+        swarm.wander();
+      }
+      swarm.update(time_step);
+      time_accumulator -= time_step;
+      steps++;
+    }
+    if (steps > 0) {
+      physics_us = exponential_filter(physics_us, (float)physics_clock.getElapsedTime().asMicroseconds() / (float)steps, 0.9f);
+    }
+
+    //-------------------------------------------
+    for (size_t i = 0; i < swarm.size(); i++) {
+      dots[i].position = {swarm.x[i], swarm.y[i]};
+    }
+    std::string txt = "Agents: " + std::to_string(swarm.size()) + "\n";
+    txt += "Physics: " + std::to_string((int)physics_us) + " us/step\n";
+    txt += "SIMD lanes: " + std::to_string(simd::WIDTH) + "\n";
+    text.setString(txt);
+
+    window.clear();
+    window.draw(dots);
+    window.draw(text);
+    window.display();
+  }
+
+  return 0;
+}
@@ -0,0 +1,180 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "SFML/Graphics.hpp"
+#include "SFML/System/Clock.hpp"
+#include "SFML/Window/Event.hpp"
+#include "pvector.h"
+#include "utils.h"
+#include "../501b-noc-behaviours/flocking.h"
+
+/***
+ * Flocking with Reynolds' separation, alignment and cohesion rules.
+ *
+ * Every agent needs to know about its neighbours. Done naively that means every
+ * agent looks at every other agent and the cost goes up with the square of the
+ * number of agents. Here the neighbours are found with a spatial hash, rebuilt
+ * every step, so the cost goes up in proportion to the number of agents.
+ *
+ *   H     - toggle the spatial hash to see what the naive search costs
+ *   Up    - double the number of agents
+ *   Down  - halve the number of agents
+ *
+ * Run with --bench to skip the window and print a table of agents against
+ * milliseconds per step, with and without the spatial hash. The density of
+ * agents is kept the same as the count goes up so that each agent always
+ * has about the same number of neighbours.
+ */
+
+const int WINDOW_WIDTH = 1000;
+const int WINDOW_HEIGHT = 1000;
+const float time_step = 1.0f / 240.0f;
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void populate(std::vector<Vehicle>& vehicles, int count, float width, float height, float speed) {
+  vehicles.clear();
+  vehicles.reserve(count);
+  for (int i = 0; i < count; i++) {
+    vehicles.emplace_back(random(0, width), random(0, height));
+    vehicles.back().m_velocity = PVector().random() * speed;
+  }
+}
+
+/// flocks have no edges to steer away from so just let them wrap around
+void wrap(Vehicle& vehicle, float width, float height) {
+  PVector& p = vehicle.m_position;
+  p.x = p.x < 0 ? p.x + width : (p.x >= width ? p.x - width : p.x);
+  p.y = p.y < 0 ? p.y + height : (p.y >= height ? p.y - height : p.y);
+}
+
+double time_steps(Flock& flock, std::vector<Vehicle>& vehicles, float width, float height, int steps) {
+  auto start = std::chrono::steady_clock::now();
+  for (int step = 0; step < steps; step++) {
+    flock.apply(vehicles);
+    for (auto& vehicle : vehicles) {
+      vehicle.update(time_step);
+      wrap(vehicle, width, height);
+    }
+  }
+  auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::milli>(end - start).count() / steps;
+}
+
+void benchmark() {
+  const float density = 2000.0f / (WINDOW_WIDTH * WINDOW_HEIGHT);  // the same as the default window
+  const int naive_limit = 16000;
+  Flock flock;
+  std::vector<Vehicle> vehicles;
+  std::printf("%8s %10s %12s %12s\n", "agents", "neighbours", "hash ms", "naive ms");
+  for (int count = 500; count <= 64000; count *= 2) {
+    float side = std::sqrt((float)count / density);
+    populate(vehicles, count, side, side, flock.settings.max_speed);
+    flock.settings.use_spatial_hash = true;
+    double hash_ms = time_steps(flock, vehicles, side, side, 20);
+    float neighbours = flock.average_neighbours();
+    std::printf("%8d %10.1f %12.3f", count, neighbours, hash_ms);
+    if (count <= naive_limit) {
+      flock.settings.use_spatial_hash = false;
+      std::printf(" %12.3f\n", time_steps(flock, vehicles, side, side, 5));
+    } else {
+      std::printf(" %12s\n", "-");
+    }
+  }
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+int main(int argc, char** argv) {
+  int agent_count = 2000;
+  for (int i = 1; i < argc; i++) {
+    if (std::strcmp(argv[i], "--bench") == 0) {
+      benchmark();
+      return 0;
+    }
+    agent_count = std::max(1, std::atoi(argv[i]));
+  }
+
+  sf::RenderWindow window{sf::VideoMode(WINDOW_WIDTH, WINDOW_HEIGHT), WINDOW_TITLE, sf::Style::Titlebar + sf::Style::Close};
+  window.setFramerateLimit(60);
+
+  sf::Font font;
+  if (!font.loadFromFile("./assets/fonts/consolas.ttf")) {
+    exit(1);
+  }
+  sf::Text text("", font, 18);
+  text.setFillColor(sf::Color::Yellow);
+  text.setPosition(10, 10);
+
+  Flock flock;
+  flock.settings.max_speed = 150;
+  std::vector<Vehicle> vehicles;
+  populate(vehicles, agent_count, WINDOW_WIDTH, WINDOW_HEIGHT, flock.settings.max_speed);
+  sf::VertexArray lines(sf::Lines);
+
+  float time_accumulator = 0;
+  float flock_ms = 0;
+  sf::Clock deltaClock{};
+  while (window.isOpen()) {
+    sf::Time time = deltaClock.restart();
+    time_accumulator = std::min(time_accumulator + time.asSeconds(), 0.1f);
+    sf::Event event{};
+    while (window.pollEvent(event)) {
+      if (event.type == sf::Event::Closed) {
+        window.close();
+      } else if (event.type == sf::Event::KeyPressed) {
+        if (event.key.code == sf::Keyboard::H) {
+          flock.settings.use_spatial_hash = !flock.settings.use_spatial_hash;
+        } else if (event.key.code == sf::Keyboard::Up) {
+          populate(vehicles, (int)vehicles.size() * 2, WINDOW_WIDTH, WINDOW_HEIGHT, flock.settings.max_speed);
+        } else if (event.key.code == sf::Keyboard::Down && vehicles.size() > 1) {
+          populate(vehicles, (int)vehicles.size() / 2, WINDOW_WIDTH, WINDOW_HEIGHT, flock.settings.max_speed);
+        }
+      }
+    }
+
+    //-------------------------------------------
+    while (time_accumulator > time_step) {
+      sf::Clock flock_clock;
+      flock.apply(vehicles);
+      flock_ms = exponential_filter(flock_ms, (float)flock_clock.getElapsedTime().asMicroseconds() / 1000.0f, 0.9f);
+      for (auto& vehicle : vehicles) {
+        vehicle.update(time_step);
+        wrap(vehicle, WINDOW_WIDTH, WINDOW_HEIGHT);
+      }
+      time_accumulator -= time_step;
+    }
+
+    //-------------------------------------------
+    /// each agent is a short line pointing along its velocity
+    lines.resize(2 * vehicles.size());
+    for (size_t i = 0; i < vehicles.size(); i++) {
+      PVector p = vehicles[i].m_position;
+      PVector v = vehicles[i].m_velocity;
+      v.set_magnitude(6);
+      lines[2 * i].position = {p.x - v.x, p.y - v.y};
+      lines[2 * i].color = sf::Color(0, 128, 255);
+      lines[2 * i + 1].position = {p.x + v.x, p.y + v.y};
+      lines[2 * i + 1].color = sf::Color::White;
+    }
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "%.2f", flock_ms);
+    std::string txt = "Agents: " + std::to_string(vehicles.size()) + "\n";
+    txt += "Search: " + std::string(flock.settings.use_spatial_hash ? "spatial hash" : "naive") + "\n";
+    txt += "Flocking: " + std::string(buf) + " ms/step\n";
+    txt += "Neighbours: " + std::to_string((int)flock.average_neighbours()) + "\n";
+    text.setString(txt);
+
+    window.clear();
+    window.draw(lines);
+    window.draw(text);
+    window.display();
+  }
+
+  return 0;
+}
@@ -0,0 +1,251 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "SFML/Graphics.hpp"
+#include "SFML/System/Clock.hpp"
+#include "SFML/Window/Event.hpp"
+#include "pvector.h"
+#include "utils.h"
+#include "../501b-noc-behaviours/path_follower.h"
+
+/***
+ * Pure pursuit path following for lots of robots at once.
+ *
+ * The path is a smooth run through a maze: straights joined by rounded
+ * corners, closed into a loop. Every follower shares the one Path and keeps
+ * its own PathCursor so that each step only looks at the few segments just ahead
+ * of where it was. The first follower shows its lookahead point in green.
+ *
+ *   C     - toggle the cursor to see what searching the whole path costs
+ *   Up    - double the number of followers
+ *   Down  - halve the number of followers
+ *   L / K - longer or shorter lookahead
+ *
+ * Run with --bench to skip the window and print a table of path segments against
+ * milliseconds per step, with and without the cursor. The path gets longer down the
+ * table, as if the maze were bigger, so the cursor column should stay about the same.
+ */
+
+const int WINDOW_WIDTH = 1000;
+const int WINDOW_HEIGHT = 1000;
+const float time_step = 1.0f / 240.0f;
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/// round off the corners of a closed polygon, each with steps short segments
+std::vector<PVector> rounded(const std::vector<PVector>& corners, float radius, int steps) {
+  std::vector<PVector> points;
+  size_t n = corners.size();
+  for (size_t i = 0; i < n; i++) {
+    const PVector& a = corners[(i + n - 1) % n];
+    const PVector& p = corners[i];
+    const PVector& b = corners[(i + 1) % n];
+    float r = std::min({radius, (p - a).mag() / 2, (b - p).mag() / 2});
+    PVector in = p - a;
+    PVector out = b - p;
+    PVector start = p - in.normalize() * r;
+    PVector end = p + out.normalize() * r;
+    /// a quadratic Bezier with the corner as its control point
+    for (int s = 0; s <= steps; s++) {
+      float t = (float)s / (float)steps;
+      points.push_back(start * ((1 - t) * (1 - t)) + p * (2 * (1 - t) * t) + end * (t * t));
+    }
+  }
+  return points;
+}
+
+/// back and forth across a maze of 60mm cells, two rows at a time, then back up the side. 8 pairs fill a 16x16 maze
+std::vector<PVector> maze_run(int pairs = 8) {
+  const float cell = 60.0f;
+  const float left = 20.0f + cell / 2;
+  const float right = left + 14 * cell;
+  std::vector<PVector> corners;
+  corners.emplace_back(left, left);
+  for (int row = 0; row < pairs; row++) {
+    float y = left + (float)row * 2 * cell;
+    bool forward = row % 2 == 0;
+    corners.emplace_back(forward ? right : left + cell, y);
+    corners.emplace_back(forward ? right : left + cell, y + cell);
+    corners.emplace_back(forward ? left + cell : right, y + cell);
+    if (row < pairs - 1) {
+      corners.emplace_back(forward ? left + cell : right, y + 2 * cell);
+    }
+  }
+  corners.emplace_back(left, corners.back().y);
+  return corners;
+}
+
+void populate(std::vector<Vehicle>& vehicles, std::vector<PathCursor>& cursors, const PathFollower& follower, int count) {
+  const Path& path = follower.path();
+  vehicles.clear();
+  cursors.clear();
+  vehicles.reserve(count);
+  cursors.reserve(count);
+  for (int i = 0; i < count; i++) {
+    float s = path.length() * (float)i / (float)count;
+    size_t segment = path.segment_at(s);
+    PVector p = path.point_on(segment, s);
+    PVector d = path.direction(segment);
+    PVector side(-d.y, d.x);
+    p += side * random(-20, 20);  // start a little off the path to see them settle onto it
+    vehicles.emplace_back(p.x, p.y);
+    vehicles.back().m_velocity = d * follower.settings.speed * random(0.5f, 1.0f);
+    cursors.push_back(follower.start(vehicles.back()));
+  }
+}
+
+double time_steps(PathFollower& follower, std::vector<Vehicle>& vehicles, std::vector<PathCursor>& cursors, int steps) {
+  auto start = std::chrono::steady_clock::now();
+  for (int step = 0; step < steps; step++) {
+    follower.apply(vehicles, cursors);
+    for (auto& vehicle : vehicles) {
+      vehicle.update(time_step);
+    }
+  }
+  auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::milli>(end - start).count() / steps;
+}
+
+void benchmark() {
+  const int followers = 2000;
+  const size_t scan_limit = 20000;
+  std::vector<Vehicle> vehicles;
+  std::vector<PathCursor> cursors;
+  std::printf("%10s %10s %12s %12s\n", "segments", "followers", "cursor ms", "scan ms");
+  for (int pairs = 2; pairs <= 512; pairs *= 4) {
+    Path path(rounded(maze_run(pairs), 25.0f, 12), true);
+    PathFollower follower(path);
+    populate(vehicles, cursors, follower, followers);
+    follower.settings.use_cursor = true;
+    double cursor_ms = time_steps(follower, vehicles, cursors, 50);
+    std::printf("%10zu %10d %12.3f", path.segments(), followers, cursor_ms);
+    if (path.segments() <= scan_limit) {
+      follower.settings.use_cursor = false;
+      std::printf(" %12.3f\n", time_steps(follower, vehicles, cursors, 5));
+    } else {
+      std::printf(" %12s\n", "-");
+    }
+  }
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+int main(int argc, char** argv) {
+  int follower_count = 1000;
+  for (int i = 1; i < argc; i++) {
+    if (std::strcmp(argv[i], "--bench") == 0) {
+      benchmark();
+      return 0;
+    }
+    follower_count = std::max(1, std::atoi(argv[i]));
+  }
+
+  sf::ContextSettings settings;
+  settings.antialiasingLevel = 8;
+  sf::RenderWindow window{sf::VideoMode(WINDOW_WIDTH, WINDOW_HEIGHT), WINDOW_TITLE, sf::Style::Titlebar + sf::Style::Close, settings};
+  window.setFramerateLimit(60);
+
+  sf::Font font;
+  if (!font.loadFromFile("./assets/fonts/consolas.ttf")) {
+    exit(1);
+  }
+  sf::Text text("", font, 18);
+  text.setFillColor(sf::Color::Yellow);
+  text.setOutlineColor(sf::Color::Black);
+  text.setOutlineThickness(2);
+  text.setPosition(10, 10);
+
+  Path path(rounded(maze_run(), 25.0f, 12), true);
+  PathFollower follower(path);
+  std::vector<Vehicle> vehicles;
+  std::vector<PathCursor> cursors;
+  populate(vehicles, cursors, follower, follower_count);
+
+  sf::VertexArray track(sf::LineStrip);
+  for (const PVector& p : path.points()) {
+    track.append(sf::Vertex({p.x, p.y}, sf::Color(80, 80, 80)));
+  }
+  track.append(track[0]);
+  sf::VertexArray lines(sf::Lines);
+  sf::CircleShape marker(5);
+  marker.setOrigin(5, 5);
+  marker.setFillColor(sf::Color::Green);
+
+  float time_accumulator = 0;
+  float follow_ms = 0;
+  sf::Clock deltaClock{};
+  while (window.isOpen()) {
+    sf::Time time = deltaClock.restart();
+    time_accumulator = std::min(time_accumulator + time.asSeconds(), 0.1f);
+    sf::Event event{};
+    while (window.pollEvent(event)) {
+      if (event.type == sf::Event::Closed) {
+        window.close();
+      } else if (event.type == sf::Event::KeyPressed) {
+        if (event.key.code == sf::Keyboard::C) {
+          follower.settings.use_cursor = !follower.settings.use_cursor;
+        } else if (event.key.code == sf::Keyboard::Up) {
+          populate(vehicles, cursors, follower, (int)vehicles.size() * 2);
+        } else if (event.key.code == sf::Keyboard::Down && vehicles.size() > 1) {
+          populate(vehicles, cursors, follower, (int)vehicles.size() / 2);
+        } else if (event.key.code == sf::Keyboard::L) {
+          follower.settings.lookahead = std::min(follower.settings.lookahead + 5, 200.0f);
+        } else if (event.key.code == sf::Keyboard::K) {
+          follower.settings.lookahead = std::max(follower.settings.lookahead - 5, 5.0f);
+        }
+      }
+    }
+
+    //-------------------------------------------
+    while (time_accumulator > time_step) {
+      sf::Clock follow_clock;
+      follower.apply(vehicles, cursors);
+      follow_ms = exponential_filter(follow_ms, (float)follow_clock.getElapsedTime().asMicroseconds() / 1000.0f, 0.9f);
+      for (auto& vehicle : vehicles) {
+        vehicle.update(time_step);
+      }
+      time_accumulator -= time_step;
+    }
+
+    //-------------------------------------------
+    /// each follower is a short line pointing along its velocity
+    lines.resize(2 * vehicles.size() + 2);
+    for (size_t i = 0; i < vehicles.size(); i++) {
+      PVector p = vehicles[i].m_position;
+      PVector v = vehicles[i].m_velocity;
+      v.set_magnitude(6);
+      lines[2 * i].position = {p.x - v.x, p.y - v.y};
+      lines[2 * i].color = sf::Color(0, 128, 255);
+      lines[2 * i + 1].position = {p.x + v.x, p.y + v.y};
+      lines[2 * i + 1].color = sf::Color::White;
+    }
+    const Vehicle& first = vehicles.front();
+    const PathCursor& cursor = cursors.front();
+    lines[2 * vehicles.size()] = sf::Vertex({first.m_position.x, first.m_position.y}, sf::Color::Green);
+    lines[2 * vehicles.size() + 1] = sf::Vertex({cursor.target.x, cursor.target.y}, sf::Color::Green);
+    marker.setPosition(cursor.target.x, cursor.target.y);
+
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "%.3f", follow_ms);
+    std::string txt = "Followers: " + std::to_string(vehicles.size()) + "  Segments: " + std::to_string(path.segments()) + "\n";
+    txt += "Search: " + std::string(follower.settings.use_cursor ? "cursor" : "whole path") + "\n";
+    txt += "Following: " + std::string(buf) + " ms/step\n";
+    txt += "Lookahead: " + std::to_string((int)follower.settings.lookahead) + " + " + std::to_string(follower.settings.lookahead_time).substr(0, 4) +
+           " s of travel\n";
+    text.setString(txt);
+
+    window.clear();
+    window.draw(track);
+    window.draw(lines);
+    window.draw(marker);
+    window.draw(text);
+    window.display();
+  }
+
+  return 0;
+}
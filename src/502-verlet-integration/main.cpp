@@ -0,0 +1,236 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#include "SFML/Graphics.hpp"
+#include "SFML/System/Clock.hpp"
+#include "SFML/Window/Event.hpp"
+#include "imgui-SFML.h"
+#include "imgui.h"
+#include "implot.h"
+#include "integrators.h"
+
+/***
+ * A C++ version of verlet.py, extended to all of the integrators in integrators.h.
+ *
+ * A mass on a spring is about the simplest thing that shows up an integrator.
+ * The exact answer is known, x = cos(wt), and the total energy should stay the
+ * same for ever. Explicit Euler adds a little energy every step so the swing
+ * keeps growing. The semi-implicit Euler and Verlet methods keep the energy
+ * bounded, and RK4 is very accurate for a much higher cost per step.
+ *
+ * The window plots the position and the energy for each method. Use the slider
+ * to change the time step and watch Euler fall apart.
+ *
+ * Run with --bench to skip the window and print:
+ *
+ *   - the energy drift and position error of each method for a range of time steps
+ *   - the largest time step for each method that keeps the error under 1%, and how many
+ *     acceleration calls that costs per simulated second
+ *   - the time per step for a batch of 100,000 oscillators
+ */
+
+const float spring_k = 10.0f;  // the same values as verlet.py
+const float mass = 1.0f;
+const float total_time = 20.0f;
+const Integrator all_methods[] = {Integrator::Euler, Integrator::SemiImplicitEuler, Integrator::VelocityVerlet, Integrator::RK4};
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/// the spring pulls every particle back towards the origin
+struct Spring {
+  const float* k;  // one stiffness per particle
+  void operator()(const ParticleView& s, float* ax, float* ay) const {
+    for (size_t i = 0; i < s.count; i++) {
+      ax[i] = -k[i] * s.x[i] / mass;
+      ay[i] = -k[i] * s.y[i] / mass;
+    }
+  }
+};
+
+float energy(float x, float v) { return 0.5f * mass * v * v + 0.5f * spring_k * x * x; }
+
+struct RunResult {
+  float energy_drift = 0;    // |E - E0| / E0 at the end of the run
+  float position_error = 0;  // the worst |x - cos(wt)| during the run
+  std::vector<float> t;
+  std::vector<float> x;
+  std::vector<float> e;
+};
+
+/// one oscillator released from x = 1. Pass record = true to keep the history for plotting
+RunResult simulate(Integrator method, float dt, bool record = false) {
+  const float omega = std::sqrt(spring_k / mass);
+  const float k[1] = {spring_k};
+  const Spring spring{k};
+  ParticleState state;
+  state.add(1.0f, 0.0f);
+  ParticleIntegrator integrator(method);
+  const float e0 = energy(1.0f, 0.0f);
+  const int steps = int(total_time / dt);
+  RunResult result;
+  /// the plots do not need more than a few thousand points
+  const int record_every = std::max(1, steps / 4000);
+  for (int step = 0; step <= steps; step++) {
+    const float t = float(step) * dt;
+    const float x = state.x[0];
+    const float e = energy(x, state.vx[0]);
+    if (!std::isfinite(x)) {
+      result.position_error = INFINITY;
+      result.energy_drift = INFINITY;
+      break;
+    }
+    result.position_error = std::max(result.position_error, std::abs(x - std::cos(omega * t)));
+    result.energy_drift = std::abs(e - e0) / e0;
+    if (record && step % record_every == 0) {
+      result.t.push_back(t);
+      result.x.push_back(x);
+      result.e.push_back(e);
+    }
+    integrator.step(state, dt, spring);
+  }
+  return result;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void print_accuracy_table() {
+  const float time_steps[] = {0.001f, 0.002f, 0.005f, 0.01f, 0.02f, 0.05f, 0.1f, 0.2f};
+  std::printf("Harmonic oscillator k=%.0f m=%.0f for %.0f s\n", spring_k, mass, total_time);
+  std::printf("%-20s %8s %14s %14s\n", "method", "dt", "energy drift", "max |x error|");
+  for (Integrator method : all_methods) {
+    for (float dt : time_steps) {
+      RunResult r = simulate(method, dt);
+      std::printf("%-20s %8.3f %14.3e %14.3e\n", integrator_name(method), dt, r.energy_drift, r.position_error);
+    }
+  }
+  std::printf("\n");
+}
+
+/// search downwards from a large step for the first one that is accurate enough
+void print_largest_steps(float tolerance) {
+  std::printf("Largest dt with position error below %.0f%% over %.0f s\n", tolerance * 100, total_time);
+  std::printf("%-20s %10s %16s\n", "method", "dt", "accel calls/s");
+  for (Integrator method : all_methods) {
+    float dt = 0.5f;
+    while (dt > 1e-6f && !(simulate(method, dt).position_error < tolerance)) {
+      dt *= 0.9f;
+    }
+    std::printf("%-20s %10.5f %16.0f\n", integrator_name(method), dt, integrator_evaluations(method) / dt);
+  }
+  std::printf("\n");
+}
+
+void print_batch_timing(int count, int steps) {
+  std::printf("Batch of %d oscillators, %d steps\n", count, steps);
+  std::printf("%-20s %14s %14s\n", "method", "ms/step", "ns/particle");
+  std::vector<float> k(count);
+  for (int i = 0; i < count; i++) {
+    k[i] = spring_k * (0.5f + float(i % 100) / 100.0f);
+  }
+  const Spring spring{k.data()};
+  for (Integrator method : all_methods) {
+    ParticleState state;
+    for (int i = 0; i < count; i++) {
+      state.add(1.0f, float(i % 7) / 7.0f);
+    }
+    ParticleIntegrator integrator(method);
+    auto start = std::chrono::steady_clock::now();
+    for (int step = 0; step < steps; step++) {
+      integrator.step(state, 0.01f, spring);
+    }
+    auto end = std::chrono::steady_clock::now();
+    double ms = std::chrono::duration<double, std::milli>(end - start).count() / steps;
+    std::printf("%-20s %14.3f %14.2f\n", integrator_name(method), ms, 1e6 * ms / count);
+  }
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+int main(int argc, char** argv) {
+  if (argc > 1 && std::strcmp(argv[1], "--bench") == 0) {
+    print_accuracy_table();
+    print_largest_steps(0.01f);
+    print_batch_timing(100000, 200);
+    return 0;
+  }
+
+  sf::RenderWindow window{sf::VideoMode(1200, 800), WINDOW_TITLE, sf::Style::Default};
+  window.setVerticalSyncEnabled(true);
+  if (!ImGui::SFML::Init(window)) {
+    return -1;
+  }
+  ImPlot::CreateContext();
+
+  float dt = 0.01f;
+  bool show[4] = {true, true, true, true};
+  std::vector<RunResult> results;
+  bool recalculate = true;
+
+  sf::Clock deltaClock{};
+  while (window.isOpen()) {
+    sf::Event event{};
+    while (window.pollEvent(event)) {
+      ImGui::SFML::ProcessEvent(window, event);
+      if (event.type == sf::Event::Closed) {
+        window.close();
+      }
+      if (event.type == sf::Event::Resized) {
+        sf::FloatRect visibleArea(0, 0, (float)event.size.width, (float)event.size.height);
+        window.setView(sf::View(visibleArea));
+      }
+    }
+    ImGui::SFML::Update(window, deltaClock.restart());
+
+    /// the runs only change when the time step does
+    if (recalculate) {
+      results.clear();
+      for (Integrator method : all_methods) {
+        results.push_back(simulate(method, dt, true));
+      }
+      recalculate = false;
+    }
+
+    ImGui::SetNextWindowPos(ImVec2(0, 0), ImGuiCond_Always);
+    ImGui::SetNextWindowSize(ImVec2((float)window.getSize().x, (float)window.getSize().y), ImGuiCond_Always);
+    ImGui::Begin("Integrators");
+    recalculate = ImGui::SliderFloat("Time step", &dt, 0.001f, 0.2f, "%.3f s");
+    for (int m = 0; m < 4; m++) {
+      ImGui::Checkbox(integrator_name(all_methods[m]), &show[m]);
+      ImGui::SameLine();
+      ImGui::Text("drift %.2e  error %.2e", results[m].energy_drift, results[m].position_error);
+    }
+    const ImVec2 plot_size(-1, ImGui::GetContentRegionAvail().y / 2 - 4);
+    if (ImPlot::BeginPlot("Position", plot_size)) {
+      ImPlot::SetupAxes("time (s)", "x (m)");
+      ImPlot::SetupAxisLimits(ImAxis_Y1, -3, 3);
+      for (int m = 0; m < 4; m++) {
+        if (show[m]) {
+          ImPlot::PlotLine(integrator_name(all_methods[m]), results[m].t.data(), results[m].x.data(), (int)results[m].t.size());
+        }
+      }
+      ImPlot::EndPlot();
+    }
+    if (ImPlot::BeginPlot("Energy", plot_size)) {
+      ImPlot::SetupAxes("time (s)", "E (J)");
+      ImPlot::SetupAxisLimits(ImAxis_Y1, 0, 3 * energy(1.0f, 0.0f));
+      for (int m = 0; m < 4; m++) {
+        if (show[m]) {
+          ImPlot::PlotLine(integrator_name(all_methods[m]), results[m].t.data(), results[m].e.data(), (int)results[m].t.size());
+        }
+      }
+      ImPlot::EndPlot();
+    }
+    ImGui::End();
+
+    window.clear();
+    ImGui::SFML::Render(window);
+    window.display();
+  }
+  ImPlot::DestroyContext();
+  ImGui::SFML::Shutdown();
+
+  return 0;
+}
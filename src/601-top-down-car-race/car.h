@@ -0,0 +1,104 @@
+#ifndef IMGUI_SFML_STARTER_CAR_H
+#define IMGUI_SFML_STARTER_CAR_H
+
+#include <algorithm>
+#include <cmath>
+#include "pvector.h"
+#include "track.h"
+
+/// check out reynold's steering behaviours
+
+const int waypoint_count = 9;  // checkpoints
+int waypoints[waypoint_count][2] = {{186, 292}, {600, 226}, {690, 1220}, {920, 1270}, {950, 900}, {1200, 810}, {1250, 1500}, {1100, 1640}, {220, 1620}};
+struct Vehicle {
+  float x;
+  float y;
+  float theta = 0;
+  float speed;
+  float top_speed;
+  //  float angle;
+  int n;
+  int line_index = 0;  // where this car was last seen on the racing line
+  float steer_gain = 0.010f;  // radians of turn per frame for each pixel per frame of speed
+  int lookahead = 6;          // how many racing line points ahead to aim for
+  float v_max = 360.0f;
+  PVector m_position;
+  PVector m_velocity;
+  PVector m_acceleration;
+
+  Vehicle() {
+    speed = 1;
+    theta = 0;
+    n = 0;
+    m_velocity = PVector(1, 0);
+  }
+
+  void apply_force(PVector f) { m_acceleration += f; }
+
+  void update(float delta_t) {
+    m_velocity += m_acceleration * delta_t;
+    m_velocity.limit(v_max);
+    m_position += m_velocity * delta_t;
+    m_acceleration = PVector(0, 0);
+  }
+
+  void move() {
+    x += sin(theta) * speed;
+    y -= cos(theta) * speed;
+  }
+
+  void findTarget() {
+    float tx = waypoints[n][0];
+    float ty = waypoints[n][1];
+    float beta = theta - atan2(tx - x, -ty + y);
+    if (sin(beta) < 0) {
+      theta += steer_gain * speed;
+    } else {
+      theta -= steer_gain * speed;
+    }
+    float distance_squared_to_target = (x - tx) * (x - tx) + (y - ty) * (y - ty);
+    float min_distance_squared = 5 * 5;
+    if (distance_squared_to_target < min_distance_squared) {
+      n = (n + 1) % waypoint_count;
+    }
+    if (distance_squared_to_target < 100) {
+      speed = top_speed / 10;
+    } else {
+      speed = top_speed;
+    }
+    if (speed < 2.0) {
+      speed = 2.0;
+    }
+  }
+
+  /***
+   * Steer at a point a little way along the racing line. The car's place on the
+   * line and its target speed are both looked up, so there is no searching.
+   * A cross product with the heading says which way to turn. Off the track
+   * the grass halves the speed.
+   */
+  void followLine(const Track& track) {
+    uint16_t index = track.line_index(x, y);
+    if (index != Track::NO_LINE) {
+      line_index = index;
+    }
+    const LinePoint& target = track.line_point(line_index + lookahead);
+    float dx = target.x - x;
+    float dy = target.y - y;
+    float cross = sin(theta) * dy + cos(theta) * dx;
+    if (cross > 0) {
+      theta += steer_gain * speed;
+    } else {
+      theta -= steer_gain * speed;
+    }
+    speed = std::min(top_speed, track.line_point(line_index).speed);
+    if (!track.on_track(x, y)) {
+      speed /= 2;
+    }
+    if (speed < 2.0) {
+      speed = 2.0;
+    }
+  }
+};
+
+#endif  // IMGUI_SFML_STARTER_CAR_H
@@ -0,0 +1,152 @@
+#ifndef IMGUI_SFML_STARTER_CAR_COLLISIONS_H
+#define IMGUI_SFML_STARTER_CAR_COLLISIONS_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+/***
+ * Keeps the cars from driving through one another. Each car is a circle and
+ * any pair that overlap is pushed apart.
+ *
+ * Testing every car against every other car costs N^2 tests. Instead the cars
+ * are kept in a list sorted by x (sort and sweep, also called sweep and prune). Walking along
+ * that list, a car only needs testing against the cars after it until one is
+ * more than two radii further along in x. Anything after that is too far away.
+ *
+ * A long line of cars on a straight that runs up the screen all have much the
+ * same x and then the sweep has nothing to prune. So the list is sorted along whichever
+ * axis the cars are most spread out in, which is checked every step.
+ *
+ * The cars barely move between frames so the list from last time is nearly in order
+ * already. An insertion sort puts it right in close to linear time. It only needs
+ * a full sort when the sweep axis changes.
+ *
+ * Each overlapping pair is separated once per step by moving both cars
+ * half the overlap along the line between their centres. The work per pair is
+ * fixed. A car caught between several others may still overlap a little after
+ * one pass, but that is taken care of over the next few steps.
+ *
+ * The cars can be any type with float x and y members.
+ */
+
+class CarCollisions {
+ public:
+  /// the number of pairs that were close enough in x to need the full test in the last step
+  [[nodiscard]] size_t candidate_pairs() const { return m_candidates; }
+  [[nodiscard]] size_t overlapping_pairs() const { return m_overlaps; }
+
+  /// 0 if the last sweep was along x, 1 for y
+  [[nodiscard]] int sweep_axis() const { return m_axis; }
+
+  template <class Car>
+  void resolve(std::span<Car> cars, float radius) {
+    const float reach = 2 * radius;
+    const int axis = widest_axis(cars);
+    auto key = [axis](const Car& car) { return axis == 0 ? car.x : car.y; };
+    sort_by(cars, key, axis != m_axis);
+    m_axis = axis;
+    m_candidates = 0;
+    m_overlaps = 0;
+    const size_t n = m_order.size();
+    for (size_t a = 0; a < n; a++) {
+      Car& car_a = cars[m_order[a]];
+      for (size_t b = a + 1; b < n; b++) {
+        Car& car_b = cars[m_order[b]];
+        if (key(car_b) - key(car_a) > reach) {
+          break;
+        }
+        m_candidates++;
+        separate(car_a, car_b, reach);
+      }
+    }
+  }
+
+  /// the simple version, kept for the benchmark
+  template <class Car>
+  void resolve_all_pairs(std::span<Car> cars, float radius) {
+    const float reach = 2 * radius;
+    m_candidates = 0;
+    m_overlaps = 0;
+    for (size_t i = 0; i < cars.size(); i++) {
+      for (size_t j = i + 1; j < cars.size(); j++) {
+        m_candidates++;
+        separate(cars[i], cars[j], reach);
+      }
+    }
+  }
+
+ private:
+  /// the axis with the larger variance in the car positions
+  template <class Car>
+  static int widest_axis(std::span<Car> cars) {
+    if (cars.empty()) {
+      return 0;
+    }
+    double sx = 0, sy = 0, sxx = 0, syy = 0;
+    for (const Car& car : cars) {
+      sx += car.x;
+      sy += car.y;
+      sxx += double(car.x) * car.x;
+      syy += double(car.y) * car.y;
+    }
+    const double n = double(cars.size());
+    return (sxx - sx * sx / n) >= (syy - sy * sy / n) ? 0 : 1;
+  }
+
+  template <class Car, class Key>
+  void sort_by(std::span<Car> cars, Key key, bool full_sort) {
+    const size_t n = cars.size();
+    if (full_sort || m_order.size() != n) {
+      m_order.resize(n);
+      for (size_t i = 0; i < n; i++) {
+        m_order[i] = uint32_t(i);
+      }
+      std::sort(m_order.begin(), m_order.end(), [&](uint32_t p, uint32_t q) { return key(cars[p]) < key(cars[q]); });
+      return;
+    }
+    for (size_t i = 1; i < n; i++) {
+      uint32_t id = m_order[i];
+      float x = key(cars[id]);
+      size_t j = i;
+      while (j > 0 && key(cars[m_order[j - 1]]) > x) {
+        m_order[j] = m_order[j - 1];
+        j--;
+      }
+      m_order[j] = id;
+    }
+  }
+
+  template <class Car>
+  void separate(Car& p, Car& q, float reach) {
+    float dx = q.x - p.x;
+    float dy = q.y - p.y;
+    float d2 = dx * dx + dy * dy;
+    if (d2 >= reach * reach) {
+      return;
+    }
+    m_overlaps++;
+    float d = std::sqrt(d2);
+    if (d < 1e-4f) {
+      /// sitting on top of each other so there is no direction. Any will do
+      dx = 1;
+      dy = 0;
+      d = 1;
+      d2 = 0;
+    }
+    float push = 0.5f * (reach - std::sqrt(d2)) / d;
+    p.x -= dx * push;
+    p.y -= dy * push;
+    q.x += dx * push;
+    q.y += dy * push;
+  }
+
+  std::vector<uint32_t> m_order;  // car indices sorted along the sweep axis
+  int m_axis = 0;
+  size_t m_candidates = 0;
+  size_t m_overlaps = 0;
+};
+
+#endif  // IMGUI_SFML_STARTER_CAR_COLLISIONS_H
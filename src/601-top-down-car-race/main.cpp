@@ -1,79 +1,144 @@
 #include <iostream>
 
 #include <algorithm>
+#include <chrono>
 #include <cmath>
-#include "../501a-noc-vectors/pvector.h"
+#include <cstdio>
+#include <cstring>
+#include <span>
+#include <vector>
 #include "SFML/Graphics.hpp"
 #include "SFML/System/Clock.hpp"
 #include "SFML/Window/Event.hpp"
+#include "car.h"
+#include "car_collisions.h"
+#include "sprite_batch.h"
+#include "texture_atlas.h"
+#include "tournament.h"
+#include "track.h"
 
 /***
  * A top-down care racer from this video::
  *   https://www.youtube.com/watch?v=YzhhVHb0WVY
+ *
+ * Give a number on the command line to race that many cars. Run with --bench to
+ * skip the window and time a step of the race for more and more cars, with
+ * the collisions found by sort and sweep and by testing every pair.
+ *
+ * The cars follow a racing line worked out from the course image (see track.h).
+ * Press L to switch them back to steering at the waypoints.
+ *
+ * Run with --tournament to race a couple of thousand differently tuned cars
+ * without a window, using every core, and write their lap times to tournament.csv.
+ * Add a number after it to choose how many threads to use.
  */
 
-/// check out reynold's steering behaviours
-
-const int waypoint_count = 9;  // checkpoints
-int waypoints[waypoint_count][2] = {{186, 292}, {600, 226}, {690, 1220}, {920, 1270}, {950, 900}, {1200, 810}, {1250, 1500}, {1100, 1640}, {220, 1620}};
-struct Vehicle {
-  float x;
-  float y;
-  float theta = 0;
-  float speed;
-  float top_speed;
-  //  float angle;
-  int n;
-  float v_max = 360.0f;
-  PVector m_position;
-  PVector m_velocity;
-  PVector m_acceleration;
-
-  Vehicle() {
-    speed = 1;
-    theta = 0;
-    n = 0;
-    m_velocity = PVector(1, 0);
-  }
-
-  void apply_force(PVector f) { m_acceleration += f; }
-
-  void update(float delta_t) {
-    m_velocity += m_acceleration * delta_t;
-    m_velocity.limit(v_max);
-    m_position += m_velocity * delta_t;
-    m_acceleration = PVector(0, 0);
-  }
-
-  void move() {
-    x += sin(theta) * speed;
-    y -= cos(theta) * speed;
-  }
-
-  void findTarget() {
-    float tx = waypoints[n][0];
-    float ty = waypoints[n][1];
-    float beta = theta - atan2(tx - x, -ty + y);
-    if (sin(beta) < 0) {
-      theta += 0.010 * speed;
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+const float car_radius = 22;
+
+/// line the cars up on the grid, three abreast, slowest at the front
+void place_cars(std::vector<Vehicle>& cars, int count) {
+  cars.assign(count, Vehicle());
+  for (int i = 0; i < count; i++) {
+    cars[i].x = 150 + (float)(i % 3 - 1) * 2.2f * car_radius;
+    cars[i].y = 1200 + (float)(i / 3) * 2.2f * car_radius;
+    cars[i].top_speed = 4 + (5 * i) / count;  // 4 on the front row rising to 8 at the back
+  }
+}
+
+/// the cars follow the racing line if there is a track, otherwise the waypoints
+void step_race(std::vector<Vehicle>& cars, CarCollisions& collisions, bool sweep, const Track* track = nullptr) {
+  for (auto& car : cars) {
+    car.move();
+    if (track) {
+      car.followLine(*track);
     } else {
-      theta -= 0.010 * speed;
+      car.findTarget();
     }
-    float distance_squared_to_target = (x - tx) * (x - tx) + (y - ty) * (y - ty);
-    float min_distance_squared = 5 * 5;
-    if (distance_squared_to_target < min_distance_squared) {
-      n = (n + 1) % waypoint_count;
-    }
-    if (distance_squared_to_target < 100) {
-      speed = top_speed / 10;
+  }
+  if (sweep) {
+    collisions.resolve(std::span<Vehicle>(cars), car_radius);
+  } else {
+    collisions.resolve_all_pairs(std::span<Vehicle>(cars), car_radius);
+  }
+}
+
+/// time a step of the race, after the grid has had a chance to spread out
+double time_race(int count, bool sweep) {
+  std::vector<Vehicle> cars;
+  place_cars(cars, count);
+  CarCollisions collisions;
+  for (int i = 0; i < 200; i++) {
+    step_race(cars, collisions, sweep);
+  }
+  const int steps = 200;
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < steps; i++) {
+    step_race(cars, collisions, sweep);
+  }
+  auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::milli>(end - start).count() / steps;
+}
+
+void benchmark() {
+  const int all_pairs_limit = 3200;
+  std::printf("%8s %14s %14s\n", "cars", "sweep ms", "all pairs ms");
+  for (int count = 5; count <= 12800; count *= 2) {
+    std::printf("%8d %14.3f", count, time_race(count, true));
+    if (count <= all_pairs_limit) {
+      std::printf(" %14.3f\n", time_race(count, false));
     } else {
-      speed = top_speed;
-    }
-    if (speed < 2.0) {
-      speed = 2.0;
+      std::printf(" %14s\n", "-");
     }
   }
-};
+}
+
+std::vector<sf::Vector2f> waypoint_list() {
+  std::vector<sf::Vector2f> list;
+  for (auto& waypoint : waypoints) {
+    list.emplace_back((float)waypoint[0], (float)waypoint[1]);
+  }
+  return list;
+}
+
+int tournament(unsigned threads) {
+  Track track;
+  if (!track.load("assets/images/course.png", "assets/images/course.track", waypoint_list())) {
+    std::cout << "Cannot load the course image or make a racing line from the waypoints\n";
+    return 1;
+  }
+  /// counted in whole steps, as adding 0.002f over and over drifts past the last gain and drops it
+  std::vector<float> top_speeds;
+  for (int i = 0; i <= 16; i++) {
+    top_speeds.push_back(4 + 0.5f * float(i));  // 4 to 12
+  }
+  std::vector<float> steer_gains;
+  for (int i = 0; i <= 13; i++) {
+    steer_gains.push_back(0.004f + 0.002f * float(i));  // 0.004 to 0.030
+  }
+  std::vector<int> lookaheads = {2, 4, 6, 8, 10, 12, 14, 16};
+  std::vector<CarConfig> configs = Tournament::grid(top_speeds, steer_gains, lookaheads);
+
+  Tournament tournament;
+  auto start = std::chrono::steady_clock::now();
+  std::vector<LapResult> results = tournament.run(track, configs, threads);
+  auto end = std::chrono::steady_clock::now();
+  double seconds = std::chrono::duration<double>(end - start).count();
+
+  tournament.sort_by_time(results);
+  tournament.write_csv("tournament.csv", results);
+  std::printf("%zu cars, %d laps each, in %.2f s using %u threads\n", configs.size(), tournament.laps, seconds,
+              threads ? threads : std::max(1u, std::thread::hardware_concurrency()));
+  std::printf("%10s %10s %10s %10s %10s\n", "top speed", "gain", "lookahead", "best lap", "total");
+  for (size_t i = 0; i < std::min<size_t>(10, results.size()); i++) {
+    const LapResult& r = results[i];
+    std::printf("%10.1f %10.3f %10d %10.2f %10.2f\n", r.config.top_speed, r.config.steer_gain, r.config.lookahead, r.best_lap, r.total_time);
+  }
+  size_t finished = std::count_if(results.begin(), results.end(), [&](const LapResult& r) { return r.finished(tournament.laps); });
+  std::printf("%zu of %zu finished. All the results are in tournament.csv\n", finished, results.size());
+  return 0;
+}
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 void updateView(sf::RenderWindow& window, sf::Texture& bg_texture, float zoom_factor = 1.0) {
@@ -93,7 +158,19 @@ void updateView(sf::RenderWindow& window, sf::Texture& bg_texture, float zoom_fa
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-int main() {
+int main(int argc, char** argv) {
+  int car_count = 5;
+  for (int i = 1; i < argc; i++) {
+    if (std::strcmp(argv[i], "--bench") == 0) {
+      benchmark();
+      return 0;
+    }
+    if (std::strcmp(argv[i], "--tournament") == 0) {
+      return tournament(i + 1 < argc ? (unsigned)std::atoi(argv[i + 1]) : 0);
+    }
+    car_count = std::max(1, std::atoi(argv[i]));
+  }
+
   /// Any antialiasing has to be set globally when creating the window:
   sf::ContextSettings settings;
   settings.antialiasingLevel = 8;  // the number of multisamplings to use. 4 is probably fine
@@ -123,26 +200,38 @@ int main() {
   waypoint_marker.setFillColor(sf::Color::Green);
   centre.setPosition((float)texture_size.x / 2, (float)texture_size.y / 2);
 
-  sf::Texture car_texture;
-  car_texture.loadFromFile("assets/images/car.png");
-  car_texture.setSmooth(true);
-
-  sf::Sprite sCar(car_texture);
-  sCar.setOrigin(22, 22);
-  float R = 22;
-  const int car_count = 5;
-  Vehicle car[car_count];
-  for (int i = 0; i < car_count; i++) {
-    car[i].x = 150;  //+ i * 50;
-    car[i].y = 1200 - i * 10;
-    car[i].top_speed = 4 + i;
+  /// the car comes from an atlas so that any other sprites can be added to it and still go in the same batch
+  TextureAtlas atlas;
+  if (!atlas.add_file("car", "assets/images/car.png") || !atlas.pack()) {
+    std::cerr << "Unable to load the car\n";
+    return 1;
   }
+  atlas.texture().setSmooth(true);  // the atlas pads each image, so smoothing does not bleed in from the neighbours
+
+  /// with hundreds of cars, drawing them all in one batch saves a draw call for each one
+  SpriteBatch car_batch(&atlas.texture());
+  const sf::IntRect car_rect = atlas.rect("car");
+  std::vector<Vehicle> car;
+  place_cars(car, car_count);
+  CarCollisions collisions;
 
   Vehicle mini;
   mini.m_position = PVector(150, 1300);
   mini.m_velocity = PVector(0, 0);
   mini.m_acceleration = PVector(20, -200);
 
+  Track track;
+  bool follow_line = track.load("assets/images/course.png", "assets/images/course.track", waypoint_list());
+  /// the racing line coloured from red for slow to blue for fast
+  sf::VertexArray racing_line(sf::LineStrip);
+  for (const LinePoint& p : track.racing_line()) {
+    auto blue = (sf::Uint8)std::clamp(255.0f * (p.speed - 2.0f) / 8.0f, 0.0f, 255.0f);
+    racing_line.append(sf::Vertex(sf::Vector2f(p.x, p.y), sf::Color(255 - blue, 0, blue)));
+  }
+  if (racing_line.getVertexCount() > 0) {
+    racing_line.append(racing_line[0]);
+  }
+
   sf::Color Colors[10] = {sf::Color::Red, sf::Color::Green, sf::Color::Magenta, sf::Color::Blue, sf::Color::White};
 
   sf::Clock deltaClock{};  /// Keeps track of elapsed time
@@ -165,6 +254,8 @@ int main() {
           zoom_factor /= 1.1f;
         }
         updateView(window, bg_texture, zoom_factor);
+      } else if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::L) {
+        follow_line = !follow_line && !track.empty();
       } else if (event.type == sf::Event::MouseButtonPressed) {
         if (event.mouseButton.button == sf::Mouse::Right) {
           zoom_factor = 1.0;
@@ -185,26 +276,7 @@ int main() {
     //
     ////////////////////////////////////////////////////////////////////////////////////////////////
 
-    for (int i = 0; i < car_count; i++) {
-      car[i].move();
-      car[i].findTarget();
-    }
-
-    // collision
-    for (int i = 0; i < car_count; i++)
-      for (int j = 0; j < car_count; j++) {
-        int dx = 0, dy = 0;
-        while (dx * dx + dy * dy < 4 * R * R) {
-          car[i].x += dx / 10.0;
-          car[i].x += dy / 10.0;
-          car[j].x -= dx / 10.0;
-          car[j].y -= dy / 10.0;
-          dx = car[i].x - car[j].x;
-          dy = car[i].y - car[j].y;
-          if (!dx && !dy)
-            break;
-        }
-      }
+    step_race(car, collisions, true, follow_line ? &track : nullptr);
 
     sf::CircleShape blob(20);
     blob.setOrigin(10, 10);
@@ -214,15 +286,15 @@ int main() {
     window.clear();
     //    sBackground.setPosition(-offsetX, -offsetY);
     window.draw(sBackground);
+    if (follow_line) {
+      window.draw(racing_line);
+    }
 
-    int offsetX = 0;
-    int offsetY = 0;
+    car_batch.clear();
     for (int i = 0; i < car_count; i++) {
-      sCar.setPosition(car[i].x - offsetX, car[i].y - offsetY);
-      sCar.setRotation(car[i].theta * 180 / 3.141593);
-      sCar.setColor(Colors[i]);
-      window.draw(sCar);
+      car_batch.add(car_rect, {car[i].x, car[i].y}, {22, 22}, trig::degrees(car[i].theta), {1, 1}, Colors[i % 5]);
     }
+    window.draw(car_batch);
     PVector force(10, 0);
     //    force.rotate_to(mini.m_velocity.angle() + M_PI / 2);
     mini.apply_force(force);
@@ -0,0 +1,172 @@
+#ifndef IMGUI_SFML_STARTER_TOURNAMENT_H
+#define IMGUI_SFML_STARTER_TOURNAMENT_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <thread>
+#include <vector>
+#include "car.h"
+#include "track.h"
+
+/***
+ * Races a large number of differently tuned cars, without a window, to find out which
+ * settings give the fastest laps.
+ *
+ * Each car runs a time trial on its own, starting from the grid with a fixed
+ * number of frames per second. No car affects any other, so the cars can be shared out between
+ * threads however we like and every run gives exactly the same lap times. The
+ * threads take small batches of cars from a shared counter, so a thread that gets
+ * quick cars comes back for more while the others are still busy.
+ *
+ * Laps are counted by the car's progress along the racing line. A lap is done
+ * when the car has moved forward by the whole length of the line since the
+ * start. A car that has not finished in max_frames is marked as not finished.
+ */
+
+struct CarConfig {
+  float top_speed = 6;
+  float steer_gain = 0.010f;
+  int lookahead = 6;
+};
+
+struct LapResult {
+  CarConfig config;
+  int laps = 0;              // laps completed
+  float best_lap = 0;        // seconds
+  float total_time = 0;      // seconds to complete all the laps
+  int off_track_frames = 0;  // how long the car spent on the grass
+  int progress = 0;          // racing line points travelled by the end, for ordering the cars that did not finish
+  [[nodiscard]] bool finished(int lap_count) const { return laps >= lap_count; }
+};
+
+class Tournament {
+ public:
+  static constexpr float FRAME_RATE = 60.0f;  // the cars move a fixed distance each frame
+
+  int laps = 3;
+  int max_frames = 60 * 60 * 5;  // five minutes
+  float start_x = 150;
+  float start_y = 1200;
+
+  /// every combination of the given settings
+  static std::vector<CarConfig> grid(const std::vector<float>& top_speeds, const std::vector<float>& steer_gains, const std::vector<int>& lookaheads) {
+    std::vector<CarConfig> configs;
+    for (float speed : top_speeds) {
+      for (float gain : steer_gains) {
+        for (int lookahead : lookaheads) {
+          configs.push_back({speed, gain, lookahead});
+        }
+      }
+    }
+    return configs;
+  }
+
+  /// run every car. threads = 0 uses all the cores
+  std::vector<LapResult> run(const Track& track, const std::vector<CarConfig>& configs, unsigned threads = 0) const {
+    std::vector<LapResult> results(configs.size());
+    if (threads == 0) {
+      threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    const size_t batch = 8;
+    std::atomic<size_t> next{0};
+    auto worker = [&]() {
+      while (true) {
+        size_t first = next.fetch_add(batch);
+        if (first >= configs.size()) {
+          return;
+        }
+        size_t last = std::min(first + batch, configs.size());
+        for (size_t i = first; i < last; i++) {
+          results[i] = race(track, configs[i]);
+        }
+      }
+    };
+    std::vector<std::thread> pool;
+    for (unsigned t = 1; t < threads; t++) {
+      pool.emplace_back(worker);
+    }
+    worker();
+    for (auto& thread : pool) {
+      thread.join();
+    }
+    return results;
+  }
+
+  /// one time trial
+  [[nodiscard]] LapResult race(const Track& track, const CarConfig& config) const {
+    LapResult result;
+    result.config = config;
+    const int line_length = (int)track.racing_line().size();
+    if (line_length == 0) {
+      return result;
+    }
+    Vehicle car;
+    car.x = start_x;
+    car.y = start_y;
+    car.top_speed = config.top_speed;
+    car.steer_gain = config.steer_gain;
+    car.lookahead = config.lookahead;
+    uint16_t start = track.line_index(car.x, car.y);
+    car.line_index = start == Track::NO_LINE ? 0 : start;
+
+    int last_index = car.line_index;
+    int progress = 0;  // line points travelled, counting backwards as negative
+    int lap_start_frame = 0;
+    for (int frame = 1; frame <= max_frames && result.laps < laps; frame++) {
+      car.move();
+      car.followLine(track);
+      if (!track.on_track(car.x, car.y)) {
+        result.off_track_frames++;
+      }
+      /// the index wraps round at the start of the line
+      int step = car.line_index - last_index;
+      if (step < -line_length / 2) {
+        step += line_length;
+      } else if (step > line_length / 2) {
+        step -= line_length;
+      }
+      progress += step;
+      last_index = car.line_index;
+      if (progress >= (result.laps + 1) * line_length) {
+        float lap_time = float(frame - lap_start_frame) / FRAME_RATE;
+        result.best_lap = result.laps == 0 ? lap_time : std::min(result.best_lap, lap_time);
+        result.laps++;
+        result.total_time = float(frame) / FRAME_RATE;
+        lap_start_frame = frame;
+      }
+    }
+    result.progress = progress;
+    return result;
+  }
+
+  /// a table of lap times, best first, as comma separated values
+  void write_csv(const char* path, std::vector<LapResult> results) const {
+    sort_by_time(results);
+    FILE* file = std::fopen(path, "w");
+    if (!file) {
+      return;
+    }
+    std::fprintf(file, "top_speed,steer_gain,lookahead,laps,best_lap,total_time,off_track_frames\n");
+    for (const auto& r : results) {
+      std::fprintf(file, "%.2f,%.4f,%d,%d,%.3f,%.3f,%d\n", r.config.top_speed, r.config.steer_gain, r.config.lookahead, r.laps, r.best_lap, r.total_time,
+                   r.off_track_frames);
+    }
+    std::fclose(file);
+  }
+
+  /// finishers first, fastest first, then the rest by how far they got
+  void sort_by_time(std::vector<LapResult>& results) const {
+    std::stable_sort(results.begin(), results.end(), [this](const LapResult& a, const LapResult& b) {
+      if (a.finished(laps) != b.finished(laps)) {
+        return a.finished(laps);
+      }
+      if (!a.finished(laps)) {
+        return a.progress > b.progress;
+      }
+      return a.total_time < b.total_time;
+    });
+  }
+};
+
+#endif  // IMGUI_SFML_STARTER_TOURNAMENT_H
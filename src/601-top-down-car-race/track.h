@@ -0,0 +1,465 @@
+#ifndef IMGUI_SFML_STARTER_TRACK_H
+#define IMGUI_SFML_STARTER_TRACK_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <string>
+#include <vector>
+#include "SFML/Graphics.hpp"
+
+/***
+ * Everything the AI cars need to know about the course, worked out once from
+ * the course image and then looked up in constant time while racing.
+ *
+ * The image is reduced to a grid of cells, CELL_SIZE pixels square. Grey cells
+ * are track and everything else is not. From that grid we make:
+ *
+ *   signed distance field - for every cell, the distance to the edge of the track.
+ *                           Negative on the track and positive off it, so one
+ *                           lookup says whether a car is on the track and by how much.
+ *   racing line           - a closed loop of points through the waypoints. It starts out
+ *                           as straight lines between them and is then relaxed
+ *                           repeatedly. Each point moves towards the middle of its
+ *                           neighbours, which straightens the line and cuts the corners,
+ *                           and is pushed back onto the track wherever it strays
+ *                           within a margin of the edge.
+ *   speed profile         - the fastest speed at each point of the line. The curvature
+ *                           sets a cornering speed, v = sqrt(a / curvature). Passes
+ *                           backwards and forwards round the loop then make sure a car
+ *                           can brake in time for each corner and accelerate out of it.
+ *   nearest line point    - for every cell near the track, the index of the closest point
+ *                           on the racing line. A car can find its place on the line, and
+ *                           so its target speed, without searching.
+ *
+ * Building all that takes a moment so the result is saved to a cache file. The
+ * file holds a checksum of the image and the build settings so that a
+ * change to either makes a fresh build.
+ *
+ * Speeds are in pixels per frame, the same units that the cars use.
+ */
+
+struct TrackSettings {
+  float line_spacing = 8.0f;   // distance between racing line points in pixels
+  float edge_margin = 30.0f;   // how close the line may come to the edge of the track
+  int relax_iterations = 400;  // more makes a smoother line
+  float lateral_accel = 0.25f; // cornering grip, in pixels per frame per frame
+  float brake_accel = 0.08f;
+  float drive_accel = 0.03f;
+  float max_speed = 20.0f;     // speed on the straights. The cars have their own limits
+  float search_range = 120.0f; // the nearest line point is stored for cells this far off the track
+};
+
+struct LinePoint {
+  float x;
+  float y;
+  float curvature;
+  float speed;
+};
+
+class Track {
+ public:
+  static constexpr int CELL_SIZE = 4;
+  static constexpr float SDF_SCALE = 4.0f;  // the distances are stored as quarter pixels
+  static constexpr uint16_t NO_LINE = 0xFFFF;
+
+  /// true until there is both a track and a racing line to follow
+  [[nodiscard]] bool empty() const { return m_sdf.empty() || m_line.empty(); }
+  [[nodiscard]] int width() const { return m_width; }
+  [[nodiscard]] int height() const { return m_height; }
+  [[nodiscard]] const std::vector<LinePoint>& racing_line() const { return m_line; }
+
+  /// distance from the edge of the track in pixels. Negative means on the track
+  [[nodiscard]] float distance(float x, float y) const {
+    int cx = std::clamp(int(x) / CELL_SIZE, 0, m_width - 1);
+    int cy = std::clamp(int(y) / CELL_SIZE, 0, m_height - 1);
+    return float(m_sdf[cy * m_width + cx]) / SDF_SCALE;
+  }
+
+  [[nodiscard]] bool on_track(float x, float y) const { return distance(x, y) <= 0.0f; }
+
+  /// index of the nearest racing line point, or NO_LINE if the position is too far from the track
+  [[nodiscard]] uint16_t line_index(float x, float y) const {
+    int cx = std::clamp(int(x) / CELL_SIZE, 0, m_width - 1);
+    int cy = std::clamp(int(y) / CELL_SIZE, 0, m_height - 1);
+    return m_line_index[cy * m_width + cx];
+  }
+
+  [[nodiscard]] const LinePoint& line_point(size_t i) const { return m_line[i % m_line.size()]; }
+
+  /***
+   * Reads the cache if it matches the image, otherwise builds everything from
+   * the image and writes a new cache. Returns false if the image cannot be loaded
+   * or there is no racing line, which needs at least three waypoints.
+   */
+  bool load(const std::string& image_path, const std::string& cache_path, const std::vector<sf::Vector2f>& waypoints,
+            const TrackSettings& settings = TrackSettings()) {
+    sf::Image image;
+    if (!image.loadFromFile(image_path)) {
+      return false;
+    }
+    sf::Vector2u size = image.getSize();
+    const uint8_t* pixels = image.getPixelsPtr();
+    uint64_t key = checksum(pixels, size_t(size.x) * size.y * 4, waypoints, settings);
+    if (read_cache(cache_path, key)) {
+      return !empty();
+    }
+    build(pixels, int(size.x), int(size.y), waypoints, settings);
+    m_key = key;
+    write_cache(cache_path);
+    return !empty();
+  }
+
+  /// build from an RGBA image. Waypoints must be in the order they are driven
+  void build(const uint8_t* rgba, int image_width, int image_height, const std::vector<sf::Vector2f>& waypoints,
+             const TrackSettings& settings = TrackSettings()) {
+    m_settings = settings;
+    m_width = image_width / CELL_SIZE;
+    m_height = image_height / CELL_SIZE;
+    std::vector<uint8_t> mask(size_t(m_width) * m_height);
+    for (int cy = 0; cy < m_height; cy++) {
+      for (int cx = 0; cx < m_width; cx++) {
+        const uint8_t* p = rgba + 4 * ((size_t(cy) * CELL_SIZE + CELL_SIZE / 2) * image_width + cx * CELL_SIZE + CELL_SIZE / 2);
+        mask[cy * m_width + cx] = is_track_colour(p[0], p[1], p[2]);
+      }
+    }
+    build_sdf(mask);
+    build_line(waypoints);
+    build_speeds();
+    build_line_index();
+  }
+
+  bool write_cache(const std::string& path) const {
+    std::ofstream file(path, std::ios::binary);
+    if (!file) {
+      return false;
+    }
+    uint32_t header[4] = {MAGIC, uint32_t(m_width), uint32_t(m_height), uint32_t(m_line.size())};
+    file.write(reinterpret_cast<const char*>(header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(&m_key), sizeof(m_key));
+    file.write(reinterpret_cast<const char*>(m_sdf.data()), std::streamsize(m_sdf.size() * sizeof(int16_t)));
+    file.write(reinterpret_cast<const char*>(m_line_index.data()), std::streamsize(m_line_index.size() * sizeof(uint16_t)));
+    file.write(reinterpret_cast<const char*>(m_line.data()), std::streamsize(m_line.size() * sizeof(LinePoint)));
+    return bool(file);
+  }
+
+  bool read_cache(const std::string& path, uint64_t expected_key) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+      return false;
+    }
+    uint32_t header[4] = {};
+    uint64_t key = 0;
+    file.read(reinterpret_cast<char*>(header), sizeof(header));
+    file.read(reinterpret_cast<char*>(&key), sizeof(key));
+    if (!file || header[0] != MAGIC || key != expected_key || header[3] >= NO_LINE) {
+      return false;
+    }
+    int w = int(header[1]);
+    int h = int(header[2]);
+    std::vector<int16_t> sdf(size_t(w) * h);
+    std::vector<uint16_t> index(size_t(w) * h);
+    std::vector<LinePoint> line(header[3]);
+    file.read(reinterpret_cast<char*>(sdf.data()), std::streamsize(sdf.size() * sizeof(int16_t)));
+    file.read(reinterpret_cast<char*>(index.data()), std::streamsize(index.size() * sizeof(uint16_t)));
+    file.read(reinterpret_cast<char*>(line.data()), std::streamsize(line.size() * sizeof(LinePoint)));
+    if (!file) {
+      return false;
+    }
+    m_width = w;
+    m_height = h;
+    m_sdf = std::move(sdf);
+    m_line_index = std::move(index);
+    m_line = std::move(line);
+    m_key = key;
+    return true;
+  }
+
+ private:
+  static constexpr uint32_t MAGIC = 0x314B5254;  // "TRK1"
+
+  /// the tarmac is a mid grey. The grass is green and the border red
+  static bool is_track_colour(uint8_t r, uint8_t g, uint8_t b) {
+    return std::abs(int(r) - int(g)) < 24 && std::abs(int(g) - int(b)) < 24 && r > 40 && r < 200;
+  }
+
+  /// FNV-1a over the image, the waypoints and the settings
+  static uint64_t checksum(const uint8_t* data, size_t size, const std::vector<sf::Vector2f>& waypoints, const TrackSettings& settings) {
+    uint64_t h = 0xCBF29CE484222325ull;
+    auto add = [&h](const void* p, size_t n) {
+      const auto* bytes = static_cast<const uint8_t*>(p);
+      for (size_t i = 0; i < n; i++) {
+        h = (h ^ bytes[i]) * 0x100000001B3ull;
+      }
+    };
+    add(data, size);
+    for (const auto& w : waypoints) {
+      add(&w.x, sizeof(float));
+      add(&w.y, sizeof(float));
+    }
+    add(&settings, sizeof(settings));
+    int version[2] = {CELL_SIZE, int(sizeof(LinePoint))};
+    add(version, sizeof(version));
+    return h;
+  }
+
+  /***
+   * Felzenszwalb and Huttenlocher's exact distance transform along one row or
+   * column. f holds 0 at the cells we want the distance to and a large number
+   * everywhere else. d gets the squared distance to the nearest of them.
+   */
+  static void distance_1d(const float* f, float* d, int n, std::vector<int>& v, std::vector<float>& z) {
+    v.resize(n);
+    z.resize(n + 1);
+    int k = 0;
+    v[0] = 0;
+    z[0] = -std::numeric_limits<float>::infinity();
+    z[1] = std::numeric_limits<float>::infinity();
+    auto intersection = [&](int q, int p) { return ((f[q] + float(q * q)) - (f[p] + float(p * p))) / float(2 * q - 2 * p); };
+    for (int q = 1; q < n; q++) {
+      float s = intersection(q, v[k]);
+      while (s <= z[k]) {
+        k--;
+        s = intersection(q, v[k]);
+      }
+      k++;
+      v[k] = q;
+      z[k] = s;
+      z[k + 1] = std::numeric_limits<float>::infinity();
+    }
+    k = 0;
+    for (int q = 0; q < n; q++) {
+      while (z[k + 1] < float(q)) {
+        k++;
+      }
+      float dq = float(q - v[k]);
+      d[q] = dq * dq + f[v[k]];
+    }
+  }
+
+  /// squared distance, in cells, from every cell to the nearest cell where target is true
+  std::vector<float> distance_squared(const std::vector<uint8_t>& mask, uint8_t target) const {
+    const float far = 1e12f;
+    std::vector<float> grid(mask.size());
+    for (size_t i = 0; i < mask.size(); i++) {
+      grid[i] = mask[i] == target ? 0.0f : far;
+    }
+    int longest = std::max(m_width, m_height);
+    std::vector<float> f(longest), d(longest), z;
+    std::vector<int> v;
+    for (int x = 0; x < m_width; x++) {
+      for (int y = 0; y < m_height; y++) {
+        f[y] = grid[y * m_width + x];
+      }
+      distance_1d(f.data(), d.data(), m_height, v, z);
+      for (int y = 0; y < m_height; y++) {
+        grid[y * m_width + x] = d[y];
+      }
+    }
+    for (int y = 0; y < m_height; y++) {
+      std::copy_n(&grid[y * m_width], m_width, f.data());
+      distance_1d(f.data(), d.data(), m_width, v, z);
+      std::copy_n(d.data(), m_width, &grid[y * m_width]);
+    }
+    return grid;
+  }
+
+  void build_sdf(const std::vector<uint8_t>& mask) {
+    std::vector<float> to_track = distance_squared(mask, 1);
+    std::vector<float> to_grass = distance_squared(mask, 0);
+    m_sdf.resize(mask.size());
+    const float limit = float(std::numeric_limits<int16_t>::max()) / SDF_SCALE;
+    for (size_t i = 0; i < mask.size(); i++) {
+      /// the edge is half a cell from the centre of the nearest cell on the other side
+      float d = mask[i] ? -(std::sqrt(to_grass[i]) - 0.5f) : std::sqrt(to_track[i]) - 0.5f;
+      d = std::clamp(d * CELL_SIZE, -limit, limit);
+      m_sdf[i] = int16_t(std::lround(d * SDF_SCALE));
+    }
+  }
+
+  /// the distance field is only stored at cell centres so interpolate to get a smooth slope
+  float smooth_distance(float x, float y) const {
+    float gx = std::clamp(x / CELL_SIZE - 0.5f, 0.0f, float(m_width - 2));
+    float gy = std::clamp(y / CELL_SIZE - 0.5f, 0.0f, float(m_height - 2));
+    int x0 = int(gx);
+    int y0 = int(gy);
+    float fx = gx - float(x0);
+    float fy = gy - float(y0);
+    const int16_t* row0 = &m_sdf[y0 * m_width + x0];
+    const int16_t* row1 = row0 + m_width;
+    float top = float(row0[0]) + fx * float(row0[1] - row0[0]);
+    float bottom = float(row1[0]) + fx * float(row1[1] - row1[0]);
+    return (top + fy * (bottom - top)) / SDF_SCALE;
+  }
+
+  /// slide a point down the distance field until it is at least the margin inside the edge
+  void keep_on_track(LinePoint& p) const {
+    const float target = -m_settings.edge_margin;
+    const float h = CELL_SIZE;
+    for (int i = 0; i < 32; i++) {
+      float d = smooth_distance(p.x, p.y);
+      if (d <= target) {
+        return;
+      }
+      float gx = smooth_distance(p.x + h, p.y) - smooth_distance(p.x - h, p.y);
+      float gy = smooth_distance(p.x, p.y + h) - smooth_distance(p.x, p.y - h);
+      float g = std::sqrt(gx * gx + gy * gy);
+      if (g < 1e-6f) {
+        return;
+      }
+      float step = std::max(d - target, 0.5f);
+      p.x -= gx / g * step;
+      p.y -= gy / g * step;
+    }
+  }
+
+  /// spread the points out evenly along the loop again
+  void resample(std::vector<LinePoint>& line, float spacing) const {
+    const size_t n = line.size();
+    float length = 0;
+    for (size_t i = 0; i < n; i++) {
+      const LinePoint& a = line[i];
+      const LinePoint& b = line[(i + 1) % n];
+      length += std::hypot(b.x - a.x, b.y - a.y);
+    }
+    const size_t count = std::max<size_t>(3, size_t(length / spacing));
+    const float step = length / float(count);
+    std::vector<LinePoint> out;
+    out.reserve(count);
+    float along = 0;  // distance along the current segment
+    size_t seg = 0;
+    float seg_len = std::hypot(line[1 % n].x - line[0].x, line[1 % n].y - line[0].y);
+    for (size_t k = 0; k < count; k++) {
+      while (along > seg_len && seg < n) {
+        along -= seg_len;
+        seg++;
+        const LinePoint& a = line[seg % n];
+        const LinePoint& b = line[(seg + 1) % n];
+        seg_len = std::hypot(b.x - a.x, b.y - a.y);
+      }
+      const LinePoint& a = line[seg % n];
+      const LinePoint& b = line[(seg + 1) % n];
+      float t = seg_len > 0 ? along / seg_len : 0.0f;
+      out.push_back({a.x + t * (b.x - a.x), a.y + t * (b.y - a.y), 0, 0});
+      along += step;
+    }
+    line.swap(out);
+  }
+
+  void build_line(const std::vector<sf::Vector2f>& waypoints) {
+    std::vector<LinePoint> line;
+    for (const auto& w : waypoints) {
+      line.push_back({w.x, w.y, 0, 0});
+    }
+    if (line.size() < 3) {
+      m_line.clear();
+      return;
+    }
+    resample(line, m_settings.line_spacing);
+    for (auto& p : line) {
+      keep_on_track(p);
+    }
+    const float stiffness = 0.5f;
+    std::vector<LinePoint> next(line.size());
+    for (int iteration = 0; iteration < m_settings.relax_iterations; iteration++) {
+      const size_t n = line.size();
+      next.resize(n);
+      for (size_t i = 0; i < n; i++) {
+        const LinePoint& prev = line[(i + n - 1) % n];
+        const LinePoint& here = line[i];
+        const LinePoint& after = line[(i + 1) % n];
+        next[i] = here;
+        next[i].x += stiffness * (0.5f * (prev.x + after.x) - here.x);
+        next[i].y += stiffness * (0.5f * (prev.y + after.y) - here.y);
+        keep_on_track(next[i]);
+      }
+      line.swap(next);
+      if (iteration % 25 == 24) {
+        resample(line, m_settings.line_spacing);
+      }
+    }
+    resample(line, m_settings.line_spacing);
+    /// the nearest point grid stores indices as 16 bits
+    if (line.size() >= NO_LINE) {
+      resample(line, m_settings.line_spacing * float(line.size()) / float(NO_LINE - 1));
+    }
+    m_line = line;
+  }
+
+  /// the curvature of the circle through three points spread a few points apart
+  void build_speeds() {
+    const size_t n = m_line.size();
+    if (n < 3) {
+      return;
+    }
+    const size_t reach = 5;
+    for (size_t i = 0; i < n; i++) {
+      const LinePoint& a = m_line[(i + n - reach) % n];
+      const LinePoint& b = m_line[i];
+      const LinePoint& c = m_line[(i + reach) % n];
+      float ab = std::hypot(b.x - a.x, b.y - a.y);
+      float bc = std::hypot(c.x - b.x, c.y - b.y);
+      float ca = std::hypot(a.x - c.x, a.y - c.y);
+      float cross = (b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x);
+      float denominator = ab * bc * ca;
+      m_line[i].curvature = denominator > 1e-6f ? 2.0f * std::abs(cross) / denominator : 0.0f;
+    }
+    for (auto& p : m_line) {
+      p.speed = std::min(m_settings.max_speed, std::sqrt(m_settings.lateral_accel / std::max(p.curvature, 1e-6f)));
+    }
+    /// twice round the loop in each direction so that the limits carry over the start line
+    for (size_t k = 2 * n; k > 0; k--) {
+      LinePoint& here = m_line[(k - 1) % n];
+      const LinePoint& after = m_line[k % n];
+      float ds = std::hypot(after.x - here.x, after.y - here.y);
+      here.speed = std::min(here.speed, std::sqrt(after.speed * after.speed + 2 * m_settings.brake_accel * ds));
+    }
+    for (size_t k = 1; k <= 2 * n; k++) {
+      const LinePoint& before = m_line[(k - 1) % n];
+      LinePoint& here = m_line[k % n];
+      float ds = std::hypot(here.x - before.x, here.y - before.y);
+      here.speed = std::min(here.speed, std::sqrt(before.speed * before.speed + 2 * m_settings.drive_accel * ds));
+    }
+  }
+
+  void build_line_index() {
+    m_line_index.assign(size_t(m_width) * m_height, NO_LINE);
+    if (m_line.empty()) {
+      return;
+    }
+    const float range = m_settings.search_range * SDF_SCALE;
+    for (int cy = 0; cy < m_height; cy++) {
+      for (int cx = 0; cx < m_width; cx++) {
+        size_t cell = size_t(cy) * m_width + cx;
+        if (float(m_sdf[cell]) > range) {
+          continue;
+        }
+        float x = (float(cx) + 0.5f) * CELL_SIZE;
+        float y = (float(cy) + 0.5f) * CELL_SIZE;
+        float best = std::numeric_limits<float>::max();
+        for (size_t i = 0; i < m_line.size(); i++) {
+          float dx = m_line[i].x - x;
+          float dy = m_line[i].y - y;
+          float d2 = dx * dx + dy * dy;
+          if (d2 < best) {
+            best = d2;
+            m_line_index[cell] = uint16_t(i);
+          }
+        }
+      }
+    }
+  }
+
+  TrackSettings m_settings;
+  int m_width = 0;
+  int m_height = 0;
+  uint64_t m_key = 0;
+  std::vector<int16_t> m_sdf;
+  std::vector<uint16_t> m_line_index;
+  std::vector<LinePoint> m_line;
+};
+
+#endif  // IMGUI_SFML_STARTER_TRACK_H
@@ -4,6 +4,8 @@
 #include <SFML/Window/Event.hpp>
 #include <cmath>
 #include <iostream>
+#include "angle.h"
+#include "idle_loop.h"
 #include "map.h"
 
 /*********************************************************************************************************************/
@@ -114,11 +116,12 @@ int main() {
     return EXIT_FAILURE;
   }
 
-  sf::Clock deltaClock;
+  /// the map only changes when the robot is driven or the mouse moves, so wait for input in between
+  IdleLoop loop(window);
   while (window.isOpen()) {
     /// process all the inputs
     sf::Event event{};
-    while (window.pollEvent(event)) {
+    while (loop.poll_event(event)) {
       switch (event.type) {
         case sf::Event::Closed: {
           window.close();
@@ -157,14 +160,22 @@ int main() {
       if (sf::Keyboard::isKeyPressed(sf::Keyboard::Down)) {
         v = -360;
       }
+      /// a held key only sends the odd repeat event, so keep drawing while the robot is driven
+      for (auto key : {sf::Keyboard::Left, sf::Keyboard::Right, sf::Keyboard::Up, sf::Keyboard::Down}) {
+        if (sf::Keyboard::isKeyPressed(key)) {
+          loop.request_redraw();
+        }
+      }
     }
     char buf[100];
 
-    sf::Time time = deltaClock.restart();
+    /// the frame time less any time spent waiting for input, so the robot does not jump after an idle spell
+    const sf::Time time = loop.elapsed();
     float angle = robot.getRotation();
     float ds = v * time.asSeconds();
-    float dx = std::cos((angle - 90) * 3.14 / 180) * v;
-    float dy = std::sin((angle - 90) * 3.14 / 180) * v;
+    Angle heading = Angle::from_degrees(angle - 90);
+    float dx = heading.cos() * v;
+    float dy = heading.sin() * v;
     if (robot.getPosition().x + dx < 1024 && robot.getPosition().x + dx > 0) {
       // robot.move(sf::Vector2f(dx, dy) * time.asSeconds());
     }
@@ -222,11 +233,11 @@ int main() {
 
     // render UI stuff
     window.setView(main_view);
-    time = deltaClock.restart();
-    std::string txt = "Time: " + std::to_string(time.asMilliseconds()) + "\n";
+    std::string txt = "Time: " + std::to_string(time.asMilliseconds()) + " ms\n";
     txt += "Mouse: " + std::to_string(mousePos.x) + "," + std::to_string(mousePos.y) + "\n";
     txt += "Map: " + std::to_string((int)worldPos.x) + "," + std::to_string((int)worldPos.y) + "\n";
     txt += "Cell: " + std::to_string((int)cellx) + "," + std::to_string((int)celly) + "\n";
+    txt += "Frames skipped: " + std::to_string(loop.frames_skipped()) + "\n";
     sprintf(buf, "Pose: %d,%d,%d", int(robot.getPosition().x), int(robot.getPosition().y), int(robot.getRotation()));
     txt_robot_pose.setString(buf);
     txt_robot_pose.setString(txt);
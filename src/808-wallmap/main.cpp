@@ -4,9 +4,17 @@
 #include <cmath>
 #include <iostream>
 #include <memory>
-
+#include <string>
+#include <string_view>
+
+#ifndef NDEBUG
+#define ALLOC_TRACKER_IMPLEMENTATION  // counting costs time on every allocation, so debug builds only
+#endif
+#include "alloc_tracker.h"
+#include "frame_arena.h"
 #include "map.h"
 #include "maze_constants.h"
+#include "profiler.h"
 #include "robot.h"
 #include "robotview.h"
 #include "util.h"
@@ -117,71 +125,90 @@ int main() {
     return EXIT_FAILURE;
   }
 
+  /// the frame around the maze never changes so make it once
+  sf::RectangleShape frame(sf::Vector2f(map_view_size + 6, map_view_size + 6));
+  frame.setFillColor(DustyRed);
+  frame.setPosition(main_map_view_port_rect.left - 3.0f, main_map_view_port_rect.top - 3.0f);
+
+  /// the HUD text is built in the arena each frame. It is only passed on to SFML when it
+  /// changes because making the sf::String for it allocates
+  FrameArena arena;
+  std::string hud_text;
+  hud_text.reserve(256);
+  uint64_t heap_allocations = 0;
+  uint64_t allocations_before = alloc_tracker::allocations();
+
+  /// each part of the frame is a PROFILE_SCOPE (see profiler.h), and the HUD shows their times from the last frame
+  Profiler& profiler = Profiler::get();
+  auto ms = [&](const char* block) { return double(profiler.block_time(block)) / 1e6; };
+
   sf::Clock deltaClock;
   while (window.isOpen()) {
+    PROFILE_FRAME();
+    arena.reset();
+    heap_allocations = alloc_tracker::allocations() - allocations_before;
+    allocations_before = alloc_tracker::allocations();
     /// process all the inputs
-    sf::Event event{};
-    while (window.pollEvent(event)) {
-      switch (event.type) {
-        case sf::Event::Closed: {
-          window.close();
-          break;
-        }
-        case sf::Event::Resized: {  // seems to be generated when window is created as well
-          /// get the new size of the window
-          visibleArea = sf::FloatRect(0, 0, (float)event.size.width, (float)event.size.height);
-          /// ensure the viewports scale correctly - comment these to scale everything with the window
-          /// TODO: work out how to scale with same aspect ratio.
-          main_map_view.setViewport(calculate_viewport(main_map_view_port_rect, visibleArea));
-          mini_map_view.setViewport(calculate_viewport(mini_map_view_port_rect, visibleArea));
-          main_view = sf::View(visibleArea);  // the viewport is the whole window by default
-          break;
+    {
+      PROFILE_SCOPE("events");
+      sf::Event event{};
+      while (window.pollEvent(event)) {
+        switch (event.type) {
+          case sf::Event::Closed: {
+            window.close();
+            break;
+          }
+          case sf::Event::Resized: {  // seems to be generated when window is created as well
+            /// get the new size of the window
+            visibleArea = sf::FloatRect(0, 0, (float)event.size.width, (float)event.size.height);
+            /// ensure the viewports scale correctly - comment these to scale everything with the window
+            /// TODO: work out how to scale with same aspect ratio.
+            main_map_view.setViewport(calculate_viewport(main_map_view_port_rect, visibleArea));
+            mini_map_view.setViewport(calculate_viewport(mini_map_view_port_rect, visibleArea));
+            main_view = sf::View(visibleArea);  // the viewport is the whole window by default
+            break;
+          }
+          default:
+            break;
         }
-        default:
-          break;
       }
     }
 
-    robot.set_state(0);
-    robot.setSpeed(0);
-    if (window.hasFocus()) {
-      if (sf::Keyboard::isKeyPressed(sf::Keyboard::Right)) {
-        robot.set_state(1);
-        robot.rotate(3);
-      }
-      if (sf::Keyboard::isKeyPressed(sf::Keyboard::Left)) {
-        robot.set_state(2);
-        robot.rotate(-3);
-      }
-      if (sf::Keyboard::isKeyPressed(sf::Keyboard::Up)) {
-        robot.set_state(3);
-        robot.setSpeed(360);
-      }
-      if (sf::Keyboard::isKeyPressed(sf::Keyboard::Down)) {
-        robot.set_state(3 + 4);  // because I can
-        robot.setSpeed(-360);
+    const sf::Time time = deltaClock.restart();
+    {
+      PROFILE_SCOPE("update");
+      robot.set_state(0);
+      robot.setSpeed(0);
+      if (window.hasFocus()) {
+        if (sf::Keyboard::isKeyPressed(sf::Keyboard::Right)) {
+          robot.set_state(1);
+          robot.rotate(3);
+        }
+        if (sf::Keyboard::isKeyPressed(sf::Keyboard::Left)) {
+          robot.set_state(2);
+          robot.rotate(-3);
+        }
+        if (sf::Keyboard::isKeyPressed(sf::Keyboard::Up)) {
+          robot.set_state(3);
+          robot.setSpeed(360);
+        }
+        if (sf::Keyboard::isKeyPressed(sf::Keyboard::Down)) {
+          robot.set_state(3 + 4);  // because I can
+          robot.setSpeed(-360);
+        }
       }
-    }
-
-    sf::Time time = deltaClock.restart();
-
-    // update the objects on screen
-    robot.update(time.asSeconds());
-    robot_view.update();
-    mini_map_view.setCenter(robot_view.getPosition().x, robot_view.getPosition().y);
-    mini_map_view.setCenter(robot_view.getPosition().x, robot_view.getPosition().y);
 
-    char buf[100];
-    txt_robot_pose.setString(buf);
+      // update the objects on screen
+      robot.update(time.asSeconds());
+      robot_view.update();
+      mini_map_view.setCenter(robot_view.getPosition().x, robot_view.getPosition().y);
+    }
 
     /// and redraw the window
     window.clear();
 
     /// draw the frame around the maze
     window.setView(main_view);
-    sf::RectangleShape frame(sf::Vector2f(map_view_size + 6, map_view_size + 6));
-    frame.setFillColor(DustyRed);
-    frame.setPosition(main_map_view_port_rect.left - 3.0f, main_map_view_port_rect.top - 3.0f);
     window.draw(frame);
 
     // render main map into a view
@@ -198,42 +225,62 @@ int main() {
     int cellSize = scale * 180;
     int cellx = worldPos.x / cellSize;
     int celly = 16 - worldPos.y / cellSize;
-    map->clear_colours();
-    map->set_cell_colour(cellx, celly, sf::Color::Green);
-    map->setScale(1, 1);
-    robot_view.setScale(1, 1);
-    renderTexture->clear();
-    renderTexture->draw(*map);
-    renderTexture->draw(robot_view);
-    renderTexture->display();
-    // now the render texture is drawn as a single sprite
     sf::Sprite map_sprite(renderTexture->getTexture());
-    map_sprite.setScale(scale, scale);
-    window.draw(map_sprite);
+    {
+      PROFILE_SCOPE("map");
+      map->clear_colours();
+      map->set_cell_colour(cellx, celly, sf::Color::Green);
+      map->setScale(1, 1);
+      robot_view.setScale(1, 1);
+      renderTexture->clear();
+      renderTexture->draw(*map);
+      renderTexture->draw(robot_view);
+      renderTexture->display();
+      // now the render texture is drawn as a single sprite
+      map_sprite.setScale(scale, scale);
+      window.draw(map_sprite);
+    }
 
     // render minimap
     // mini_map_view.setRotation(robot.getRotation());
     /// Stuff must be drawn on both views. Still do not know why
     /// These may be two separate textures that both need filling
-    window.setView(mini_map_view);
-    map_sprite.setScale(1.0, 1.0);
-    window.draw(map_sprite);
+    {
+      PROFILE_SCOPE("minimap");
+      window.setView(mini_map_view);
+      map_sprite.setScale(1.0, 1.0);
+      window.draw(map_sprite);
+    }
 
-    mini_map_view.setCenter(robot_view.getPosition().x, robot_view.getPosition().y);
     // render UI stuff
-    window.setView(main_view);
-    time = deltaClock.restart();
-    std::string txt = "Time: " + std::to_string(time.asMilliseconds()) + "\n";
-    txt += "Mouse: " + std::to_string(mousePos.x) + "," + std::to_string(mousePos.y) + "\n";
-    txt += "Map: " + std::to_string((int)worldPos.x) + "," + std::to_string((int)worldPos.y) + "\n";
-    txt += "Cell: " + std::to_string((int)cellx) + "," + std::to_string((int)celly) + "\n";
-    sprintf(buf, "Pose: %d,%d,%d", int(robot_view.getPosition().x), int(robot_view.getPosition().y), int(robot_view.getRotation()));
-    txt_robot_pose.setString(buf);
-    txt_robot_pose.setString(txt);
-    txt_robot_pose.setPosition(mini_map_view_port_rect.left, mini_map_view_port_rect.top - txt_robot_pose.getLocalBounds().height);
-    window.draw(txt_robot_pose);
-
-    window.display();
+    {
+      PROFILE_SCOPE("hud");
+      window.setView(main_view);
+      std::pmr::string txt = arena.string();
+      txt.reserve(256);
+      appendf(txt, "Time: %d ms\n", (int)time.asMilliseconds());
+      appendf(txt, "  events %.2f update %.2f\n", ms("events"), ms("update"));
+      appendf(txt, "  map %.2f minimap %.2f\n", ms("map"), ms("minimap"));
+      appendf(txt, "  hud %.2f display %.2f\n", ms("hud"), ms("display"));
+      appendf(txt, "Mouse: %d,%d\n", mousePos.x, mousePos.y);
+      appendf(txt, "Map: %d,%d\n", (int)worldPos.x, (int)worldPos.y);
+      appendf(txt, "Cell: %d,%d\n", cellx, celly);
+      appendf(txt, "Pose: %d,%d,%d\n", int(robot_view.getPosition().x), int(robot_view.getPosition().y), int(robot_view.getRotation()));
+      if (alloc_tracker::installed()) {
+        appendf(txt, "Heap: %llu allocations\n", (unsigned long long)heap_allocations);
+      }
+      if (std::string_view(hud_text) != std::string_view(txt)) {
+        hud_text.assign(txt.data(), txt.size());
+        txt_robot_pose.setString(hud_text);
+      }
+      txt_robot_pose.setPosition(mini_map_view_port_rect.left, mini_map_view_port_rect.top - txt_robot_pose.getLocalBounds().height);
+      window.draw(txt_robot_pose);
+    }
+
+    {
+      PROFILE_SCOPE("display");
+      window.display();
+    }
   }
 
   return 0;
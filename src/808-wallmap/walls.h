@@ -4,6 +4,8 @@
 
 #pragma once
 
+#include <cstdint>
+#include "fixed_point.h"
 #include "maze_constants.h"
 // free functions for manipulating wall data
 
@@ -135,11 +137,17 @@ inline void center_number(char *str, int width, uint16_t num) {
  *
  * bool m_is_exit : 1;
  * bool m_is_queued : 1
+ *
+ * Cost is the type of the flood cost. The firmware floods with whole numbers of
+ * cells in a uint16_t. A weighted flood, where turns and diagonals cost more than
+ * straights, can use Q16_16 to get the same costs as fixed point firmware, or float
+ * to try ideas out. Unreached walls have the largest cost the type can hold.
  */
 
-class WallData {
+template <typename Cost = uint16_t>
+class BasicWallData {
  public:
-  WallData() { reset(); };
+  BasicWallData() { reset(); };
   //  WallData(int x, int y, Direction wall_direction) { reset(); }
 
   void reset() {
@@ -150,7 +158,7 @@ class WallData {
     m_direction = DIR_NONE;
     m_is_on_path = false;
     m_predecessor = 0;  // the wall we came from to get here
-    m_cost = UINT16_MAX;
+    m_cost = Numeric<Cost>::max();
   }
 
   bool is_active() { return m_is_active; }
@@ -173,9 +181,9 @@ class WallData {
 
   void set_direction(Direction dir) { m_direction = dir; }
 
-  uint16_t cost() { return m_cost; }
+  Cost cost() { return m_cost; }
 
-  void set_cost(uint16_t cost) { m_cost = cost; }
+  void set_cost(Cost cost) { m_cost = cost; }
 
   int predecessor() { return m_predecessor; }
 
@@ -188,6 +196,8 @@ class WallData {
   bool m_is_on_path = false;
   uint16_t m_predecessor = 0;        // the wall we came from to get here
   Direction m_direction = DIR_NONE;  // The direction we are passing through this wall
-  uint16_t m_cost = UINT16_MAX;
+  Cost m_cost = Numeric<Cost>::max();
   WallState m_state = UNKNOWN;
 };
+
+using WallData = BasicWallData<>;